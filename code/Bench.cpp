@@ -0,0 +1,460 @@
+/*
+Bench.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Entry point for the benchmark suite, built as its own executable.  Times the
+card, hand and deck hot paths and full headless rounds of every variant,
+writes the results as JSON, and optionally compares them with a baseline
+file from an earlier run.
+
+Usage: Bench [--out file] [--baseline file] [--tolerance fraction]
+             [--filter substring] [--reps n] [--scenario file]
+
+--scenario file also times headless rounds dealt from a scenario file (see
+Scenario.h and MakeScenario), starting it over whenever it runs out, for
+every variant that can deal it.  These are named with "/scenario" on the
+end, so that they are only compared with other scenario runs.
+
+Exits with 1 if any benchmark is slower than the baseline by more than the
+tolerance (default 0.10, i.e. 10%).
+*/
+
+#include "stdafx.h"
+#include "Card.h"
+#include "Hand.h"
+#include "Deck.h"
+#include "Game.h"
+#include "Rules.h"
+#include "Strategy.h"
+#include "Simulation.h"
+#include "Profiler.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+
+struct BenchResult
+{
+	string name;
+	unsigned long long iterations;
+	double nsPerOp;
+};
+
+/*
+Runs a benchmark body and records the best of several repetitions.
+body(n) must perform n operations and return something that depends on
+them, so the compiler cannot skip the work.
+*/
+class BenchRunner
+{
+public:
+	BenchRunner(const string & filter, int reps) : filter(filter), reps(reps), sink(0) {}
+
+	template <class Body>
+	void run(const string & name, unsigned long long iterations, Body body)
+	{
+		if (!filter.empty() && name.find(filter) == string::npos)
+			return;
+
+		sink += body(iterations / 10 + 1); // Warm up
+
+		double best = 0;
+		for (int rep = 0; rep < reps; rep++)
+		{
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			sink += body(iterations);
+			chrono::steady_clock::time_point stop = chrono::steady_clock::now();
+
+			double ns = (double)chrono::duration_cast<chrono::nanoseconds>(stop - start).count() / iterations;
+			if (rep == 0 || ns < best)
+				best = ns;
+		}
+
+		BenchResult result = {name, iterations, best};
+		results.push_back(result);
+		cout << name << ": " << best << " ns/op" << endl;
+	}
+
+	const vector<BenchResult> & getResults() const { return results; }
+	unsigned long long getSink() const { return sink; }
+
+private:
+	string filter;
+	int reps;
+	unsigned long long sink;
+	vector<BenchResult> results;
+};
+
+/*
+One hand of each poker rank, indexed by pokerRank.
+*/
+const char * const SAMPLE_HANDS[STR_RANKS_COUNT] = {
+	"2c 5d 9h Js Kc",   // High card
+	"4c 4d 8h Js Ac",   // One pair
+	"6c 6d 9h 9s Qc",   // Two pair
+	"7c 7d 7h 10s Kc",  // Three of a kind
+	"5c 6d 7h 8s 9c",   // Straight
+	"2h 6h 9h Jh Kh",   // Flush
+	"3c 3d 3h Qs Qc",   // Full house
+	"8c 8d 8h 8s 2c",   // Four of a kind
+	"9s 10s Js Qs Ks"   // Straight flush
+};
+
+Hand parseHand(const char * text)
+{
+	Hand hand;
+	istringstream in(text);
+	string token;
+	while (in >> token)
+	{
+		Card c(token);
+		hand.add_card(c);
+	}
+	return hand;
+}
+
+Deck standardDeck()
+{
+	Deck deck;
+	for (int index = 0; index < Card::NUM_CARDS; index++)
+		deck.add_card(Card::fromIndex(index));
+	return deck;
+}
+
+/*
+Times full rounds, shuffled or, if scenario is not 0, dealt from scenario.
+Does nothing if scenario is for another variant.
+*/
+template <class Rules>
+void benchRounds(BenchRunner & runner, size_t numSeats, ScenarioReader * scenario = 0)
+{
+	if (scenario && scenario->getVariant() != SCENARIO_ANY && scenario->getVariant() != Rules::SCENARIO)
+		return;
+
+	ostringstream name;
+	name << "Simulation<" << Rules::name() << ">::playRound/" << numSeats << "-seats" << (scenario ? "/scenario" : "");
+
+	runner.run(name.str(), 2000, [numSeats, scenario](unsigned long long n) {
+		Simulation<Rules, RandomStrategy> sim(numSeats, RandomStrategy(12345));
+		sim.useScenario(scenario);
+		unsigned long long early = 0;
+		for (unsigned long long i = 0; i < n; i++)
+		{
+			if (scenario && scenario->getDealsRead() == scenario->getNumDeals())
+				scenario->rewind();
+			early += sim.playRound();
+		}
+		return early;
+	});
+}
+
+void benchAll(BenchRunner & runner, ScenarioReader * scenario)
+{
+	const char * const cardStrs[] = {"2c", "10d", "Jh", "As", "7s", "Qd", "10c", "3h"};
+	const int numCardStrs = sizeof(cardStrs) / sizeof(cardStrs[0]);
+
+	runner.run("Card(string)", 1000000, [&cardStrs, numCardStrs](unsigned long long n) {
+		unsigned long long total = 0;
+		for (unsigned long long i = 0; i < n; i++)
+			total += Card(string(cardStrs[i % numCardStrs])).getRank();
+		return total;
+	});
+
+	runner.run("Card(const char *, length)", 1000000, [&cardStrs, numCardStrs](unsigned long long n) {
+		unsigned long long total = 0;
+		for (unsigned long long i = 0; i < n; i++)
+		{
+			const char * str = cardStrs[i % numCardStrs];
+			total += Card(str, strlen(str)).getRank();
+		}
+		return total;
+	});
+
+	runner.run("Card::toString", 1000000, [](unsigned long long n) {
+		unsigned long long total = 0;
+		for (unsigned long long i = 0; i < n; i++)
+			total += Card::fromIndex((int)(i % Card::NUM_CARDS)).toString().length();
+		return total;
+	});
+
+	runner.run("Card::writeTo", 1000000, [](unsigned long long n) {
+		unsigned long long total = 0;
+		char buffer[Card::STR_BUFFER_SIZE];
+		for (unsigned long long i = 0; i < n; i++)
+			total += Card::fromIndex((int)(i % Card::NUM_CARDS)).writeTo(buffer);
+		return total;
+	});
+
+	runner.run("Hand::add_card/7-cards", 200000, [](unsigned long long n) {
+		unsigned long long total = 0;
+		for (unsigned long long i = 0; i < n; i++)
+		{
+			Hand hand;
+			for (int c = 0; c < (int)Hand::STUD_HAND_SIZE; c++)
+			{
+				Card card = Card::fromIndex((int)((i * 7 + c * 11) % Card::NUM_CARDS));
+				hand.add_card(card);
+			}
+			total += hand.size();
+		}
+		return total;
+	});
+
+	vector<Hand> samples;
+	for (int r = 0; r < STR_RANKS_COUNT; r++)
+		samples.push_back(parseHand(SAMPLE_HANDS[r]));
+
+	runner.run("Hand::calculateRank", 1000000, [&samples](unsigned long long n) {
+		unsigned long long total = 0;
+		for (unsigned long long i = 0; i < n; i++)
+		{
+			Hand & hand = samples[i % samples.size()];
+			hand.calculateRank();
+			total += hand.getRank();
+		}
+		return total;
+	});
+
+	const char * const strRanks[STR_RANKS_COUNT] = STR_RANKS;
+	for (int r1 = 0; r1 < STR_RANKS_COUNT; r1++)
+	{
+		for (int r2 = 0; r2 < STR_RANKS_COUNT; r2++)
+		{
+			const Hand & h1 = samples[r1];
+			const Hand & h2 = samples[r2];
+			runner.run(string("Hand::poker_rank/") + strRanks[r1] + " vs " + strRanks[r2], 1000000, [&h1, &h2](unsigned long long n) {
+				unsigned long long total = 0;
+				for (unsigned long long i = 0; i < n; i++)
+					total += Hand::poker_rank(h1, h2);
+				return total;
+			});
+		}
+	}
+
+	Hand studHand = parseHand("2c 5d 9h Js Kc 9c Jd");
+	runner.run("Hand::bestStudHand", 20000, [&studHand](unsigned long long n) {
+		unsigned long long total = 0;
+		for (unsigned long long i = 0; i < n; i++)
+			total += studHand.bestStudHand().getRank();
+		return total;
+	});
+
+	Deck deck = standardDeck();
+	runner.run("Deck::shuffle", 2000, [&deck](unsigned long long n) {
+		CounterRng numbers;
+		numbers.start(12345, 0, 0); // Fixed, so runs are repeatable
+		for (unsigned long long i = 0; i < n; i++)
+			deck.shuffle(numbers);
+		return (unsigned long long)deck.size();
+	});
+
+	string deckStr;
+	for (int index = 0; index < Card::NUM_CARDS; index++)
+		deckStr += string(Card::fromIndex(index).toCStr()) + (index % 13 == 12 ? "\n" : " ");
+	runner.run("Deck::parse/52-cards", 20000, [&deckStr](unsigned long long n) {
+		unsigned long long total = 0;
+		for (unsigned long long i = 0; i < n; i++)
+		{
+			Deck parsed;
+			parsed.parse(deckStr.data(), deckStr.length());
+			total += parsed.size();
+		}
+		return total;
+	});
+
+	runner.run("Deck::hasDuplicates", 20000, [&deck](unsigned long long n) {
+		unsigned long long total = 0;
+		for (unsigned long long i = 0; i < n; i++)
+			total += deck.hasDuplicates();
+		return total;
+	});
+
+	benchRounds<FiveCardDrawRules>(runner, 6);
+	benchRounds<SevenCardStudRules>(runner, 6);
+	benchRounds<TexasHoldEmRules>(runner, 6);
+	benchRounds<TexasHoldEmRules>(runner, 10);
+
+	if (scenario)
+	{
+		benchRounds<FiveCardDrawRules>(runner, 6, scenario);
+		benchRounds<SevenCardStudRules>(runner, 6, scenario);
+		benchRounds<TexasHoldEmRules>(runner, 6, scenario);
+		benchRounds<TexasHoldEmRules>(runner, 10, scenario);
+	}
+}
+
+/*
+Escapes a string for use inside JSON quotes.
+*/
+string jsonEscape(const string & str)
+{
+	string ans;
+	for (size_t i = 0; i < str.length(); i++)
+	{
+		if (str[i] == '"' || str[i] == '\\')
+			ans += '\\';
+		ans += str[i];
+	}
+	return ans;
+}
+
+void writeJson(ostream & out, const vector<BenchResult> & results)
+{
+	out << "{\n  \"benchmarks\": [\n";
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		out << "    {\"name\": \"" << jsonEscape(results[i].name) << "\", " <<
+			"\"iterations\": " << results[i].iterations << ", " <<
+			"\"ns_per_op\": " << results[i].nsPerOp << "}";
+		out << (i + 1 < results.size() ? ",\n" : "\n");
+	}
+	out << "  ]\n}\n";
+}
+
+/*
+Reads the name and ns_per_op of every benchmark in a file written by
+writeJson().  This is not a general JSON parser.
+
+Throws fstream::failure if the file cannot be opened.
+*/
+map<string, double> readBaseline(const char fileName[])
+{
+	ifstream in(fileName);
+	if (!in)
+		throw fstream::failure("Baseline file could not be opened");
+
+	map<string, double> baseline;
+	string line;
+	while (getline(in, line))
+	{
+		size_t nameKey = line.find("\"name\": \"");
+		size_t nsKey = line.find("\"ns_per_op\": ");
+		if (nameKey == string::npos || nsKey == string::npos)
+			continue;
+
+		string name;
+		for (size_t i = nameKey + 9; i < line.length() && line[i] != '"'; i++)
+		{
+			if (line[i] == '\\')
+				i++;
+			name += line[i];
+		}
+		baseline[name] = atof(line.c_str() + nsKey + 13);
+	}
+
+	return baseline;
+}
+
+/*
+Prints every benchmark that got slower than its baseline by more than
+tolerance.  Returns how many did.
+*/
+int compareBaseline(const vector<BenchResult> & results, const map<string, double> & baseline, double tolerance)
+{
+	int regressions = 0;
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		map<string, double>::const_iterator base = baseline.find(results[i].name);
+		if (base == baseline.end() || base->second <= 0)
+			continue;
+
+		double change = results[i].nsPerOp / base->second - 1;
+		if (change > tolerance)
+		{
+			cout << "REGRESSION: " << results[i].name << ": " << base->second << " -> " <<
+				results[i].nsPerOp << " ns/op (+" << (int)(change * 100) << "%)" << endl;
+			regressions++;
+		}
+	}
+
+	if (regressions == 0)
+		cout << "No regressions beyond " << (int)(tolerance * 100) << "% of the baseline." << endl;
+	return regressions;
+}
+
+int main(int argc, char * argv[])
+{
+	const char * outFile = "bench.json";
+	const char * baselineFile = 0;
+	double tolerance = 0.10;
+	string filter;
+	int reps = 5;
+	const char * scenarioFile = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool hasValue = (i + 1 < argc);
+		if (strcmp(argv[i], "--out") == 0 && hasValue)
+			outFile = argv[++i];
+		else if (strcmp(argv[i], "--baseline") == 0 && hasValue)
+			baselineFile = argv[++i];
+		else if (strcmp(argv[i], "--tolerance") == 0 && hasValue)
+			tolerance = atof(argv[++i]);
+		else if (strcmp(argv[i], "--filter") == 0 && hasValue)
+			filter = argv[++i];
+		else if (strcmp(argv[i], "--reps") == 0 && hasValue)
+			reps = max(1, atoi(argv[++i]));
+		else if (strcmp(argv[i], "--scenario") == 0 && hasValue)
+			scenarioFile = argv[++i];
+		else
+		{
+			cout << "Usage: " << argv[0] << " [--out file] [--baseline file] [--tolerance fraction] [--filter substring] [--reps n] [--scenario file]" << endl;
+			return 2;
+		}
+	}
+
+	unique_ptr<ScenarioReader> scenario;
+	if (scenarioFile)
+	{
+		try
+		{
+			scenario.reset(new ScenarioReader(scenarioFile));
+		}
+		catch (fstream::failure & e)
+		{
+			cout << scenarioFile << ": " << e.what() << endl;
+			return 2;
+		}
+		if (scenario->getNumDeals() == 0)
+		{
+			cout << scenarioFile << " has no deals." << endl;
+			return 2;
+		}
+	}
+
+	BenchRunner runner(filter, reps);
+	benchAll(runner, scenario.get());
+
+	ofstream out(outFile);
+	writeJson(out, runner.getResults());
+	out.close();
+	cout << "Wrote " << runner.getResults().size() << " results to " << outFile << " (checksum " << runner.getSink() << ")" << endl;
+	PROFILE_REPORT(cout);
+
+	if (baselineFile)
+	{
+		try
+		{
+			if (compareBaseline(runner.getResults(), readBaseline(baselineFile), tolerance) > 0)
+				return 1;
+		}
+		catch (fstream::failure & e)
+		{
+			cout << "Could not compare: " << e.what() << endl;
+			return 2;
+		}
+	}
+
+	return 0;
+}
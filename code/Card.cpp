@@ -10,7 +10,7 @@ Defines all functions in the Card class.
 #include "Card.h"
 
 #include <string>
-#include <sstream>
+#include <ctype.h>
 
 /*
 Constructs a face-up card with BAD_RANK and BAD_SIUIT
@@ -23,66 +23,96 @@ Constructs a face-up card with specified rank and suit
 Card::Card(CardRank rank, CardSuit suit)
 	: rank(rank), suit(suit), faceDown(false) {}
 
+namespace
+{
+	/*
+	256-entry lookup tables for the parser, indexed by unsigned char.  Ranks
+	and suits are case-insensitive; anything else maps to BAD_RANK or BAD_SUIT.
+	*/
+	struct CardCharTable
+	{
+		CardCharTable()
+		{
+			for (int i = 0; i < 256; i++)
+			{
+				rank[i] = BAD_RANK;
+				suit[i] = BAD_SUIT;
+			}
+
+			for (int r = TWO; r <= NINE; r++)
+				rank['0' + r] = (unsigned char)r;
+
+			const char faces[] = "JQKA";
+			for (int i = 0; i < 4; i++)
+			{
+				rank[(unsigned char)faces[i]] = (unsigned char)(JACK + i);
+				rank[(unsigned char)tolower(faces[i])] = (unsigned char)(JACK + i);
+			}
+
+			const CardSuit suits[] = {CLUBS, DIAMONDS, HEARTS, SPADES};
+			for (int i = 0; i < 4; i++)
+			{
+				suit[(unsigned char)suits[i]] = (char)suits[i];
+				suit[(unsigned char)toupper(suits[i])] = (char)suits[i];
+			}
+		}
+
+		unsigned char rank[256];
+		char suit[256];
+	};
+
+	const CardCharTable & charTable()
+	{
+		static const CardCharTable table;
+		return table;
+	}
+}
+
 /*
 Constructs a face-up card represented by the input string.
 If the string is improperly formatted, then constructs
 a card with bad rank or bad suit (or both).
 */
-Card::Card(std::string raw)
-	: faceDown(false)
+Card::Card(const std::string & raw)
+	: Card(raw.data(), raw.length()) {}
+
+/*
+Same as the string constructor, but parses the first length chars of raw,
+which need not be null-terminated.  Does not allocate.
+*/
+Card::Card(const char * raw, size_t length)
+	: rank(BAD_RANK), suit(BAD_SUIT), faceDown(false)
 {
-	if ( (raw.length() < MIN_CARD_STR_LEN) && (raw.length() > MAX_CARD_STR_LEN) )
-	{
-		this->rank = BAD_RANK; this->suit = BAD_SUIT;
+	if ( (length < MIN_CARD_STR_LEN) || (length > MAX_CARD_STR_LEN) )
 		return;
-	}
 
-	std::istringstream stream(raw);
-	int intRank = 0;
-	char charRank = '\0';
-	char suit = '\0';
+	const CardCharTable & table = charTable();
+	const unsigned char * chars = reinterpret_cast<const unsigned char *>(raw);
 
 	//////////
 	// RANK //
 	//////////
-	if (isdigit(raw[0])) // First char a digit?
+	int intRank;
+	if (length == MAX_CARD_STR_LEN)
 	{
-		stream >> intRank;
-
-		if ( (intRank < MIN_NUM_RANK) || (intRank > MAX_NUM_RANK) )
-		{
-			this->rank = BAD_RANK; this->suit = BAD_SUIT;
+		// The only rank that takes two chars is 10
+		if (chars[0] != '1' || chars[1] != '0')
 			return;
-		}
-		if ( (intRank < 10) && (raw.length() != 2) )
-		{
-			// Single digit: only acceptable length is 2
-			this->rank = BAD_RANK; this->suit = BAD_SUIT;
-			return;
-		}
+		intRank = TEN;
 	}
 	else
-	{ // Not digit: only acceptable length is 2
-		if (raw.length() != 2)
-		{
-			this->rank = BAD_RANK; this->suit = BAD_SUIT;
-			return;
-		}
-
-		stream >> charRank;
-		intRank = charRankToInt(charRank);
-		// intRank may be equal to BAD_RANK
+	{
+		intRank = table.rank[chars[0]];
+		if (intRank == BAD_RANK && isdigit(chars[0]))
+			return; // Numbers out of range make the whole card bad
+		// Otherwise intRank may be equal to BAD_RANK
 	}
 
 	//////////
 	// SUIT //
 	//////////
-	stream >> suit;
-	if ( !Card::isValidSuit(suit) )
-		suit = BAD_SUIT;
-
 	this->rank = (CardRank)intRank;
-	this->suit = (CardSuit)tolower(suit);
+	this->suit = (CardSuit)table.suit[chars[length - 1]];
 }
 
 CardRank Card::getRank() const
@@ -95,43 +125,73 @@ CardSuit Card::getSuit() const
 	return suit;
 }
 
+namespace
+{
+	// Indexed by Card::toIndex()
+	const char CARD_STRS[Card::NUM_CARDS][Card::STR_BUFFER_SIZE] = {
+		"2c", "2d", "2h", "2s", "3c", "3d", "3h", "3s", "4c", "4d", "4h", "4s",
+		"5c", "5d", "5h", "5s", "6c", "6d", "6h", "6s", "7c", "7d", "7h", "7s",
+		"8c", "8d", "8h", "8s", "9c", "9d", "9h", "9s", "10c", "10d", "10h", "10s",
+		"Jc", "Jd", "Jh", "Js", "Qc", "Qd", "Qh", "Qs", "Kc", "Kd", "Kh", "Ks",
+		"Ac", "Ad", "Ah", "As"
+	};
+
+	// Indexed by CardRank; BAD_RANK and anything else invalid is '?'
+	const char * const RANK_STRS[HIGHEST_RANK + 1] = {
+		"?", "?", "2", "3", "4", "5", "6", "7", "8", "9", "10", "J", "Q", "K", "A"
+	};
+
+	// Cards with a bad suit, indexed by CardRank
+	const char * const BAD_SUIT_STRS[HIGHEST_RANK + 1] = {
+		"??", "??", "2?", "3?", "4?", "5?", "6?", "7?", "8?", "9?", "10?", "J?", "Q?", "K?", "A?"
+	};
+}
+
 /*
 Returns a string which represents this Card's
 rank and suit data.
 */
 std::string Card::toString() const
 {
-	std::string ans = "";
+	char buffer[STR_BUFFER_SIZE];
+	size_t length = writeTo(buffer);
+	return std::string(buffer, length);
+}
+
+/*
+Same as toString(), but returns a pointer into a static table instead of
+allocating a string.  Cards with a valid rank but a bad suit come out like
+"5?"; cards with a bad rank come out as "??".
+*/
+const char * Card::toCStr() const
+{
+	int index = toIndex();
+	if (index >= 0)
+		return CARD_STRS[index];
+	if (isValidRank(rank))
+		return BAD_SUIT_STRS[rank];
+	return BAD_SUIT_STRS[BAD_RANK];
+}
 
-	// RANK: convert int rank to a string
-	int rank = this->rank;
-	switch (rank)
+/*
+Writes the same characters as toString() into buffer, followed by '\0'.
+buffer must hold at least STR_BUFFER_SIZE chars.  Returns the number of
+characters written, not counting the '\0'.
+*/
+size_t Card::writeTo(char * buffer) const
+{
+	const char * rankStr = RANK_STRS[isValidRank(rank) ? rank : BAD_RANK];
+	size_t length = 0;
+	while (rankStr[length] != '\0')
 	{
-		case JACK:
-			ans += JACK_CHAR;
-			break;
-		case QUEEN:
-			ans += QUEEN_CHAR;
-			break;
-		case KING:
-			ans += KING_CHAR;
-			break;
-		case ACE:
-			ans += ACE_CHAR;
-			break;
-		case BAD_RANK:
-			ans += BAD_RANK_CHAR;
-			break;
-		default:
-			std::stringstream ss;
-			ss << rank;
-			ans.append(ss.str());
+		buffer[length] = rankStr[length];
+		length++;
 	}
 
 	// SUIT: stored as char; much easier
-	ans += this->suit;
-
-	return ans;
+	buffer[length++] = (char)suit;
+	buffer[length] = '\0';
+	return length;
 }
 
 bool Card::operator< (const Card & other) const
@@ -216,3 +276,61 @@ bool Card::isValidSuit(char suit)
 			lsuit == HEARTS ||
 			lsuit == SPADES);
 }
+
+/*
+Returns a number between 0 and NUM_CARDS - 1 that identifies this card.  
+Indices sort the same way as operator <: by rank, then by suit.  
+Returns -1 if the card has a bad rank or suit.
+*/
+int Card::toIndex() const
+{
+	int suitIndex;
+	switch (suit)
+	{
+		case CLUBS:
+			suitIndex = 0;
+			break;
+		case DIAMONDS:
+			suitIndex = 1;
+			break;
+		case HEARTS:
+			suitIndex = 2;
+			break;
+		case SPADES:
+			suitIndex = 3;
+			break;
+		default:
+			return -1;
+	}
+
+	if (!isValidRank(rank))
+		return -1;
+
+	return (rank - LOWEST_RANK) * NUM_SUITS + suitIndex;
+}
+
+/*
+Returns a mask with only this card's bit set, or 0 for a bad card.
+*/
+CardMask Card::toMask() const
+{
+	int index = toIndex();
+	if (index < 0)
+		return 0;
+
+	return (CardMask)1 << index;
+}
+
+/*
+Inverse of toIndex().  Returns a card with BAD_RANK and BAD_SUIT if 
+the index is out of range.
+*/
+Card Card::fromIndex(int index)
+{
+	static const CardSuit suits[NUM_SUITS] = {CLUBS, DIAMONDS, HEARTS, SPADES};
+
+	if (index < 0 || index >= NUM_CARDS)
+		return Card();
+
+	return Card((CardRank)(LOWEST_RANK + index / NUM_SUITS), suits[index % NUM_SUITS]);
+}
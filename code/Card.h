@@ -11,6 +11,7 @@ ranks and suits, and a bunch of utility functions.
 #define CARD_H
 
 #include <string>
+#include <stddef.h>
 
 enum CardRank
 {
@@ -41,12 +42,16 @@ enum CardSuit
 	SPADES = 's'
 };
 
+// One bit per card, indexed by Card::toIndex()
+typedef unsigned long long CardMask;
+
 class Card
 {
 public:
 	Card();
     Card(CardRank rank, CardSuit suit);
-	Card(std::string raw);
+	Card(const std::string & raw);
+	Card(const char * raw, size_t length);
 	
 	// Information
 	CardRank getRank() const;
@@ -54,6 +59,12 @@ public:
 	bool faceDown;
 	std::string toString() const;
 
+	// Formatting without allocating.  toCStr() points into a static table;
+	// writeTo() needs a buffer of at least STR_BUFFER_SIZE chars.
+	const char * toCStr() const;
+	size_t writeTo(char * buffer) const;
+	static const int STR_BUFFER_SIZE = 4;
+
 	// Comparison
 	bool operator < (const Card & other) const;
 	bool operator > (const Card & other) const;
@@ -66,6 +77,13 @@ public:
 	static bool isValidRank(int rank);
 	static bool isValidSuit(char suit);
 
+	// Compact index between 0 and NUM_CARDS - 1, in the same order as operator <
+	int toIndex() const;
+	CardMask toMask() const;
+	static Card fromIndex(int index);
+	static const int NUM_CARDS = 52;
+	static const int NUM_SUITS = 4;
+
 
 private:
 	CardRank rank;
@@ -74,8 +92,6 @@ private:
 	// For the constructor that takes a string
 	static const int MIN_CARD_STR_LEN = 2;
 	static const int MAX_CARD_STR_LEN = 3;
-	static const int MIN_NUM_RANK = 2;
-	static const int MAX_NUM_RANK = 10;
 
 	// For converting rank, which is stored as int, to chars and vice-versa
 	static const char JACK_CHAR = 'J';
@@ -0,0 +1,429 @@
+/*
+Census.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Entry point for the hand census, built as its own executable.  Enumerates
+all 2,598,960 five-card hands from a standard deck, in parallel, and checks
+the hand evaluator against facts that any correct evaluator must satisfy:
+
+1. Hand::calculateRank() puts exactly the known number of hands in each
+   poker rank (40 straight flushes, 624 fours of a kind, ...).
+2. Hands with the same ranks and the same flush-ness tie under
+   Hand::poker_rank(), and there are exactly 7,462 such classes.
+3. Hand::poker_rank() orders the classes strictly and transitively, and
+   never lets a lower poker rank beat a higher one.
+4. Hand::poker_rank() orders every pair of classes as standard poker rules
+   do; in particular, the wheel (A-2-3-4-5) is the lowest straight.
+
+It also reports hands per second for the rank pass.  Any replacement evaluator must pass every check and
+produce the same report.
+
+Usage: Census [--threads n]
+Exits with 1 if any check fails.
+*/
+
+#include "stdafx.h"
+#include "Card.h"
+#include "Hand.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+
+const int HAND_CARDS = (int)Hand::POKER_HAND_SIZE;
+const unsigned long TOTAL_HANDS = 2598960;
+const size_t TOTAL_CLASSES = 7462;
+
+const unsigned long EXPECTED_COUNTS[STR_RANKS_COUNT] = {
+	1302540, // High card
+	1098240, // One pair
+	123552,  // Two pair
+	54912,   // Three of a kind
+	10200,   // Straight
+	5108,    // Flush
+	3744,    // Full house
+	624,     // Four of a kind
+	40       // Straight flush
+};
+
+/*
+Computes a hand's strength under standard poker rules without using Hand,
+as (poker rank << 20) followed by five rank nibbles, most important first.
+Equal keys mean equal hands.  The wheel (A-2-3-4-5) is a five-high straight.
+*/
+unsigned long standardKey(const int cards[HAND_CARDS])
+{
+	int counts[HIGHEST_RANK + 1] = {0};
+	bool flush = true;
+	for (int i = 0; i < HAND_CARDS; i++)
+	{
+		counts[LOWEST_RANK + cards[i] / Card::NUM_SUITS]++;
+		if (cards[i] % Card::NUM_SUITS != cards[0] % Card::NUM_SUITS)
+			flush = false;
+	}
+
+	// Ranks ordered by how many times they appear, then by rank
+	int ordered[HAND_CARDS];
+	int numOrdered = 0;
+	for (int times = 4; times >= 1; times--)
+	{
+		for (int rank = HIGHEST_RANK; rank >= LOWEST_RANK; rank--)
+		{
+			for (int i = 0; i < counts[rank] && counts[rank] == times; i++)
+				ordered[numOrdered++] = rank;
+		}
+	}
+
+	bool distinct = (counts[ordered[0]] == 1);
+	bool straight = distinct && (ordered[0] - ordered[4] == 4);
+	if (distinct && ordered[0] == ACE && ordered[1] == FIVE) // Wheel
+	{
+		straight = true;
+		for (int i = 0; i < HAND_CARDS - 1; i++)
+			ordered[i] = ordered[i + 1];
+		ordered[HAND_CARDS - 1] = 1;
+	}
+
+	int first = counts[ordered[0] == 1 ? ACE : ordered[0]];
+	int second = (first < HAND_CARDS ? counts[ordered[first]] : 0);
+
+	pokerRank rank;
+	if (straight && flush)
+		rank = STRAIGHT_FLUSH;
+	else if (first == 4)
+		rank = FOUR_KIND;
+	else if (first == 3 && second == 2)
+		rank = FULL_HOUSE;
+	else if (flush)
+		rank = FLUSH;
+	else if (straight)
+		rank = STRAIGHT;
+	else if (first == 3)
+		rank = THREE_KIND;
+	else if (first == 2 && second == 2)
+		rank = TWO_PAIR;
+	else if (first == 2)
+		rank = PAIR;
+	else
+		rank = HIGH_CARD;
+
+	unsigned long key = (unsigned long)rank;
+	for (int i = 0; i < HAND_CARDS; i++)
+		key = (key << 4) | ordered[i];
+	return key;
+}
+
+/*
+Sets cards to the combination with the specified index in the combinatorial
+number system, i.e. the index-th hand in lexicographic order.
+*/
+void unrankHand(unsigned long index, int cards[HAND_CARDS])
+{
+	int next = 0;
+	for (int pos = 0; pos < HAND_CARDS; pos++)
+	{
+		while (true)
+		{
+			// Number of hands that start with this card at this position
+			unsigned long count = 1;
+			int left = Card::NUM_CARDS - next - 1;
+			int need = HAND_CARDS - pos - 1;
+			for (int i = 0; i < need; i++)
+				count = count * (left - i) / (i + 1);
+
+			if (index < count)
+				break;
+			index -= count;
+			next++;
+		}
+		cards[pos] = next++;
+	}
+}
+
+/*
+Advances cards to the next hand in lexicographic order.
+*/
+void nextHand(int cards[HAND_CARDS])
+{
+	int pos = HAND_CARDS - 1;
+	while (pos > 0 && cards[pos] == Card::NUM_CARDS - HAND_CARDS + pos)
+		pos--;
+
+	cards[pos]++;
+	for (int i = pos + 1; i < HAND_CARDS; i++)
+		cards[i] = cards[i - 1] + 1;
+}
+
+Hand makeHand(const int cards[HAND_CARDS])
+{
+	CardMask mask = 0;
+	for (int i = 0; i < HAND_CARDS; i++)
+		mask |= (CardMask)1 << cards[i];
+	return Hand(mask);
+}
+
+/*
+Everything one thread learns about its share of the hands.
+*/
+struct CensusShard
+{
+	CensusShard() : rankMismatches(0), classTies(0), firstBadMask(0)
+	{
+		memset(counts, 0, sizeof(counts));
+	}
+
+	unsigned long counts[STR_RANKS_COUNT];
+	unsigned long rankMismatches; // calculateRank() disagrees with the standard poker rank
+	unsigned long classTies;      // Hands that don't tie with their class's first hand
+	CardMask firstBadMask;
+	map<unsigned long, CardMask> classes; // standardKey -> first hand seen
+};
+
+/*
+Ranks hands [begin, end) and groups them into classes.  Checks each hand
+against the first hand of its class that this thread saw.
+*/
+void censusRange(unsigned long begin, unsigned long end, CensusShard * shard)
+{
+	int cards[HAND_CARDS];
+	unrankHand(begin, cards);
+
+	map<unsigned long, Hand> representatives;
+	for (unsigned long index = begin; index < end; index++, nextHand(cards))
+	{
+		Hand hand = makeHand(cards);
+		hand.calculateRank();
+		shard->counts[hand.getRank()]++;
+
+		unsigned long key = standardKey(cards);
+		if ((unsigned long)hand.getRank() != (key >> 20))
+		{
+			if (!shard->firstBadMask)
+				shard->firstBadMask = hand.toMask();
+			shard->rankMismatches++;
+			continue;
+		}
+
+		map<unsigned long, Hand>::iterator rep = representatives.find(key);
+		if (rep == representatives.end())
+		{
+			representatives.insert(make_pair(key, hand));
+			shard->classes[key] = hand.toMask();
+		}
+		else if (Hand::poker_rank(hand, rep->second) || Hand::poker_rank(rep->second, hand))
+		{
+			if (!shard->firstBadMask)
+				shard->firstBadMask = hand.toMask();
+			shard->classTies++;
+		}
+	}
+}
+
+/*
+Plays every class against every class in rows [begin, end).  wins[i] counts
+the classes that class i beats.  Also counts pairs that beat each other,
+pairs of different classes that tie, lower poker ranks beating higher ones,
+and disagreements with standard poker rules.
+*/
+struct OrderShard
+{
+	OrderShard() : bothWin(0), ties(0), rankInversions(0), nonStandard(0), exampleA(0), exampleB(0), badA(0), badB(0) {}
+
+	unsigned long bothWin;
+	unsigned long ties;
+	unsigned long rankInversions;
+	unsigned long nonStandard;
+	CardMask exampleA; // First pair ordered differently from standard poker rules
+	CardMask exampleB;
+	CardMask badA;     // First pair that failed a check
+	CardMask badB;
+};
+
+void orderRange(const vector<Hand> * hands, const vector<unsigned long> * keys, size_t begin, size_t end,
+	vector<unsigned long> * wins, OrderShard * shard)
+{
+	size_t n = hands->size();
+	for (size_t i = begin; i < end; i++)
+	{
+		const Hand & a = (*hands)[i];
+		for (size_t j = 0; j < n; j++)
+		{
+			if (i == j)
+				continue;
+
+			const Hand & b = (*hands)[j];
+			bool aWins = Hand::poker_rank(a, b);
+			bool bWins = Hand::poker_rank(b, a);
+
+			if (aWins)
+				(*wins)[i]++;
+			if (aWins && bWins)
+				shard->bothWin++;
+			if (!aWins && !bWins)
+				shard->ties++;
+			if (bWins && a.getRank() > b.getRank())
+				shard->rankInversions++;
+			if (aWins == bWins || (bWins && a.getRank() > b.getRank()))
+			{
+				if (!shard->badA)
+				{
+					shard->badA = a.toMask();
+					shard->badB = b.toMask();
+				}
+			}
+			if (aWins && (*keys)[i] < (*keys)[j])
+			{
+				if (!shard->nonStandard)
+				{
+					shard->exampleA = a.toMask();
+					shard->exampleB = b.toMask();
+				}
+				shard->nonStandard++;
+			}
+		}
+	}
+}
+
+bool check(bool ok, const string & what)
+{
+	cout << (ok ? "  ok    " : "  FAIL  ") << what << endl;
+	return ok;
+}
+
+int main(int argc, char * argv[])
+{
+	unsigned numThreads = thread::hardware_concurrency();
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+			numThreads = atoi(argv[++i]);
+		else
+		{
+			cout << "Usage: " << argv[0] << " [--threads n]" << endl;
+			return 2;
+		}
+	}
+	if (numThreads == 0)
+		numThreads = 1;
+
+	// Pass 1: rank every hand
+	cout << "Ranking " << TOTAL_HANDS << " hands on " << numThreads << " thread(s)..." << endl;
+	vector<CensusShard> shards(numThreads);
+	vector<thread> threads;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (unsigned t = 0; t < numThreads; t++)
+	{
+		unsigned long begin = TOTAL_HANDS * t / numThreads;
+		unsigned long end = TOTAL_HANDS * (t + 1) / numThreads;
+		threads.push_back(thread(censusRange, begin, end, &shards[t]));
+	}
+	for (size_t t = 0; t < threads.size(); t++)
+		threads[t].join();
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	CensusShard total;
+	map<unsigned long, CardMask> classes;
+	for (size_t t = 0; t < shards.size(); t++)
+	{
+		for (int r = 0; r < STR_RANKS_COUNT; r++)
+			total.counts[r] += shards[t].counts[r];
+		total.rankMismatches += shards[t].rankMismatches;
+		total.classTies += shards[t].classTies;
+		if (!total.firstBadMask)
+			total.firstBadMask = shards[t].firstBadMask;
+		classes.insert(shards[t].classes.begin(), shards[t].classes.end()); // Keeps the first hand seen
+	}
+
+	cout << "Ranked in " << seconds << " s (" << (unsigned long)(TOTAL_HANDS / seconds) << " hands/s)" << endl;
+
+	bool allOk = true;
+	const char * const strRanks[STR_RANKS_COUNT] = STR_RANKS;
+	unsigned long sum = 0;
+	for (int r = STR_RANKS_COUNT - 1; r >= 0; r--)
+	{
+		ostringstream what;
+		what << strRanks[r] << ": " << total.counts[r] << " (expected " << EXPECTED_COUNTS[r] << ")";
+		allOk &= check(total.counts[r] == EXPECTED_COUNTS[r], what.str());
+		sum += total.counts[r];
+	}
+	allOk &= check(sum == TOTAL_HANDS, "every hand was ranked");
+	allOk &= check(total.rankMismatches == 0, "calculateRank() agrees with the standard rank of every hand");
+	allOk &= check(total.classTies == 0, "hands with the same ranks and flush-ness tie under poker_rank()");
+	allOk &= check(classes.size() == TOTAL_CLASSES, "there are 7462 classes of hands");
+	if (total.firstBadMask)
+		cout << "        first bad hand: " << Hand(total.firstBadMask).toString() << endl;
+
+	// Pass 2: play every class against every other
+	vector<Hand> hands;
+	vector<unsigned long> keys;
+	for (map<unsigned long, CardMask>::iterator iter = classes.begin(); iter != classes.end(); iter++)
+	{
+		hands.push_back(Hand(iter->second));
+		hands.back().calculateRank();
+		keys.push_back(iter->first);
+	}
+
+	cout << "Comparing " << hands.size() << " classes pairwise..." << endl;
+	vector<vector<unsigned long>> wins(numThreads, vector<unsigned long>(hands.size(), 0));
+	vector<OrderShard> orders(numThreads);
+	threads.clear();
+	for (unsigned t = 0; t < numThreads; t++)
+	{
+		size_t begin = hands.size() * t / numThreads;
+		size_t end = hands.size() * (t + 1) / numThreads;
+		threads.push_back(thread(orderRange, &hands, &keys, begin, end, &wins[t], &orders[t]));
+	}
+	for (size_t t = 0; t < threads.size(); t++)
+		threads[t].join();
+
+	OrderShard order;
+	vector<unsigned long> score(hands.size(), 0);
+	for (size_t t = 0; t < numThreads; t++)
+	{
+		order.bothWin += orders[t].bothWin;
+		order.ties += orders[t].ties;
+		order.rankInversions += orders[t].rankInversions;
+		if (!order.badA)
+		{
+			order.badA = orders[t].badA;
+			order.badB = orders[t].badB;
+		}
+		if (!order.nonStandard && orders[t].nonStandard)
+		{
+			order.exampleA = orders[t].exampleA;
+			order.exampleB = orders[t].exampleB;
+		}
+		order.nonStandard += orders[t].nonStandard;
+		for (size_t i = 0; i < hands.size(); i++)
+			score[i] += wins[t][i];
+	}
+
+	// A complete tournament is transitive iff its scores are exactly 0, 1, ..., n-1
+	sort(score.begin(), score.end());
+	bool transitive = true;
+	for (size_t i = 0; i < score.size(); i++)
+		transitive &= (score[i] == i);
+
+	allOk &= check(order.bothWin == 0, "no two classes beat each other");
+	allOk &= check(order.ties == 0, "no two different classes tie");
+	allOk &= check(transitive, "poker_rank() is transitive over all classes");
+	allOk &= check(order.rankInversions == 0, "a lower poker rank never beats a higher one");
+	if (order.badA)
+		cout << "        first bad pair: " << Hand(order.badA).toString() << " vs " << Hand(order.badB).toString() << endl;
+
+	allOk &= check(order.nonStandard == 0, "every class pair is ordered as in standard poker rules");
+	if (order.nonStandard)
+		cout << "        " << order.nonStandard << " pair(s) differ, e.g. " << Hand(order.exampleA).toString() << " beats " << Hand(order.exampleB).toString() << endl;
+
+	cout << (allOk ? "All checks passed." : "Some checks FAILED.") << endl;
+	return allOk ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+/*
+Coroutine.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Defines Coroutine.
+*/
+
+#include "stdafx.h"
+#include "Coroutine.h"
+
+#include <stdexcept>
+#include <assert.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+static thread_local Coroutine * running = 0;
+
+/*
+Makes a coroutine that will run body the first time it is resumed.
+
+Throws runtime_error if its stack cannot be made.
+*/
+Coroutine::Coroutine(const std::function<void ()> & body, size_t stackSize)
+	: body(body), finished(false), outer(0)
+{
+#ifdef _WIN32
+	caller = 0;
+	fiber = CreateFiber(stackSize, &Coroutine::start, this);
+	if (!fiber)
+		throw runtime_error("Could not make a coroutine");
+#else
+	size_t page = (size_t)sysconf(_SC_PAGESIZE);
+	stackSize = (stackSize + page - 1) / page * page;
+	mappedSize = stackSize + page;
+	stack = mmap(0, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (stack == MAP_FAILED)
+		throw runtime_error("Could not make a coroutine");
+	mprotect(stack, page, PROT_NONE); // The stack grows down; overflowing it faults instead of corrupting memory
+
+	getcontext(&context);
+	context.uc_stack.ss_sp = (char *)stack + page;
+	context.uc_stack.ss_size = stackSize;
+	context.uc_link = 0;
+	makecontext(&context, &Coroutine::start, 0);
+#endif
+}
+
+/*
+Frees the stack.  A coroutine that is suspended, not finished, should not 
+be destroyed: whatever is on its stack is never destroyed.
+*/
+Coroutine::~Coroutine()
+{
+#ifdef _WIN32
+	DeleteFiber(fiber);
+#else
+	munmap(stack, mappedSize);
+#endif
+}
+
+/*
+Runs the coroutine until it suspends itself or finishes.  Returns false if 
+it has finished, now or before.
+
+Rethrows anything the coroutine threw.
+*/
+bool Coroutine::resume()
+{
+	if (finished)
+		return false;
+
+	outer = running;
+	running = this;
+#ifdef _WIN32
+	if (!IsThreadAFiber())
+		ConvertThreadToFiber(0);
+	caller = GetCurrentFiber();
+	SwitchToFiber(fiber);
+#else
+	swapcontext(&caller, &context);
+#endif
+	running = outer;
+
+	if (error)
+	{
+		exception_ptr thrown = error;
+		error = exception_ptr();
+		rethrow_exception(thrown);
+	}
+
+	return !finished;
+}
+
+bool Coroutine::isFinished() const
+{
+	return finished;
+}
+
+/*
+Called from inside a coroutine: goes back to whatever resumed it.  Returns 
+when the coroutine is next resumed.
+*/
+void Coroutine::suspend()
+{
+	Coroutine * self = running;
+	assert(self);
+#ifdef _WIN32
+	SwitchToFiber(self->caller);
+#else
+	swapcontext(&self->context, &self->caller);
+#endif
+}
+
+/*
+The coroutine that is running on this thread, or 0 if none is.
+*/
+Coroutine * Coroutine::current()
+{
+	return running;
+}
+
+void Coroutine::run()
+{
+	try
+	{
+		body();
+	}
+	catch (...)
+	{
+		error = current_exception();
+	}
+	finished = true;
+}
+
+#ifdef _WIN32
+void __stdcall Coroutine::start(void * self)
+{
+	Coroutine * coroutine = (Coroutine *)self;
+	coroutine->run();
+	SwitchToFiber(coroutine->caller); // Never resumed again
+}
+#else
+void Coroutine::start()
+{
+	Coroutine * coroutine = running;
+	coroutine->run();
+	setcontext(&coroutine->caller); // Never resumed again
+}
+#endif
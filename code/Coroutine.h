@@ -0,0 +1,70 @@
+/*
+Coroutine.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Declares Coroutine, a function that runs on a stack of its own and can 
+suspend itself partway through, to be resumed later from where it left 
+off.  Code that blocks waiting for something, such as a Game waiting for 
+a player's decision, can suspend instead, so one thread can take turns 
+running any number of them.
+
+Suspending works from any depth of ordinary calls; the functions between 
+resume() and suspend() need no changes.  The stack is reserved up front 
+but only the pages that are touched take memory, so a coroutine costs 
+little more than the stack it actually uses.  Uses ucontext on POSIX and 
+fibers on Windows.
+
+An exception that leaves the function is thrown again from resume().
+*/
+
+#ifndef COROUTINE_H
+#define COROUTINE_H
+
+#include <functional>
+#include <exception>
+#include <stddef.h>
+
+#ifndef _WIN32
+#include <ucontext.h>
+#endif
+
+class Coroutine
+{
+public:
+	Coroutine(const std::function<void ()> & body, size_t stackSize = DEFAULT_STACK_SIZE);
+	~Coroutine();
+
+	bool resume();
+	bool isFinished() const;
+
+	static void suspend();
+	static Coroutine * current();
+
+	static const size_t DEFAULT_STACK_SIZE = 256 * 1024;
+
+private:
+	// Undefined, so that no copies can be made.
+	Coroutine(const Coroutine & other);
+	Coroutine & operator= (const Coroutine & other);
+
+	void run();
+
+	std::function<void ()> body;
+	std::exception_ptr error; // Thrown by body, for resume() to rethrow
+	bool finished;
+	Coroutine * outer; // The coroutine that resumed this one, if any
+#ifdef _WIN32
+	static void __stdcall start(void * self);
+	void * fiber;
+	void * caller; // The fiber to go back to
+#else
+	static void start();
+	void * stack;
+	size_t mappedSize;
+	ucontext_t context;
+	ucontext_t caller; // Where to go back to
+#endif
+};
+
+#endif
@@ -0,0 +1,130 @@
+/*
+CounterRng.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Declares and defines CounterRng, a counter-based random number generator
+(Philox4x32-10).  Every 128-bit block of output is a keyed hash of a
+counter, so there is no hidden state carried from one hand to the next:
+start(seed, stream, position) jumps straight to the numbers for, say,
+hand number position at table number stream.  Two tables never share
+numbers, and any hand can be dealt again on its own, whatever order the
+hands were first played in and however many threads played them.
+
+CounterRng has no constructor, so it can live inside a TableState; call
+start() before drawing any numbers.
+*/
+
+#ifndef COUNTER_RNG_H
+#define COUNTER_RNG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <algorithm>
+
+struct CounterRng
+{
+	void start(uint64_t seed, uint32_t stream, uint64_t position);
+	uint32_t next();
+	uint32_t below(uint32_t n);
+	template <class T>
+	void shuffle(T * first, T * last);
+
+	static void philox(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]);
+
+	uint32_t key[2]; // The seed
+	uint32_t counter[4]; // Block number, stream, then position (low, high)
+	uint32_t block[4]; // Output of the current counter
+	unsigned used; // Words of block already handed out
+};
+
+/*
+Positions the generator at the first number of the specified stream and
+position under seed.
+*/
+inline void CounterRng::start(uint64_t seed, uint32_t stream, uint64_t position)
+{
+	key[0] = (uint32_t)seed;
+	key[1] = (uint32_t)(seed >> 32);
+	counter[0] = 0;
+	counter[1] = stream;
+	counter[2] = (uint32_t)position;
+	counter[3] = (uint32_t)(position >> 32);
+	used = 4;
+}
+
+/*
+Returns the next 32 random bits.
+*/
+inline uint32_t CounterRng::next()
+{
+	if (used == 4)
+	{
+		philox(counter, key, block);
+		counter[0]++; // 2^32 blocks per position is far more than a hand needs
+		used = 0;
+	}
+	return block[used++];
+}
+
+/*
+Returns a uniformly distributed number in [0, n).  Uses a multiply and
+shift instead of %, and rejects the few products that would bias the
+result toward small numbers.  n must not be 0.
+*/
+inline uint32_t CounterRng::below(uint32_t n)
+{
+	uint64_t product = (uint64_t)next() * n;
+	uint32_t low = (uint32_t)product;
+	if (low < n)
+	{
+		uint32_t threshold = (uint32_t)(-n) % n;
+		while (low < threshold)
+		{
+			product = (uint64_t)next() * n;
+			low = (uint32_t)product;
+		}
+	}
+	return (uint32_t)(product >> 32);
+}
+
+/*
+Puts [first, last) in a uniformly random order (Fisher-Yates).
+*/
+template <class T>
+void CounterRng::shuffle(T * first, T * last)
+{
+	for (ptrdiff_t i = last - first - 1; i > 0; i--)
+		std::swap(first[i], first[below((uint32_t)i + 1)]);
+}
+
+/*
+Ten rounds of Philox4x32 on counter under key.
+*/
+inline void CounterRng::philox(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4])
+{
+	const uint32_t MULT0 = 0xD2511F53, MULT1 = 0xCD9E8D57;
+	const uint32_t WEYL0 = 0x9E3779B9, WEYL1 = 0xBB67AE85;
+
+	uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+	uint32_t k0 = key[0], k1 = key[1];
+	for (int round = 0; round < 10; round++)
+	{
+		uint64_t p0 = (uint64_t)MULT0 * c0;
+		uint64_t p1 = (uint64_t)MULT1 * c2;
+		uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+		uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+		c1 = (uint32_t)p1;
+		c3 = (uint32_t)p0;
+		c0 = n0;
+		c2 = n2;
+		k0 += WEYL0;
+		k1 += WEYL1;
+	}
+	out[0] = c0;
+	out[1] = c1;
+	out[2] = c2;
+	out[3] = c3;
+}
+
+#endif
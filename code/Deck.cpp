@@ -8,18 +8,22 @@ Implements the Deck class and its ostream insertion operator.
 
 #include "StdAfx.h"
 #include "Deck.h"
+#include "Profiler.h"
 
 #include <fstream>
 #include <ostream>
 
 #include <string>
+#include <vector>
 #include <algorithm>
+#include <ctype.h>
 #include <set>
+#include <random>
 #include <time.h>
 
 /*
-Constructs an empty deck.  Also reseeds the random number generator 
-used for shuffling.
+Constructs an empty deck.  Also seeds the random number generator 
+used for shuffling with randomSeed().
 */
 Deck::Deck() : cards(std::deque<Card>())
 {
@@ -50,26 +54,55 @@ void Deck::add_cards(const Deck & other)
 
 /*
 Reads valid card definition strings from the specified file and
-pushes them back into this Deck's card deque.  
+pushes them back into this Deck's card deque.  The whole file is read
+with a single call and then parsed in place.
 
 Throws fstream::failure if the file cannot be opened
 */
 void Deck::load(const char fileName[])
 {
-	std::ifstream cardFile;
-	cardFile.open(fileName);
+	std::ifstream cardFile(fileName, std::ios::in | std::ios::binary);
 	if (!cardFile)
 		throw std::fstream::failure("File could not be opened");
 
-	std::string cardStr;
-	while (cardFile >> cardStr)
+	cardFile.seekg(0, std::ios::end);
+	std::streamoff length = cardFile.tellg();
+	cardFile.seekg(0, std::ios::beg);
+
+	std::vector<char> text(length > 0 ? (size_t)length : 0);
+	if (!text.empty())
+		cardFile.read(&text[0], text.size());
+	cardFile.close();
+
+	if (!text.empty())
+		parse(&text[0], (size_t)cardFile.gcount());
+}
+
+/*
+Pushes back every valid card in the first length chars of text, which
+holds card definition strings separated by whitespace.  Invalid strings
+are skipped, the same as in load().
+*/
+void Deck::parse(const char * text, size_t length)
+{
+	const char * end = text + length;
+	const char * pos = text;
+	while (pos < end)
 	{
-		Card card(cardStr);
+		while (pos < end && isspace((unsigned char)*pos))
+			pos++;
+
+		const char * tokenStart = pos;
+		while (pos < end && !isspace((unsigned char)*pos))
+			pos++;
+
+		if (pos == tokenStart)
+			break;
+
+		Card card(tokenStart, pos - tokenStart);
 		if ( (card.getRank() != BAD_RANK) && (card.getSuit() != BAD_SUIT) )
 			cards.push_back(card);
 	}
-
-	cardFile.close();
 }
 
 /*
@@ -80,13 +113,24 @@ void Deck::clear()
 	cards.clear();
 }
 
+/*
+Puts the cards in a uniformly random order with this Deck's own generator.
+*/
 void Deck::shuffle()
 {
-	int numTimes = rand();
-	for (int i = 0; i < numTimes % SHUFFLE_LIMIT; i++)
-	{
-		std::random_shuffle(cards.begin(), cards.end());
-	}
+	shuffle(rng);
+}
+
+/*
+Puts the cards in a uniformly random order with the next numbers from 
+the specified generator.  One pass is enough; the result depends only on 
+the cards' order beforehand and where the generator was started.
+*/
+void Deck::shuffle(CounterRng & numbers)
+{
+	PROFILE_COUNT("Deck::shuffle");
+	for (size_t i = cards.size(); i > 1; i--)
+		std::swap(cards[i - 1], cards[numbers.below((uint32_t)i)]);
 }
 
 int Deck::size() const
@@ -94,6 +138,14 @@ int Deck::size() const
 	return cards.size();
 }
 
+/*
+The nth card from the top.  n must be less than size().
+*/
+const Card & Deck::operator[] (size_t n) const
+{
+	return cards[n];
+}
+
 /*
 Returns true if there are duplicate cards in this deck.
 */
@@ -120,10 +172,10 @@ std::ostream & operator<< (std::ostream &out, Deck &deck)
 	out << '[';
 	for (int i = 0; i < (int)deck.cards.size() - 1; i++)
 	{
-		out << deck.cards[i].toString() << ", ";
+		out << deck.cards[i].toCStr() << ", ";
 	}
 	if (deck.cards.size() > 0)
-		out << deck.cards.back().toString(); // Last card has no comma or space
+		out << deck.cards.back().toCStr(); // Last card has no comma or space
 
 	out << ']';
 
@@ -131,9 +183,20 @@ std::ostream & operator<< (std::ostream &out, Deck &deck)
 }
 
 /*
-Re-initializes the pseudo-random number generator used by the shuffle()
+A seed that differs from run to run, from the system's random device 
+mixed with the time.
+*/
+uint64_t Deck::randomSeed()
+{
+	std::random_device device;
+	uint64_t seed = ((uint64_t)device() << 32) | device();
+	return seed ^ (uint64_t)time(0);
+}
+
+/*
+Starts the generator used by shuffle() somewhere new each run.
 */
 void Deck::reseed()
 {
-	srand((unsigned int)time(0));
+	rng.start(randomSeed(), 0, 0);
 }
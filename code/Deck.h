@@ -13,6 +13,7 @@ ostream insertion operator.
 
 #include "Card.h"
 #include "Hand.h"
+#include "CounterRng.h"
 #include <deque>
 
 class Deck
@@ -26,12 +27,16 @@ public:
 	void add_card(const Card & c);
 	void add_cards(const Deck & other);
 	void load(const char fileName[]);
+	void parse(const char * text, size_t length);
 	void clear();
 	void shuffle();
+	void shuffle(CounterRng & numbers);
 
 	// Info
 	int size() const;
+	const Card & operator[] (size_t n) const;
 	bool hasDuplicates() const;
+	static uint64_t randomSeed();
 
 	// Friends
 	friend std::ostream & operator<< (std::ostream &out, Deck & deck);
@@ -42,7 +47,7 @@ private:
 	void reseed();
 
 	std::deque<Card> cards;
-	static const int SHUFFLE_LIMIT = 100;
+	CounterRng rng;
 };
 
 #endif
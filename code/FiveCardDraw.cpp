@@ -9,11 +9,11 @@ Defines all necessary functions for making a game of five card draw.
 #include "StdAfx.h"
 #include "FiveCardDraw.h"
 #include "GameException.h"
+#include "Profiler.h"
 #include "utils.h"
 #include "ndebug.h"
 
 #include <iostream>
-#include <sstream>
 #include <fstream>
 #include <set>
 #include <algorithm>
@@ -33,22 +33,23 @@ FiveCardDraw::FiveCardDraw()
 
 /*
 Runs the game until all players leave or there is an error.  
-Calls stop_game() automatically.
+Calls finish() automatically.
 */
 void FiveCardDraw::play()
 {
 	addPlayersPrompt();
 
 	try{ while (true) {
-		cout << endl;
+		screen.present(); // Each round is a frame
+		screen.at(NORMAL) << '\n';
 		if (players.size() == 0)
 		{
-			cout << "There are no more players in the game.  Stopping..." << endl;
-			stop_game();
+			screen.at(QUIET) << "There are no more players in the game.  Stopping...\n";
+			finish();
 			break;
 		}
 
-		int winner = before_round();
+		int winner = FiveCardDraw::before_round();
 		if (winner)
 		{
 			earlyWin();
@@ -56,8 +57,8 @@ void FiveCardDraw::play()
 			continue;
 		}
 
-		cout << endl;
-		winner = round();
+		screen.at(NORMAL) << '\n';
+		winner = FiveCardDraw::round();
 		if (winner)
 		{
 			earlyWin();
@@ -65,63 +66,81 @@ void FiveCardDraw::play()
 			continue;
 		}
 
-		cout << endl;
-		after_round();
+		screen.at(NORMAL) << '\n';
+		FiveCardDraw::after_round();
 	}}
 	catch (GameException e)
 	{
-		cout << "Oh dear - " << e.what() << endl;
-		cout << "The game ran into a problem.  Stopping..." << endl;
-		stop_game();
+		screen.at(QUIET) << "Oh dear - " << e.what() << '\n';
+		screen.at(QUIET) << "The game ran into a problem.  Stopping...\n";
+		finish();
 	}
 }
 
 /*
 Prompts a Player to select Cards to discard from his/her Hand; 
-these Cards will go into the discard Deck.
+these Cards will go into the discard Deck.  The selection is built in 
+the round's arena, and the line is parsed in place.  The arena is only 
+active while a line is parsed: under a TableServer, readLine() suspends 
+this table, and other tables run on the same thread in the meantime.
 
 Returns 0 on success.
 */
 int FiveCardDraw::before_turn(Player & p)
 {
-	cout << p.name << ": " << p.hand << endl;
-	set<size_t> toDiscard;
+	if (screen.shows(NORMAL))
+	{
+		screen.at(NORMAL) << p.name << ": ";
+		printHand(p, true);
+		screen.at(NORMAL) << '\n';
+	}
+	set<size_t, less<size_t>, ArenaAllocator<size_t>> toDiscard;
 	string s;
-	istringstream line;
+	bool valid = false;
 
-	cout << "Select cards to discard by typing their position numbers, separated by spaces." << endl;
-	while (!line.eof()) // Prompt until we get through a line without failing
+	screen.at(NORMAL) << "Select cards to discard by typing their position numbers, separated by spaces.\n";
+	while (!valid) // Prompt until we get through a line without failing
 	{
 		toDiscard.clear();
-		getline(cin, s);
-		line.str(s);
-		unsigned int i = 0;
+		readLine(s, &p); // Discards nothing if the input has run out
+		RoundArena::Scope scope(roundArena);
+		valid = true;
 
-		while (line.peek() != EOF)
+		size_t pos = 0;
+		while (pos < s.length())
 		{
-			if (isspace(line.peek()))
+			if (isspace(s[pos]))
 			{
-				line.get();
+				pos++;
 				continue;
 			}
 
-			line >> i;
-			if ( (!line) || (i < 1) || (i > Hand::POKER_HAND_SIZE) )
+			size_t start = pos;
+			size_t i = 0;
+			while (pos < s.length() && isdigit(s[pos]))
+			{
+				if (i <= Hand::POKER_HAND_SIZE) // Any more digits can't make it valid
+					i = i * 10 + (s[pos] - '0');
+				pos++;
+			}
+
+			bool endOfNumber = (pos == s.length() || isspace(s[pos]));
+			if ( (pos == start) || (!endOfNumber) || (i < 1) || (i > Hand::POKER_HAND_SIZE) )
 			{
-				cout << "Type numbers between 1 and " << Hand::POKER_HAND_SIZE << " only." << endl;
-				line.clear(); // So line.eof() will be false and the loop will continue
+				screen.at(NORMAL) << "Type numbers between 1 and " << Hand::POKER_HAND_SIZE << " only.\n";
+				valid = false;
 				break;
 			}
 			if (!toDiscard.insert(i).second) // try to insert i, and if already seen before...
 			{
-				cout << "You have duplicate numbers." << endl;
-				line.clear();
+				screen.at(NORMAL) << "You have duplicate numbers.\n";
+				valid = false;
 				break;
 			}
 		}
 	}
 
-	for (set<size_t>::reverse_iterator iter = toDiscard.rbegin(); iter != toDiscard.rend(); iter++)
+	for (set<size_t, less<size_t>, ArenaAllocator<size_t>>::reverse_iterator iter = toDiscard.rbegin(); iter != toDiscard.rend(); iter++)
 	{
 		discard.add_card(p.hand[*iter - 1]);
 		p.hand.remove_card(*iter - 1);
@@ -131,7 +150,8 @@ int FiveCardDraw::before_turn(Player & p)
 }
 
 /*
-Deal a Player's Hand as many cards as needed to have five Cards in his/her Hand.  
+Deal a Player's Hand as many cards as needed to have five Cards in his/her Hand, 
+face down, as the Player's own cards always are in this game.  
 
 Returns 0 on success.  
 
@@ -142,11 +162,12 @@ int FiveCardDraw::turn(Player & p)
 	for (unsigned int i = p.hand.size(); i < Hand::POKER_HAND_SIZE; i++)
 	{
 		if (deck.size())
-			p.hand << deck;
+			p.hand.add_card(deck, true);
 		else if (discard.size())
 		{
-			discard.shuffle();
-			p.hand << discard;
+			if (!scenario)
+				discard.shuffle(dealRng); // Scenarios stay predetermined
+			p.hand.add_card(discard, true);
 		}
 		else
 			throw GameException("Ran out of cards in main and discard decks");
@@ -162,18 +183,24 @@ Returns 0 on success.
 */
 int FiveCardDraw::after_turn(Player & p)
 {
+	if (!screen.shows(NORMAL))
+		return 0;
+
 	if (p.inRound)
-		cout << p.name << ": " << p.hand;
+	{
+		screen.at(NORMAL) << p.name << ": ";
+		printHand(p, true);
+	}
 	else
-		cout << p.name << ": [folded]";
+		screen.at(NORMAL) << p.name << ": [folded]";
 
 	return 0;
 }
 
 /*
-Shuffles the deck.  Collects ante.  Then, starting with the Player 
-just past the dealer position, deals five-Card Hands to everybody 
-in the game.  Performs a round of betting.  Finally, has each Player 
+Shuffles the deck, or takes the next deal from the scenario.  Collects 
+ante.  Then, starting with the Player just past the dealer position, 
+deals five-Card Hands to everybody in the game.  Performs a round of betting.  Finally, has each Player 
 discard cards with before_turn().  
 
 Returns 0 on success.  
@@ -183,7 +210,8 @@ Throws GameException if the deck runs out of cards.
 */
 int FiveCardDraw::before_round()
 {
-	deck.shuffle();
+	PROFILE_PHASE("before_round");
+	prepareDeck();
 
 	if (players.size() == 0)
 		return 0;
@@ -203,7 +231,7 @@ int FiveCardDraw::before_round()
 			playerNum++;
 			if (playerNum >= players.size())
 				playerNum = 0;
-			players[playerNum]->hand << deck;
+			players[playerNum]->hand.add_card(deck, true);
 
 		} while (playerNum != dealerPos);
 	}
@@ -225,7 +253,7 @@ int FiveCardDraw::before_round()
 			playerNum = 0;
 
 		if (players[playerNum]->inRound)
-			before_turn(*(players[playerNum]));
+			FiveCardDraw::before_turn(*(players[playerNum]));
 
 	} while (playerNum != dealerPos);
 
@@ -243,6 +271,7 @@ Throws GameException: lets them propagate onward from turn().
 */
 int FiveCardDraw::round()
 {
+	PROFILE_PHASE("round");
 	if (players.size() == 0)
 		return 0;
 
@@ -253,14 +282,14 @@ int FiveCardDraw::round()
 		if (playerNum >= players.size())
 			playerNum = 0;
 
-		turn(*(players[playerNum])); // Restore five-card hands
+		FiveCardDraw::turn(*(players[playerNum])); // Restore five-card hands
 	} while (playerNum != dealerPos);
 
 	collectBets();
 	if (playersInRound == 1)
 		return EARLY_WINNER;
 
-	cout << endl;
+	screen.at(NORMAL) << '\n';
 
 	playerNum = dealerPos;
 	do
@@ -269,8 +298,8 @@ int FiveCardDraw::round()
 		if (playerNum >= players.size())
 			playerNum = 0;
 
-		after_turn(*(players[playerNum])); // Print info
-		cout << endl;
+		FiveCardDraw::after_turn(*(players[playerNum])); // Print info
+		screen.at(NORMAL) << '\n';
 	} while (playerNum != dealerPos);
 
 	return 0;
@@ -284,6 +313,7 @@ Returns 0 on success.
 */
 int FiveCardDraw::after_round()
 {
+	PROFILE_PHASE("after_round");
 	if (players.size() == 0)
 		return 0;
 
@@ -311,11 +341,11 @@ int FiveCardDraw::after_round()
 			break;
 	}
 
-	awardWinners(winners);
-
 	for (unsigned int i = winners.size(); i < bestHands.size(); i++)
 		bestHands[i]->losses++;
 
+	awardWinners(winners); // Last, since it saves every Player
+
 	printStatsAndHands();
 	cleanup();
 
@@ -323,14 +353,15 @@ int FiveCardDraw::after_round()
 }
 
 /*
-Moves all cards back to the main deck.  Prompts to remove and add players.  
-Increments the dealer position.
+Moves all cards back to the main deck and releases the round's temporaries.  
+Prompts to remove and add players.  Increments the dealer position.
 */
 void FiveCardDraw::cleanup()
 {
 	deck.add_cards(discard);
 	discard.clear();
 	allHandsToDeck();
+	roundArena.reset();
 
 	removePlayersPrompt();
 	addPlayersPrompt();
@@ -339,3 +370,20 @@ void FiveCardDraw::cleanup()
 	if (dealerPos >= players.size())
 		dealerPos = 0;
 }
+
+/*
+Saves the discards, in order, so that reshuffling them deals the same way.
+*/
+void FiveCardDraw::snapshotTableCards(GameSnapshot & out) const
+{
+	out.numDiscards = (unsigned char)discard.size();
+	for (int i = 0; i < discard.size(); i++)
+		out.discards[i] = (unsigned char)discard[i].toIndex();
+}
+
+void FiveCardDraw::restoreTableCards(const GameSnapshot & in)
+{
+	discard.clear();
+	for (size_t i = 0; i < in.numDiscards; i++)
+		discard.add_card(Card::fromIndex(in.discards[i]));
+}
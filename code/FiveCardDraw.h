@@ -32,6 +32,8 @@ public:
 
 protected:
 	void cleanup();
+	virtual void snapshotTableCards(GameSnapshot & out) const;
+	virtual void restoreTableCards(const GameSnapshot & in);
 	
 	Deck discard;
 };
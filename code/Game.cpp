@@ -13,17 +13,20 @@ Gives concrete definitions for everything in Game that is not pure virtual.
 #include "SevenCardStud.h"
 #include "TexasHoldEm.h"
 #include "utils.h"
+#include "Profiler.h"
 #include "ndebug.h"
 
 #include <iostream>
+#include <fstream>
 #include <sstream>
 #include <algorithm>
-#include <conio.h>
+#include <memory>
 #include <assert.h>
 
 using namespace std;
 
 Game * Game::gameInstance = 0;
+std::atomic<unsigned> Game::nextTableId(0);
 
 /*
 Returns the Game that's currently running.  
@@ -45,45 +48,126 @@ Game::~Game()
 {
 	for (unsigned int i = 0; i < players.size(); i++)
 	{
+		unseatPlayer(players[i]);
 		delete players[i];
 	}
+	delete scenario;
+	if (ownsHistory)
+		delete history; // Writes whatever is still buffered
 }
 
 /*
-Starts a Game with the specifed name.  
+Starts a Game with the specifed name, as the one running Game.  See create() 
+for the rest of the arguments.
 
-Throws GameException if there is no such Game, or if another 
-game is already in progess.
+Throws GameException if there is no such Game, if another game is 
+already in progess, or if the scenario or history file cannot be used.
 */
-void Game::start_game(const std::string & name)
+void Game::start_game(const std::string & name, const char scenarioFile[], const char historyFile[], Verbosity verbosity, 
+	InputSource * input)
 {
 	if (gameInstance)
 		throw GameException("A game is already running");
 
+	gameInstance = create(name, scenarioFile, historyFile, verbosity, input);
+}
+
+/*
+Makes a Game with the specified name that is not the running Game, so that 
+a server can host any number of them, each playing on its own thread.  The 
+caller deletes it once play() returns.  If scenarioFile is not null, 
+every round is dealt from that scenario file instead of shuffling.  If 
+historyFile is not null, every round is appended to that hand-history file; 
+otherwise, if sharedHistory is not null, every round is handed to that 
+writer, which must outlive the Game.  The Game prints only what verbosity 
+allows.  It reads from input, which must outlive it, or from the keyboard 
+if input is null.
+
+Throws GameException if there is no such Game, or if the scenario or 
+history file cannot be used.
+*/
+Game * Game::create(const std::string & name, const char scenarioFile[], const char historyFile[], Verbosity verbosity, 
+	InputSource * input, HistoryWriter * sharedHistory)
+{
+	Game * game;
+	ScenarioVariant variant;
+	const char * fullName;
 	if (name.find("FiveCardDraw") != std::string::npos) // Found a valid substring
 	{
-		gameInstance = new FiveCardDraw();
-		cout << "Starting a game of Five Card Draw..." << endl;
-		return;
+		game = new FiveCardDraw();
+		variant = SCENARIO_FIVE_CARD_DRAW;
+		fullName = "Five Card Draw";
 	}
 	else if (name.find("SevenCardStud") != std::string::npos)
 	{
-		gameInstance = new SevenCardStud();
-		cout << "Starting a game of Seven Card Stud..." << endl;
-		return;
+		game = new SevenCardStud();
+		variant = SCENARIO_SEVEN_CARD_STUD;
+		fullName = "Seven Card Stud";
 	}
 	else if (name.find("TexasHoldEm") != std::string::npos)
 	{
-		gameInstance = new TexasHoldEm();
-		cout << "Starting a game of Texas Hold 'Em..." << endl;
-		return;
+		game = new TexasHoldEm();
+		variant = SCENARIO_TEXAS_HOLD_EM;
+		fullName = "Texas Hold 'Em";
 	}
+	else
+		throw GameException("Unknown game");
+
+	game->screen.setVerbosity(verbosity);
+	if (input)
+		game->input = input;
+	game->screen.at(QUIET) << "Starting a game of " << fullName << "...\n";
+
+	try
+	{
+		if (scenarioFile)
+			game->useScenario(scenarioFile, variant);
+		if (historyFile)
+			game->recordHistory(historyFile, variant);
+		else if (sharedHistory)
+			game->shareHistory(sharedHistory, variant);
+	}
+	catch (GameException &)
+	{
+		delete game;
+		throw;
+	}
+
+	return game;
+}
+
+/*
+Sends each frame this Game prints to sink instead of standard output.  
+Must be called before play().
+*/
+void Game::setOutput(const Renderer::Sink & sink)
+{
+	screen.setSink(sink);
+}
+
+/*
+Shuffles every following round from seed instead of a random one, so 
+that the same seed and the same input play the same game.  Rounds are 
+counted from the first one this Game dealt.
+*/
+void Game::setSeed(uint64_t seed)
+{
+	shuffleSeed = seed;
+}
 
-	throw GameException("Unknown game");
+/*
+Called by play() when the Game is over.  Stops the Game if it is the 
+running Game, which deletes it; otherwise its owner deletes it.
+*/
+void Game::finish()
+{
+	if (this == gameInstance)
+		stop_game();
 }
 
 /*
-Stops (deletes) the currently running Game.  
+Stops (deletes) the currently running Game, and waits until every Player's 
+information is saved to disk.  Prints the profile, if profiling is compiled in.
 
 Throws GameException if no Game is running.
 */
@@ -94,6 +178,21 @@ void Game::stop_game()
 
 	delete gameInstance;
 	gameInstance = 0;
+
+	PersistenceService * service = persistence();
+	if (service)
+	{
+		try
+		{
+			service->flush();
+		}
+		catch (std::fstream::failure & e)
+		{
+			cerr << "WARNING: could not save players: " << e.what() << endl;
+		}
+	}
+
+	PROFILE_REPORT(cout);
 }
 
 unsigned int Game::getNumPlayers() const
@@ -102,25 +201,35 @@ unsigned int Game::getNumPlayers() const
 }
 
 /*
-Adds a Player with the specified name to the Game.  If the Player 
-has 0 chips, prompts to either reset chips or leave.
+Adds a Player with the specified name to the Game, loading the Player's 
+wins, losses and chips from the player store.  If the Player has 0 chips, 
+prompts to either reset chips or leave.
 
-Throws GameException if the Player is already in the Game or if the name 
-contains illegal characters.
+Throws GameException if the Player is already in this or any other Game, 
+or if the name contains illegal characters or is too long to save.
 
-Complexity: n
+Complexity: constant
 */
 void Game::add_player(const std::string & name)
 {
 	if (hasIllegalChar(name))
 		throw GameException("Names may not contain the characters " + illegalChars);
+	if (name.length() > PlayerStore::MAX_NAME_LENGTH)
+		throw GameException("Names may not be longer than " + to_string((unsigned long long)PlayerStore::MAX_NAME_LENGTH) + " characters");
 	
-	Player * p = find_player(name);
+	Player * p = new Player(name.c_str());
+	try
+	{
+		seatPlayer(p);
+	}
+	catch (GameException &)
+	{
+		delete p;
+		throw;
+	}
 
-	if (p)
-		throw GameException(p->name + " is already playing!");
-	
-	p = new Player(name.c_str());
+	if (playerStore())
+		persistence()->load(name, *p); // Sees the Player's last save even if it is still on its way to the store
 	bool staying = true;
 	if (p->chips == 0)
 		staying = handle0Chips(p);
@@ -128,19 +237,23 @@ void Game::add_player(const std::string & name)
 	if (staying)
 	{
 		players.push_back(p);
-		cout << p->name << " joined the game." << endl;
+		screen.at(QUIET) << p->name << " joined the game.\n";
 	}
 	else
+	{
+		unseatPlayer(p);
 		delete p;
+	}
 }
 
 void Game::add_player(Player * const p)
 {
 	if (hasIllegalChar(p->name))
 		throw GameException("Names may not contain the characters " + illegalChars);
+	if (p->name.length() > PlayerStore::MAX_NAME_LENGTH)
+		throw GameException("Names may not be longer than " + to_string((unsigned long long)PlayerStore::MAX_NAME_LENGTH) + " characters");
 
-	if (find_player(p->name))
-		throw GameException(p->name + " is already playing");
+	seatPlayer(p); // Throws GameException if already playing
 
 	bool staying = true;
 	if (p->chips == 0)
@@ -149,14 +262,16 @@ void Game::add_player(Player * const p)
 	if (staying)
 	{
 		players.push_back(p);
-		cout << p->name << " joined the game." << endl;
+		screen.at(QUIET) << p->name << " joined the game.\n";
 	}
+	else
+		unseatPlayer(p);
 }
 
 /*
 Removes a Player with the specified name from the game.  
 If the Player does not exist, does nothing.
-Also tries to save Player information to a file with the same name as the Player.
+Also saves the Player's information to the player store.
 */
 void Game::remove_player(const std::string & name)
 {
@@ -164,32 +279,25 @@ void Game::remove_player(const std::string & name)
 
 	if (p)
 	{
-		int error = p->saveToFile();
-		if (error)
-		{
-			cout << "WARNING: could not save " << name << "'s info." << endl;
-		}
-
-		cout << p->name << " left the game." << endl;
+		savePlayer(p);
+		unseatPlayer(p);
+		screen.at(QUIET) << p->name << " left the game.\n";
 		delete p;
 		players.erase(std::find(players.begin(),players.end(),p));
 	}
 }
 
 /*
-Removes the nth Player from the Game.  
+Removes the nth Player from the Game, saving the Player's information.  
 Throws out_of_range if there is no such Player.
 */
 void Game::remove_player(size_t n)
 {
 	Player * leaving = players[n]; // Throws out_of_range
-	int error = leaving->saveToFile();
-	if (error)
-	{
-		cout << "WARNING: could not save " << leaving->name << "'s info." << endl;
-	}
+	savePlayer(leaving);
+	unseatPlayer(leaving);
 
-	cout << leaving->name << " left the game." << endl;
+	screen.at(QUIET) << leaving->name << " left the game.\n";
 	delete leaving;
 	players.erase(players.begin()+n);
 }
@@ -198,19 +306,39 @@ void Game::remove_player(size_t n)
 Finds a Player with the specified name in the Game (case insensitive).  Returns 
 a null pointer if there is no such player.  
 
-Complexity: n
+Complexity: constant
 */
 Player * Game::find_player(const std::string & find) const
 {
-	for (unsigned int i = 0; i < players.size(); i++)
-	{
-		if (strComp_ignoreCase(players[i]->name, find) == 0)
-			return players[i];
-	}
+	PlayerLocation location;
+	if (PlayerRegistry::global().find(PlayerRegistry::Key(find), location) && location.tableId == tableId)
+		return location.player;
 
 	return 0;
 }
 
+/*
+Records in the PlayerRegistry that p is at this Game.
+
+Throws GameException if a Player by that name is at this or any other Game.
+*/
+void Game::seatPlayer(Player * p)
+{
+	PlayerRegistry::Key key(p->name);
+	if (PlayerRegistry::global().add(key, p, tableId))
+		return;
+
+	PlayerLocation location;
+	if (PlayerRegistry::global().find(key, location) && location.tableId == tableId)
+		throw GameException(location.player->name + " is already playing!");
+	throw GameException(p->name + " is already playing at another table!");
+}
+
+void Game::unseatPlayer(Player * p)
+{
+	PlayerRegistry::global().remove(PlayerRegistry::Key(p->name), p);
+}
+
 /*
 Deducts one chip from each Player, adding them to the pot.
 */
@@ -220,6 +348,8 @@ void Game::collectAnte()
 	{
 		assert(players[i]->chips > 0);
 		players[i]->chips--;
+		if (history)
+			currentHand.addAction(street, i, ACTION_ANTE, 1, pot + i + 1);
 	}
 	pot += players.size();
 }
@@ -232,6 +362,9 @@ void Game::collectBets()
 	if (players.size() == 0)
 		return;
 
+	PROFILE_PHASE_INDEXED("collectBets", street);
+	street++;
+
 	size_t finalResponder = dealerPos;
 	size_t playerNum = dealerPos;
 	bool betMade = false;
@@ -247,6 +380,8 @@ void Game::collectBets()
 		if (!p->inRound || p->chips == 0)
 			continue;
 
+		ChipAmt chipsBefore = p->chips;
+		HandAction action = ACTION_CHECK;
 		if (betMade)
 		{
 			char choice = callRaiseFoldPrompt(p, bet - p->amtPaid);
@@ -254,11 +389,13 @@ void Game::collectBets()
 			{
 			case CALL:
 				handleCall(p, bet);
+				action = ACTION_CALL;
 				break;
 
 			case RAISE: // callRaiseFold() allows raise iff player has enough
 				handleCall(p, bet);
 				bet += handleBet(p);
+				action = ACTION_RAISE;
 
 				if (playerNum == 0) // Set finalResponder to be the player immediately before
 					finalResponder = players.size() - 1;
@@ -269,6 +406,7 @@ void Game::collectBets()
 			case FOLD:
 				p->inRound = false;
 				playersInRound--;
+				action = ACTION_FOLD;
 				break;
 			}
 		}
@@ -279,6 +417,7 @@ void Game::collectBets()
 			{
 				betMade = true;
 				bet = handleBet(p);
+				action = ACTION_BET;
 
 				if (playerNum == 0)// Set finalResponder to be the player immediately before
 					finalResponder = players.size() - 1;
@@ -288,6 +427,9 @@ void Game::collectBets()
 			// Check: do nothing
 		}
 
+		if (history)
+			currentHand.addAction(street - 1, playerNum, action, chipsBefore - p->chips, pot);
+
 	} while (playerNum != finalResponder);
 
 	for (size_t i = 0; i < players.size(); i++)
@@ -325,10 +467,16 @@ void Game::earlyWin()
 
 	Player * winner = players[winnerNum];
 	assert(winner->inRound);
-	cout << winner->name << " wins pot of " << pot << "!" << endl;
+	screen.at(QUIET) << winner->name << " wins pot of " << pot << "!\n";
 	winner->wins++;
 	winner->chips += pot;
+	if (history)
+	{
+		currentHand.addWinner(winnerNum, pot);
+		finishHistory();
+	}
 	pot = 0;
+	saveAllPlayers();
 }
 
 /*
@@ -341,24 +489,51 @@ void Game::awardWinners(vector<Player *> & winners)
 
 	if (winners.size() == 1)
 	{
-		cout << winners[0]->name << " wins pot of " << pot << " with a " << winners[0]->hand.getStrRank() << "!" << endl;
+		if (screen.shows(QUIET))
+			screen.at(QUIET) << winners[0]->name << " wins pot of " << pot << " with a " << winners[0]->hand.getStrRank() << "!\n";
 		winners[0]->wins++;
 		winners[0]->chips += pot;
+		if (history)
+		{
+			size_t seat = std::find(players.begin(), players.end(), winners[0]) - players.begin();
+			currentHand.addWinner(seat, pot);
+		}
 		pot = 0;
 	}
 	else // Tie
 	{
+		ostream & out = screen.at(QUIET);
 		for (unsigned int i = 0; i < winners.size() - 1; i++)
 		{
-			cout << winners[i]->name << " and ";
+			out << winners[i]->name << " and ";
 			winners[i]->wins++;
 		}
-		cout << winners.back()->name;
+		out << winners.back()->name;
 		winners.back()->wins++;
-		cout << " tie with a " << winners[0]->hand.getStrRank() << "!" << endl;
-		cout << "They split a pot of " << pot << '.' << endl;
+		if (screen.shows(QUIET))
+			out << " tie with a " << winners[0]->hand.getStrRank() << "!\n";
+		out << "They split a pot of " << pot << ".\n";
+
+		vector<ChipAmt> chipsBefore;
+		if (history)
+		{
+			for (size_t i = 0; i < winners.size(); i++)
+				chipsBefore.push_back(winners[i]->chips);
+		}
 		dividePot(winners.begin(), winners.end());
+		if (history)
+		{
+			for (size_t i = 0; i < winners.size(); i++)
+			{
+				size_t seat = std::find(players.begin(), players.end(), winners[i]) - players.begin();
+				currentHand.addWinner(seat, winners[i]->chips - chipsBefore[i]);
+			}
+		}
 	}
+
+	if (history)
+		finishHistory();
+	saveAllPlayers();
 }
 
 /*
@@ -394,15 +569,30 @@ Prints player stats and non-folded hands.
 */
 void Game::printStatsAndHands()
 {
+	if (!screen.shows(NORMAL))
+		return;
+
+	ostream & out = screen.at(NORMAL);
 	for (unsigned int i = 0; i < players.size(); i++)
 	{
 		if (players[i]->inRound)
-			cout << *players[i] << " | " << players[i]->hand << endl;
+			out << *players[i] << " | " << players[i]->hand << '\n';
 		else
-			cout << *players[i] << " | " << "[folded]" << endl;
+			out << *players[i] << " | " << "[folded]" << '\n';
 	}
 }
 
+/*
+Prints p's hand, which only p may see all of.  Everybody else sees it with 
+its face-down cards hidden.  On standard output, which every Player 
+shares, it is shown in full if showFull, as when p is about to decide.
+*/
+void Game::printHand(const Player & p, bool showFull)
+{
+	if (screen.shows(NORMAL))
+		screen.secret(NORMAL, p.name, p.hand.toString(), p.hand.toString_hideFaceDown(), showFull);
+}
+
 /*
 Removes all players that the user wishes to remove.  Then, prompts all Players with 
 0 chips to either reset chips or leave.
@@ -412,17 +602,17 @@ void Game::removePlayersPrompt()
 	if (players.size() == 0)
 		return;
 
-	cout << "Do any players wish to leave the game?  Enter a name, or nothing if not: ";
+	screen.at(NORMAL) << "Do any players wish to leave the game?  Enter a name, or nothing if not: ";
 	string name;
-	getline(cin, name);
+	readLine(name);
 	while (name.length() > 0)
 	{
 		remove_player(name);
 		if (players.size() == 0)
 			return;
 
-		cout << "Any more leavers?  Enter a name, or nothing if not: ";
-		getline(cin, name);
+		screen.at(NORMAL) << "Any more leavers?  Enter a name, or nothing if not: ";
+		readLine(name);
 	}
 
 	for (unsigned int i = 0; i < players.size(); i++)
@@ -440,25 +630,25 @@ void Game::addPlayersPrompt()
 	if (players.size() >= MAX_PLAYERS)
 		return;
 
-	cout << "Do any players wish to join the game?  Enter a name, or nothing if not: ";
+	screen.at(NORMAL) << "Do any players wish to join the game?  Enter a name, or nothing if not: ";
 	string name;
-	getline(cin, name);
+	readLine(name);
 	while (name.length() > 0)
 	{
 		try { add_player(name); }
 		catch (GameException e)
 		{
-			cout << "Did not add player: " << e.what() << endl;
+			screen.at(QUIET) << "Did not add player: " << e.what() << '\n';
 		}
 
 		if (players.size() == MAX_PLAYERS)
 		{
-			cout << "The game is now full with " << MAX_PLAYERS << " players." << endl;
+			screen.at(NORMAL) << "The game is now full with " << MAX_PLAYERS << " players.\n";
 			break;
 		}
 
-		cout << "Any more joiners?  Enter a name, or nothing if not: ";
-		getline(cin, name);
+		screen.at(NORMAL) << "Any more joiners?  Enter a name, or nothing if not: ";
+		readLine(name);
 	}
 }
 
@@ -486,64 +676,358 @@ there is no limit.
 */
 Game::Game(size_t deckSize, size_t maxPlayers)
 	: deck(Deck()), players(std::vector<Player *>()), playersInRound(0), dealerPos(0),
-	pot(0), DECK_SIZE(deckSize), MAX_PLAYERS( (maxPlayers == 0 ? -1 : maxPlayers) ) {}
+	street(0), pot(0), scenario(0), history(0), ownsHistory(false), handsPlayed(0), shuffleSeed(Deck::randomSeed()), handsDealt(0), tableId(nextTableId++), input(&InputSource::terminal()), DECK_SIZE(deckSize), MAX_PLAYERS( (maxPlayers == 0 ? -1 : maxPlayers) ) {}
 
 /*
-Replaces the deck with a standard 52-card deck.
+Deals every round from the specified scenario file instead of shuffling.
+
+Throws GameException if the file cannot be read or is for another variant.
 */
-void Game::standardDeck()
+void Game::useScenario(const char fileName[], ScenarioVariant variant)
 {
-	for (int rank = LOWEST_RANK; rank <= HIGHEST_RANK; rank++)
+	ScenarioReader * reader;
+	try
 	{
-		deck.add_card( Card((CardRank)rank, CLUBS) );
-		deck.add_card( Card((CardRank)rank, DIAMONDS) );
-		deck.add_card( Card((CardRank)rank, SPADES) );
-		deck.add_card( Card((CardRank)rank, HEARTS) );
+		reader = new ScenarioReader(fileName);
+	}
+	catch (std::fstream::failure & e)
+	{
+		throw GameException(std::string("Could not use scenario: ") + e.what());
+	}
+
+	if (reader->getVariant() != SCENARIO_ANY && reader->getVariant() != variant)
+	{
+		delete reader;
+		throw GameException("Scenario is for a different game");
 	}
+
+	delete scenario;
+	scenario = reader;
 }
 
 /*
-Has all players be in the round (i.e. not folded).
+Gets the deck ready for a round: shuffles a standard deck, or, if a 
+scenario is in use, replaces it with the scenario's next deal.  The 
+shuffle for round n depends only on the seed, tableId, and n, and the 
+rest of the round's random numbers (see FiveCardDraw's discards) follow 
+it in dealRng.
+
+Throws GameException if the scenario has no deals left or is corrupt.
 */
-void Game::allJoinRound()
+void Game::prepareDeck()
 {
-	playersInRound = players.size();
+	if (!scenario)
+	{
+		deck.clear();
+		standardDeck();
+		dealRng.start(shuffleSeed, tableId, handsDealt++);
+		deck.shuffle(dealRng);
+		return;
+	}
+
+	try
+	{
+		if (!scenario->nextDeal(deck))
+			throw GameException("The scenario has no more deals");
+	}
+	catch (std::fstream::failure & e)
+	{
+		throw GameException(e.what());
+	}
+}
+
+/*
+Appends every round played from now on to the specified hand-history file.
+
+Throws GameException if the file cannot be opened.
+*/
+void Game::recordHistory(const char fileName[], ScenarioVariant variant)
+{
+	HistoryWriter * writer;
+	try
+	{
+		writer = new HistoryWriter(fileName);
+	}
+	catch (std::fstream::failure & e)
+	{
+		throw GameException(std::string("Could not record history: ") + e.what());
+	}
+
+	if (ownsHistory)
+		delete history;
+	history = writer;
+	ownsHistory = true;
+	currentHand.variant = variant;
+	currentHand.tableId = tableId;
+}
+
+/*
+Hands every round played from now on to writer, which other Games may be 
+writing to as well.  The Game does not take ownership.
+*/
+void Game::shareHistory(HistoryWriter * writer, ScenarioVariant variant)
+{
+	if (ownsHistory)
+		delete history;
+	history = writer;
+	ownsHistory = false;
+	currentHand.variant = variant;
+	currentHand.tableId = tableId;
+}
+
+/*
+Fills in the end of the round's record (final chips, everyone's cards, the 
+board) and hands it to the history writer.  Call after the pot is awarded 
+and before cards go back to the deck.
+*/
+void Game::finishHistory()
+{
+	assert(history);
+	for (size_t i = 0; i < players.size() && i < currentHand.seats.size(); i++)
+	{
+		currentHand.seats[i].finalChips = players[i]->chips;
+		currentHand.seats[i].cards = players[i]->hand.toMask();
+	}
+	currentHand.board = communityCards();
+
+	history->submit(currentHand);
+	handsPlayed++;
+}
+
+/*
+The cards every player shares.  None, unless a derived Game has some.
+*/
+CardMask Game::communityCards() const
+{
+	return 0;
+}
+
+/*
+Saves the cards that are on the table but in no player's hand.  None, 
+unless a derived Game has some.
+*/
+void Game::snapshotTableCards(GameSnapshot & /* out */) const
+{
+}
+
+void Game::restoreTableCards(const GameSnapshot & /* in */)
+{
+}
+
+/*
+Saves the whole state of the table in out: every seat's chips, bets, 
+results and cards, the deck and any discards in order, the pot, the 
+dealer, and the generator the round's reshuffles come from.
+
+Throws GameException if there are more players than a snapshot holds.
+*/
+void Game::snapshot(GameSnapshot & out) const
+{
+	static_assert(TexasHoldEm::MAX_PLAYERS <= GameSnapshot::MAX_SEATS && FiveCardDraw::MAX_PLAYERS <= GameSnapshot::MAX_SEATS &&
+		SevenCardStud::MAX_PLAYERS <= GameSnapshot::MAX_SEATS, "GameSnapshot has too few seats");
+	if (players.size() > GameSnapshot::MAX_SEATS)
+		throw GameException("Too many players to take a snapshot");
+
+	out.numSeats = (unsigned char)players.size();
+	out.faceDown = 0;
 	for (size_t i = 0; i < players.size(); i++)
 	{
-		players[i]->inRound = true;
+		const Player & p = *players[i];
+		out.chips[i] = p.chips;
+		out.amtPaid[i] = p.amtPaid;
+		out.wins[i] = p.wins;
+		out.losses[i] = p.losses;
+		out.inRound[i] = p.inRound;
+		out.holeCards[i] = p.hand.toMask();
+		out.faceDown |= p.hand.faceDownMask();
 	}
+	out.dealerPos = (unsigned char)dealerPos;
+	out.playersInRound = (unsigned char)playersInRound;
+	out.street = (unsigned char)street;
+	out.pot = pot;
+
+	out.deckSize = (unsigned char)deck.size();
+	for (int i = 0; i < deck.size(); i++)
+		out.deck[i] = (unsigned char)deck[i].toIndex();
+	out.community = 0;
+	out.numDiscards = 0;
+	snapshotTableCards(out);
+	out.dealRng = dealRng;
+	out.handsDealt = handsDealt;
 }
 
 /*
-Starting with the player after the dealer position, performs 
-doWhat on each player.  If includeFolded, will also do it to players 
-that have folded.  
+Puts the table back exactly as it was when the snapshot was taken.  The 
+same players must still be seated, in the same order.
 
-Returns 0 on success.  Will stop and return doWhat's return value 
-if it is not 0.
+Throws invalid_argument if the snapshot has a different number of seats.
 */
-int Game::goAround(mem_fun1_t<int, Game, Player &> doWhat, bool includeFolded)
+void Game::restore(const GameSnapshot & in)
 {
-	if (players.size() == 0)
-		return 0;
+	if (in.numSeats != players.size())
+		throw std::invalid_argument("Snapshot has a different number of players");
 
-	size_t playerNum = dealerPos;
-	do
+	for (size_t i = 0; i < players.size(); i++)
 	{
-		playerNum++;
-		if (playerNum >= players.size())
-			playerNum = 0;
+		Player & p = *players[i];
+		p.chips = in.chips[i];
+		p.amtPaid = in.amtPaid[i];
+		p.wins = in.wins[i];
+		p.losses = in.losses[i];
+		p.inRound = in.inRound[i];
+		p.hand = Hand(in.holeCards[i], in.faceDown);
+	}
+	dealerPos = in.dealerPos;
+	playersInRound = in.playersInRound;
+	street = in.street;
+	pot = in.pot;
+
+	deck.clear();
+	for (size_t i = 0; i < in.deckSize; i++)
+		deck.add_card(Card::fromIndex(in.deck[i]));
+	restoreTableCards(in);
+	dealRng = in.dealRng;
+	handsDealt = in.handsDealt;
+}
 
-		if (!includeFolded && !players[playerNum]->inRound)
-			continue;
+/*
+Opens the player store, or returns 0 after printing a warning.
+*/
+static PlayerStore * openPlayerStore()
+{
+	try
+	{
+		return new PlayerStore();
+	}
+	catch (std::fstream::failure & e)
+	{
+		cerr << "WARNING: players will not be saved: " << e.what() << endl;
+		return 0;
+	}
+}
+
+/*
+The store that Players are loaded from and saved to, opened the first time 
+it is needed and kept until the program ends.  Returns 0 if it cannot be 
+opened.  Safe to call from any number of tables at once.
+*/
+PlayerStore * Game::playerStore()
+{
+	static unique_ptr<PlayerStore> store(openPlayerStore());
+	return store.get();
+}
+
+/*
+The service that saves Players to the player store in the background, 
+started the first time it is needed and kept until the program ends.  
+Returns 0 if there is no player store.
+*/
+PersistenceService * Game::persistence()
+{
+	PlayerStore * store = playerStore(); // First, so that the store outlives the service
+	static unique_ptr<PersistenceService> service(store ? new PersistenceService(*store) : 0);
+	return service.get();
+}
+
+/*
+Queues a Player's information to be saved.  Never waits for the disk.
+*/
+void Game::savePlayer(Player * p)
+{
+	PersistenceService * service = persistence();
+	if (service)
+		service->push(*p);
+	else
+		screen.at(QUIET) << "WARNING: could not save " << p->name << "'s info.\n";
+}
 
-		int error = doWhat(this, *(players[playerNum]));
-		if (error)
-			return error;
+/*
+Queues every Player's information to be saved; called once the pot has 
+been awarded, since every Player's chips, wins or losses have changed.
+*/
+void Game::saveAllPlayers()
+{
+	PersistenceService * service = persistence();
+	if (!service)
+		return;
 
-	} while (playerNum != dealerPos);
+	for (size_t i = 0; i < players.size(); i++)
+		service->push(*players[i]);
+}
 
-	return 0;
+/*
+Shows everything printed so far, then waits for a key from Player from, 
+or from anybody if from is 0.  Returns it upper-cased, after echoing it.
+
+Throws GameException if the input has run out.
+*/
+char Game::readKey(const Player * from)
+{
+	input->expect(from ? from->name : string());
+	screen.present();
+	int key = input->getKey();
+	if (key == InputSource::END)
+		throw GameException("Ran out of input");
+
+	char ans = (char)toupper(key);
+	screen.at(NORMAL) << ans << '\n';
+	return ans;
+}
+
+/*
+Shows everything printed so far, then waits for a line from Player from, 
+or from anybody if from is 0.  Returns false, with an empty line, if the 
+input has run out.
+*/
+bool Game::readLine(std::string & line, const Player * from)
+{
+	input->expect(from ? from->name : string());
+	screen.present();
+	if (input->getLine(line))
+		return true;
+
+	line.clear();
+	return false;
+}
+
+/*
+Replaces the deck with a standard 52-card deck.
+*/
+void Game::standardDeck()
+{
+	for (int rank = LOWEST_RANK; rank <= HIGHEST_RANK; rank++)
+	{
+		deck.add_card( Card((CardRank)rank, CLUBS) );
+		deck.add_card( Card((CardRank)rank, DIAMONDS) );
+		deck.add_card( Card((CardRank)rank, SPADES) );
+		deck.add_card( Card((CardRank)rank, HEARTS) );
+	}
+}
+
+/*
+Has all players be in the round (i.e. not folded), and starts counting 
+rounds of betting from zero.  Starts the round's history record, if any.
+*/
+void Game::allJoinRound()
+{
+	street = 0;
+	playersInRound = players.size();
+	for (size_t i = 0; i < players.size(); i++)
+	{
+		players[i]->inRound = true;
+	}
+
+	if (history)
+	{
+		currentHand.begin(players.size());
+		currentHand.dealerPos = (unsigned char)dealerPos;
+		currentHand.handNumber = handsPlayed;
+		for (size_t i = 0; i < players.size(); i++)
+		{
+			currentHand.seats[i].name = players[i]->name;
+			currentHand.seats[i].startChips = players[i]->chips;
+		}
+	}
 }
 
 /*
@@ -552,12 +1036,16 @@ Prints a Player's hand and chip balance, then prompts to either check or bet.
 char Game::checkBetPrompt(Player * p)
 {
 	char ans = '\0';
-	cout << p->name << ": " << p->hand << ", " << p->chips << " chips" << endl;
+	if (screen.shows(NORMAL))
+	{
+		screen.at(NORMAL) << p->name << ": ";
+		printHand(*p, true);
+		screen.at(NORMAL) << ", " << p->chips << " chips\n";
+	}
 	do
 	{
-		cout << "Check (" << (char)CHECK << ") or Bet (" << (char)BET << ")? ";
-		ans = toupper(_getch());
-		cout << ans << endl;
+		screen.at(NORMAL) << "Check (" << (char)CHECK << ") or Bet (" << (char)BET << ")? ";
+		ans = readKey(p);
 	} while (ans != CALL && ans != BET);
 
 	return ans;
@@ -574,15 +1062,19 @@ enough chips to raise.
 char Game::callRaiseFoldPrompt(Player * p, ChipAmt callAmt)
 {
 	char ans = '\0';
-	cout << p->name << ": " << p->hand << ", " << p->chips << " chips" << endl;
+	if (screen.shows(NORMAL))
+	{
+		screen.at(NORMAL) << p->name << ": ";
+		printHand(*p, true);
+		screen.at(NORMAL) << ", " << p->chips << " chips\n";
+	}
 
 	if (p->chips > callAmt)
 	{
 		do
 		{
-			cout << "Call " << callAmt << " (" << (char)CALL << "), Raise (" << (char)RAISE << "), or Fold (" << (char)FOLD << ")? ";
-			ans = toupper(_getch());
-			cout << ans << endl;
+			screen.at(NORMAL) << "Call " << callAmt << " (" << (char)CALL << "), Raise (" << (char)RAISE << "), or Fold (" << (char)FOLD << ")? ";
+			ans = readKey(p);
 		} while (ans != CALL && ans != RAISE && ans != FOLD);
 
 		return ans;
@@ -592,9 +1084,8 @@ char Game::callRaiseFoldPrompt(Player * p, ChipAmt callAmt)
 	{
 		do
 		{
-			cout << "All In (" << (char)ALL_IN << ") or Fold (" << (char)FOLD << ")? ";
-			ans = toupper(_getch());
-			cout << ans << endl;
+			screen.at(NORMAL) << "All In (" << (char)ALL_IN << ") or Fold (" << (char)FOLD << ")? ";
+			ans = readKey(p);
 		} while (ans != ALL_IN && ans != FOLD);
 
 		if (ans == ALL_IN) // Count an all-in as a call
@@ -626,10 +1117,11 @@ void Game::handleCall(Player * p, ChipAmt bet)
 }
 
 /*
-Prompts for a unsigned long between MIN_BET and "max"  
-Throws invalid_argument if "max" is lower than MIN_BET.
+Prompts Player p for a unsigned long between MIN_BET and "max"  
+Throws invalid_argument if "max" is lower than MIN_BET, and GameException if 
+the input runs out.
 */
-ChipAmt Game::getBet(ChipAmt max)
+ChipAmt Game::getBet(const Player * p, ChipAmt max)
 {
 	if (max < MIN_BET)
 	{
@@ -645,8 +1137,9 @@ ChipAmt Game::getBet(ChipAmt max)
 	while (true)
 	{
 		line.clear();
-		cout << "Enter amount between " << MIN_BET << " and " << max << ": ";
-		getline(cin, raw);
+		screen.at(NORMAL) << "Enter amount between " << MIN_BET << " and " << max << ": ";
+		if (!readLine(raw, p))
+			throw GameException("Ran out of input");
 		line.str(raw);
 		if (line >> amt)
 		{
@@ -672,9 +1165,9 @@ ChipAmt Game::handleBet(Player * p)
 
 	ChipAmt bet;
 	if (p->chips < MAX_BET)
-		bet = getBet(p->chips);
+		bet = getBet(p, p->chips);
 	else
-		bet = getBet();
+		bet = getBet(p);
 
 	p->chips -= bet;
 	p->amtPaid += bet;
@@ -711,9 +1204,8 @@ char Game::leaveResetPrompt(Player * p)
 	char ans = '\0';
 	do
 	{
-		cout << p->name << " has 0 chips.  Reset chips to 20 (" << RESET_CHIPS << ") or Leave (" << LEAVE << ")? ";
-		ans = toupper(_getch());
-		cout << ans << endl;
+		screen.at(NORMAL) << p->name << " has 0 chips.  Reset chips to 20 (" << RESET_CHIPS << ") or Leave (" << LEAVE << ")? ";
+		ans = readKey(p);
 	} while (ans != RESET_CHIPS && ans != LEAVE);
 
 	return ans;
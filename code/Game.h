@@ -4,7 +4,8 @@ Silas Hsu // hsu.silas@wustl.edu
 Last updated December 9, 2013
 
 An abstract class from which all poker games derive.  All Games 
-follow the Singleton paradigm.
+follow the Singleton paradigm, except those that a server makes with 
+create() to host many tables at once.
 */
 
 #ifndef GAME_H
@@ -12,9 +13,18 @@ follow the Singleton paradigm.
 
 #include "Player.h"
 #include "Deck.h"
+#include "RoundArena.h"
+#include "Scenario.h"
+#include "HandHistory.h"
+#include "PlayerStore.h"
+#include "PersistenceService.h"
+#include "PlayerRegistry.h"
+#include "Renderer.h"
+#include "InputSource.h"
+#include "GameSnapshot.h"
 
 #include <vector>
-#include <functional>
+#include <atomic>
 
 typedef unsigned long ChipAmt;
 
@@ -35,8 +45,13 @@ public:
 	virtual ~Game();
 
 	static std::string gameNamePrompt();
-	static void start_game(const std::string & name);
+	static void start_game(const std::string & name, const char scenarioFile[] = 0, const char historyFile[] = 0, 
+		Verbosity verbosity = NORMAL, InputSource * input = 0);
 	static void stop_game();
+	static Game * create(const std::string & name, const char scenarioFile[] = 0, const char historyFile[] = 0, 
+		Verbosity verbosity = NORMAL, InputSource * input = 0, HistoryWriter * sharedHistory = 0);
+	void setOutput(const Renderer::Sink & sink);
+	void setSeed(uint64_t seed);
 
 	// Player modification
 	unsigned int getNumPlayers() const;
@@ -46,6 +61,10 @@ public:
 	void remove_player(size_t n);
 	Player * find_player(const std::string & find) const;
 
+	// Saving and going back to the state of the table
+	void snapshot(GameSnapshot & out) const;
+	void restore(const GameSnapshot & in);
+
 	virtual void play() = 0;
 	virtual int before_turn(Player & p) = 0;
 	virtual int turn(Player & p) = 0;
@@ -54,12 +73,32 @@ public:
 	virtual int round() = 0;
 	virtual int after_round() = 0;
 
+	// Betting limits; also used by the headless Simulation
+	static const ChipAmt MIN_BET = 1;
+	static const ChipAmt MAX_BET = 2;
+
 protected:
 	Game(size_t deckSize, size_t maxPlayers);
 	void standardDeck();
+	void useScenario(const char fileName[], ScenarioVariant variant);
+	void prepareDeck();
+	void finish();
+	static PlayerStore * playerStore();
+	static PersistenceService * persistence();
+	void savePlayer(Player * p);
+	void saveAllPlayers();
+	void seatPlayer(Player * p);
+	void unseatPlayer(Player * p);
+	void recordHistory(const char fileName[], ScenarioVariant variant);
+	void shareHistory(HistoryWriter * writer, ScenarioVariant variant);
+	void finishHistory();
+	virtual CardMask communityCards() const;
+	virtual void snapshotTableCards(GameSnapshot & out) const;
+	virtual void restoreTableCards(const GameSnapshot & in);
 
 	void allJoinRound();
-	int goAround(std::mem_fun1_t<int, Game, Player &> doWhat, bool includeFolded = false);
+	template <class TurnFxn>
+	int goAround(TurnFxn doWhat, bool includeFolded = false);
 
 	void collectAnte();
 	void collectBets();
@@ -69,16 +108,32 @@ protected:
 	void dividePot(std::vector<Player *>::iterator beg, std::vector<Player *>::iterator end);
 
 	void printStatsAndHands();
+	void printHand(const Player & p, bool showFull);
 	void removePlayersPrompt();
 	void addPlayersPrompt();
 	void allHandsToDeck();
+	char readKey(const Player * from = 0);
+	bool readLine(std::string & line, const Player * from = 0);
 
 	static Game * gameInstance;
 	Deck deck;
 	std::vector<Player *> players;
 	size_t playersInRound;
 	size_t dealerPos;
+	size_t street; // Rounds of betting so far this round
 	ChipAmt pot;
+	RoundArena roundArena; // For temporaries that last one round; reset by cleanup()
+	ScenarioReader * scenario; // Predetermined deals, or 0 to shuffle
+	HistoryWriter * history; // Where finished rounds are logged, or 0
+	bool ownsHistory; // Whether history is deleted with this Game
+	HandRecord currentHand; // The round in progress, if history is on
+	unsigned long handsPlayed;
+	uint64_t shuffleSeed; // Round n is shuffled by CounterRng stream (shuffleSeed, tableId), position n
+	unsigned long handsDealt;
+	CounterRng dealRng; // The current round's numbers; started by prepareDeck()
+	const unsigned tableId; // Where PlayerRegistry says this Game's Players are
+	Renderer screen; // Everything this Game prints goes through here
+	InputSource * input; // Everything it reads; not owned
 
 	static const int OUT_OF_CARDS = 1;
 	static const int EARLY_WINNER = 2;
@@ -92,7 +147,7 @@ private:
 	char checkBetPrompt(Player * p);
 	char callRaiseFoldPrompt(Player * p, ChipAmt callAmt);
 	void handleCall(Player * p, ChipAmt bet);
-	ChipAmt getBet(ChipAmt max = MAX_BET);
+	ChipAmt getBet(const Player * p, ChipAmt max = MAX_BET);
 	ChipAmt handleBet(Player * p);
 	
 	bool handle0Chips(Player * p);
@@ -100,10 +155,44 @@ private:
 
 	const size_t DECK_SIZE;
 	const size_t MAX_PLAYERS;
-	static const ChipAmt MIN_BET = 1;
-	static const ChipAmt MAX_BET = 2;
+	static std::atomic<unsigned> nextTableId;
 	static const char LEAVE = 'L';
 	static const char RESET_CHIPS = 'R';
 };
 
+/*
+Starting with the player after the dealer position, performs 
+doWhat on each player.  If includeFolded, will also do it to players 
+that have folded.  doWhat is any callable taking a Player &; derived 
+Games pass a lambda that names their own turn function, so the call is 
+resolved at compile time instead of through the vtable.
+
+Returns 0 on success.  Will stop and return doWhat's return value 
+if it is not 0.
+*/
+template <class TurnFxn>
+int Game::goAround(TurnFxn doWhat, bool includeFolded)
+{
+	if (players.size() == 0)
+		return 0;
+
+	size_t playerNum = dealerPos;
+	do
+	{
+		playerNum++;
+		if (playerNum >= players.size())
+			playerNum = 0;
+
+		if (!includeFolded && !players[playerNum]->inRound)
+			continue;
+
+		int error = doWhat(*(players[playerNum]));
+		if (error)
+			return error;
+
+	} while (playerNum != dealerPos);
+
+	return 0;
+}
+
 #endif
@@ -0,0 +1,54 @@
+/*
+GameSnapshot.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Declares GameSnapshot, the full state of a Game's table in one flat,
+trivially copyable struct: seats, pot, everyone's cards, the deck in order,
+the discards in order, and the generator the round's shuffles come from.
+Game::snapshot() fills one in and Game::restore() puts the table back
+exactly as it was, so that a bot can play ahead from a position and then
+return to it.  Copying a snapshot is a single memcpy of under 1KB,
+with no heap memory and no pointers; branch on copies, not on the Game.
+
+Players themselves are not part of a snapshot: a snapshot can only be
+restored into the Game it came from, with the same players seated.
+*/
+
+#ifndef GAME_SNAPSHOT_H
+#define GAME_SNAPSHOT_H
+
+#include "Card.h"
+#include "CounterRng.h"
+
+typedef unsigned long ChipAmt;
+
+struct GameSnapshot
+{
+	static const size_t MAX_SEATS = 23; // Texas Hold 'Em's MAX_PLAYERS, the most of any Game
+
+	// Seats
+	ChipAmt chips[MAX_SEATS];
+	ChipAmt amtPaid[MAX_SEATS];
+	unsigned wins[MAX_SEATS];
+	unsigned losses[MAX_SEATS];
+	bool inRound[MAX_SEATS];
+	unsigned char numSeats;
+	unsigned char dealerPos;
+	unsigned char playersInRound;
+	unsigned char street;
+	ChipAmt pot;
+
+	// Cards
+	CardMask holeCards[MAX_SEATS];
+	CardMask faceDown; // Which hole cards are face down
+	CardMask community;
+	unsigned char deck[Card::NUM_CARDS]; // Undealt cards by Card::toIndex(), top first
+	unsigned char deckSize;
+	unsigned char discards[Card::NUM_CARDS]; // In the order they were discarded
+	unsigned char numDiscards;
+	CounterRng dealRng;
+	unsigned long handsDealt;
+};
+
+#endif
@@ -10,28 +10,47 @@ Implements all functions in the Hand class.
 
 #include "Hand.h"
 #include "Deck.h"
+#include "Profiler.h"
 #include "ndebug.h"
 
 #include <assert.h>
 #include <algorithm>
+#include <ostream>
 
 //                                            High card,    Pair,      Two pair,     Three of a kind, Straight,    Flush,        Full house,     Four of a kind, Straight flush
-const pokerRankFxnPtr Hand::rankingFxns[9] = {&compInOrder, &compPair, &compTwoPair, &compThreeKind, &compInOrder, &compInOrder, &compFullHouse, &compFourKind, &compInOrder};
+const pokerRankFxnPtr Hand::rankingFxns[9] = {&compInOrder, &compPair, &compTwoPair, &compThreeKind, &compStraight, &compInOrder, &compFullHouse, &compFourKind, &compStraight};
 
 /*
 Constructs an empty Hand.
 */
-Hand::Hand() : cards(std::list<Card>()), rank(UNKNOWN) {}
+Hand::Hand() : cards(CardList()), rank(UNKNOWN) {}
 
 /*
 Extends a list of Cards into a Hand.
 */
 Hand::Hand(std::list<Card> list)
-	: cards(list), rank(UNKNOWN)
+	: cards(list.begin(), list.end()), rank(UNKNOWN)
 {
 	cards.sort();
 }
 
+/*
+Makes a Hand out of every card in the mask, face down if it is also in 
+faceDown.  Cards come out of the mask already in sorted order.
+*/
+Hand::Hand(CardMask mask, CardMask faceDown)
+	: cards(CardList()), rank(UNKNOWN)
+{
+	for (int index = 0; mask != 0; index++, mask >>= 1, faceDown >>= 1)
+	{
+		if (mask & 1)
+		{
+			cards.push_back(Card::fromIndex(index));
+			cards.back().faceDown = (faceDown & 1) != 0;
+		}
+	}
+}
+
 Hand::Hand(const Hand & other)
 {
 	cards = other.cards;
@@ -56,7 +75,7 @@ sorted order.  Invalidates any rank the Hand may have had.
 */
 void Hand::add_card(Card & c)
 {
-	std::list<Card>::const_iterator iter = cards.begin();
+	CardList::const_iterator iter = cards.begin();
 	while (iter != cards.end() && *iter < c)
 	{
 		iter++;
@@ -82,7 +101,7 @@ void Hand::add_card(Deck & deck, bool isfaceDown)
 	c.faceDown = isfaceDown;
 	deck.cards.pop_front();
 
-	std::list<Card>::const_iterator iter = cards.begin();
+	CardList::const_iterator iter = cards.begin();
 	while (iter != cards.end() && *iter < c)
 	{
 		iter++;
@@ -102,7 +121,7 @@ Card Hand::remove_card(size_t n)
 		throw std::out_of_range("Index out of bounds");
 
 	int pos = 0;
-	for (std::list<Card>::iterator iter = cards.begin(); iter != cards.end(); iter++)
+	for (CardList::iterator iter = cards.begin(); iter != cards.end(); iter++)
 	{
 		if (pos == n)
 		{
@@ -145,8 +164,8 @@ Compares the order of the cards in the hands lexicographically.
 */
 bool Hand::operator< (const Hand & other) const
 {
-	std::list<Card>::const_iterator thisIter = cards.begin();
-	std::list<Card>::const_iterator otherIter = other.cards.begin();
+	CardList::const_iterator thisIter = cards.begin();
+	CardList::const_iterator otherIter = other.cards.begin();
 
 	if (this->cards.size() < other.cards.size())
 	{
@@ -188,13 +207,40 @@ int Hand::size() const
 	return cards.size();
 }
 
+/*
+Returns a mask of all the cards in this Hand.
+*/
+CardMask Hand::toMask() const
+{
+	CardMask mask = 0;
+	for (CardList::const_iterator iter = cards.begin(); iter != cards.end(); iter++)
+		mask |= (*iter).toMask();
+
+	return mask;
+}
+
+/*
+Returns a mask of the face-down cards in this Hand.
+*/
+CardMask Hand::faceDownMask() const
+{
+	CardMask mask = 0;
+	for (CardList::const_iterator iter = cards.begin(); iter != cards.end(); iter++)
+	{
+		if ((*iter).faceDown)
+			mask |= (*iter).toMask();
+	}
+
+	return mask;
+}
+
 const Card & Hand::operator[] (size_t n)
 {
 	if (n < 0 || n >= cards.size())
 		throw std::out_of_range("Index out of bounds");
 
 	int pos = 0;
-	for (std::list<Card>::iterator iter = cards.begin(); iter != cards.end(); iter++)
+	for (CardList::iterator iter = cards.begin(); iter != cards.end(); iter++)
 	{
 		if (pos == n)
 		{
@@ -208,29 +254,79 @@ const Card & Hand::operator[] (size_t n)
 	return cards.front(); // Just something to stop the compiler from complaining.
 }
 
+namespace
+{
+	// Sinks for Hand::format()
+	struct StringSink
+	{
+		StringSink(std::string & str) : str(str) {}
+		void append(const char * chars, size_t length) { str.append(chars, length); }
+		std::string & str;
+	};
+
+	struct StreamSink
+	{
+		StreamSink(std::ostream & out) : out(out) {}
+		void append(const char * chars, size_t length) { out.write(chars, length); }
+		std::ostream & out;
+	};
+
+	// Upper bound on the length of a formatted Hand, for reserving space
+	size_t formattedLength(size_t numCards)
+	{
+		return 2 + numCards * (Card::STR_BUFFER_SIZE - 1 + 2);
+	}
+}
+
 /*
-Returns a string representation of all the cards in this Hand.  
-It will be in the format "[card_1, card_2, .. , card_n]"
+Writes "[card_1, card_2, .. , card_n]" to sink without allocating.  If
+hideFaceDown is true, face down cards come first as '*', followed by the
+face up cards in sorted order.
 */
-std::string Hand::toString() const
+template <class Sink>
+void Hand::format(Sink & sink, bool hideFaceDown) const
 {
-	if (cards.size() == 0)
-		return "[]";
+	sink.append("[", 1);
 
-	std::string ans = "[";
-	for (std::list<Card>::const_iterator iter = cards.begin(); iter != --cards.end(); iter++)
+	bool first = true;
+	if (hideFaceDown)
 	{
-		Card c = *iter;
-		std::string toAdd = c.toString() + ", ";
-		ans += toAdd;
+		for (CardList::const_iterator iter = cards.begin(); iter != cards.end(); iter++)
+		{
+			if (!(*iter).faceDown)
+				continue;
+
+			sink.append(first ? "*" : ", *", first ? 1 : 3);
+			first = false;
+		}
 	}
 
-	// Don't add a space for the last card
-	Card c = cards.back();
-	ans += c.toString();
+	for (CardList::const_iterator iter = cards.begin(); iter != cards.end(); iter++)
+	{
+		if (hideFaceDown && (*iter).faceDown)
+			continue;
+
+		char buffer[Card::STR_BUFFER_SIZE];
+		size_t length = (*iter).writeTo(buffer);
+		if (!first)
+			sink.append(", ", 2); // Don't add a comma before the first card
+		sink.append(buffer, length);
+		first = false;
+	}
 
-	ans += ']';
+	sink.append("]", 1);
+}
 
+/*
+Returns a string representation of all the cards in this Hand.  
+It will be in the format "[card_1, card_2, .. , card_n]"
+*/
+std::string Hand::toString() const
+{
+	std::string ans;
+	ans.reserve(formattedLength(cards.size()));
+	StringSink sink(ans);
+	format(sink, false);
 	return ans;
 }
 
@@ -240,33 +336,30 @@ Face down cards will appear first as '*'.
 */
 std::string Hand::toString_hideFaceDown() const
 {
-	if (cards.size() == 0)
-		return "[]";
-
-	std::string ans = "[";
-	std::list<Card> copy(cards);
-	copy.sort(&Card::compFaceDownLowest);
-
-	std::list<Card>::iterator iter = copy.begin();
-	while ((*iter).faceDown && iter != --copy.end())
-	{
-		ans += "*, ";
-		iter++;
-	}
-	while (iter != --copy.end())
-	{
-		ans += (*iter).toString() + ", ";
-		iter++;
-	}
-
-	if (copy.back().faceDown)
-		ans += '*';
-	else
-		ans += copy.back().toString();
+	std::string ans;
+	ans.reserve(formattedLength(cards.size()));
+	StringSink sink(ans);
+	format(sink, true);
+	return ans;
+}
 
-	ans += ']';
+/*
+Same as toString(), but writes straight to an ostream without allocating.
+*/
+void Hand::print(std::ostream & out) const
+{
+	StreamSink sink(out);
+	format(sink, false);
+}
 
-	return ans;
+/*
+Same as toString_hideFaceDown(), but writes straight to an ostream without
+allocating.
+*/
+void Hand::print_hideFaceDown(std::ostream & out) const
+{
+	StreamSink sink(out);
+	format(sink, true);
 }
 
 /*
@@ -277,6 +370,7 @@ Throws: domain_error if this Hand is not the size of a poker hand.
 */
 void Hand::calculateRank()
 {
+	PROFILE_COUNT("Hand::calculateRank");
 	if (cards.size() != POKER_HAND_SIZE)
 		throw std::domain_error("Hand is not the size of a poker hand.");
 
@@ -292,9 +386,9 @@ void Hand::calculateRank()
 	bool isFlush = false;
 
 	// Loop works because hand is sorted!
-	for (std::list<Card>::const_iterator iter = ++cards.begin(); iter != cards.end(); iter++)
+	for (CardList::const_iterator iter = ++cards.begin(); iter != cards.end(); iter++)
 	{
-		std::list<Card>::const_iterator prev = iter; prev--;
+		CardList::const_iterator prev = iter; prev--;
 		// Detect duplicate ranks
 		if ((*prev).getRank() == (*iter).getRank())
 		{
@@ -307,7 +401,7 @@ void Hand::calculateRank()
 			duplicateCnts[sameRanks-1]++; // sameRanks ==1: pair // ==2: triple // ==3: quad
 
 			// duplicateRanks saves the ranks of any pairs, three of a kinds, or four of a kinds
-			if (duplicateRanks[PAIR_INDEX] != 0) // Store any second pairs in the four of a kind index
+			if (sameRanks == 1 && duplicateRanks[PAIR_INDEX] != 0) // Store any second pairs in the four of a kind index
 				duplicateRanks[SECOND_PAIR_INDEX] = (*prev).getRank();
 			else
 				duplicateRanks[sameRanks-1] = (*prev).getRank(); 
@@ -330,17 +424,19 @@ void Hand::calculateRank()
 		duplicateCnts[sameRanks-1]++;
 
 		// duplicateRanks saves the ranks of any pairs, three of a kinds, or four of a kinds
-		if (duplicateRanks[PAIR_INDEX] != 0) // Store any second pairs in the four of a kind index
-			duplicateRanks[QUAD_INDEX] = cards.back().getRank();
+		if (sameRanks == 1 && duplicateRanks[PAIR_INDEX] != 0) // Store any second pairs in the four of a kind index
+			duplicateRanks[SECOND_PAIR_INDEX] = cards.back().getRank();
 		else
 			duplicateRanks[sameRanks-1] = cards.back().getRank();
 	}
 	/*
 	Since ACE is 14 and TWO is 2, the following is a special case that the
 	straight-checking code in the loop will not catch.  TWO will first
-	in the array after sorting; ACE will be last.
+	in the array after sorting; ACE will be last, right after FIVE.  (Without
+	the FIVE, hands like 2 3 4 K A would count as straights.)
 	*/
-	if ( (cards.front().getRank() == TWO) && (cards.back().getRank() == ACE) )
+	if ( (cards.front().getRank() == TWO) && (cards.back().getRank() == ACE) &&
+		((*----cards.end()).getRank() == FIVE) )
 	{
 		numConsecutive++;
 	}
@@ -401,8 +497,8 @@ bool Hand::sameRankAs(const Hand & other) const
 	if (rank != other.rank)
 		return false;
 
-	std::list<Card>::const_iterator thisIter = cards.begin();
-	std::list<Card>::const_iterator otherIter = other.cards.begin();
+	CardList::const_iterator thisIter = cards.begin();
+	CardList::const_iterator otherIter = other.cards.begin();
 	while (thisIter != cards.end())
 	{
 		if ((*thisIter).getRank() != (*otherIter).getRank())
@@ -416,23 +512,26 @@ bool Hand::sameRankAs(const Hand & other) const
 }
 
 /*
-Chooses the five cards out of this StudHand that make the best rank.  
-Creates a new Hand on the heap and returns it.
+Chooses the five cards out of this StudHand that make the best rank, and 
+returns them as a new Hand.  Inside a RoundArena::Scope, the candidate 
+hands tried along the way are all allocated from the arena.
 
 Throws domain_error if this StudHand is not STUD_HAND_SIZE cards.
 */
-Hand * Hand::bestStudHand()
+Hand Hand::bestStudHand()
 {
+	PROFILE_PHASE("bestStudHand");
 	if (cards.size() != STUD_HAND_SIZE)
 		throw std::domain_error("Hand is not the size of a stud hand.");
 
-	Hand * highestHand = new Hand(cards);
-	highestHand->cards.pop_back();
-	highestHand->cards.pop_back();
-	highestHand->calculateRank();
-	bestStudHandHelper(std::list<Card>(), Hand::POKER_HAND_SIZE, cards.begin(), highestHand);
+	Hand highestHand(*this);
+	highestHand.cards.pop_back();
+	highestHand.cards.pop_back();
+	highestHand.calculateRank();
+	CardList partialHand;
+	bestStudHandHelper(partialHand, Hand::POKER_HAND_SIZE, cards.begin(), highestHand);
 
-	rank = highestHand->rank;
+	rank = highestHand.rank;
 	return highestHand;
 }
 
@@ -443,6 +542,7 @@ Throws invalid_argument if either of the hands are unranked.
 */
 bool Hand::poker_rank(const Hand & h1, const Hand & h2)
 {
+	PROFILE_COUNT("Hand::poker_rank");
 	if (h1.rank == UNKNOWN || h2.rank == UNKNOWN)
 		throw std::invalid_argument("One or both hands unranked");
 
@@ -471,8 +571,8 @@ Compare the cards in each hand from highest to lowest.
 */
 bool Hand::compInOrder(const Hand & h1, const Hand & h2)
 {
-	std::list<Card>::const_reverse_iterator h1Iter = h1.cards.rbegin();
-	std::list<Card>::const_reverse_iterator h2Iter = h2.cards.rbegin();
+	CardList::const_reverse_iterator h1Iter = h1.cards.rbegin();
+	CardList::const_reverse_iterator h2Iter = h2.cards.rbegin();
 
 	while (h1Iter != h1.cards.rend())
 	{
@@ -488,14 +588,30 @@ bool Hand::compInOrder(const Hand & h1, const Hand & h2)
 	return false;
 }
 
+/*
+Compare the high cards of two straights.  The wheel (A-2-3-4-5) sorts with
+its ACE last, but is a five-high straight.
+*/
+bool Hand::compStraight(const Hand & h1, const Hand & h2)
+{
+	CardRank h1High = h1.cards.back().getRank();
+	if (h1High == ACE && h1.cards.front().getRank() == TWO)
+		h1High = FIVE;
+	CardRank h2High = h2.cards.back().getRank();
+	if (h2High == ACE && h2.cards.front().getRank() == TWO)
+		h2High = FIVE;
+
+	return h1High > h2High;
+}
+
 /*
 Compare the cards in each hand from highest to lowest, skipping 
 "skip" comparisons when a rank of "ignore" is encountered.
 */
 bool Hand::compInOrder_ignore(const Hand & h1, const Hand & h2, CardRank ignore, int skip)
 {
-	std::list<Card>::const_reverse_iterator h1Iter = h1.cards.rbegin();
-	std::list<Card>::const_reverse_iterator h2Iter = h2.cards.rbegin();
+	CardList::const_reverse_iterator h1Iter = h1.cards.rbegin();
+	CardList::const_reverse_iterator h2Iter = h2.cards.rbegin();
 
 	while (h1Iter != h1.cards.rend())
 	{
@@ -562,7 +678,7 @@ bool Hand::compTwoPair(const Hand & h1, const Hand & h2)
 	// Both pairs the same...
 	CardRank kickerH1 = BAD_RANK;
 	CardRank kickerH2 = BAD_RANK;
-	for (std::list<Card>::const_iterator iter = h1.cards.begin(); iter != h1.cards.end(); iter++)
+	for (CardList::const_iterator iter = h1.cards.begin(); iter != h1.cards.end(); iter++)
 	{
 		if ((*iter).getRank() != hiPairh1 && (*iter).getRank() != loPairh1)
 		{
@@ -570,7 +686,7 @@ bool Hand::compTwoPair(const Hand & h1, const Hand & h2)
 			break;
 		}
 	}
-	for (std::list<Card>::const_iterator iter = h2.cards.begin(); iter != h2.cards.end(); iter++)
+	for (CardList::const_iterator iter = h2.cards.begin(); iter != h2.cards.end(); iter++)
 	{
 		if ((*iter).getRank() != hiPairh2 && (*iter).getRank() != loPairh2)
 		{
@@ -629,15 +745,16 @@ bool Hand::compFourKind(const Hand & h1, const Hand & h2)
 Gets all 5-card combinations out of this Hand and stores the Hand with 
 the highest poker rank in highestHand.
 */
-void Hand::bestStudHandHelper(std::list<Card> & partialHand, size_t select, std::list<Card>::const_iterator selectStart, Hand * highestHand) const
+void Hand::bestStudHandHelper(CardList & partialHand, size_t select, CardList::const_iterator selectStart, Hand & highestHand) const
 {
 	if (partialHand.size() == select)
 	{
-		Hand candidate = Hand(partialHand);
+		Hand candidate;
+		candidate.cards = partialHand; // Already sorted, since cards is
 		candidate.calculateRank();
-		if (Hand::poker_rank(candidate, *highestHand))
+		if (Hand::poker_rank(candidate, highestHand))
 		{
-			*highestHand = candidate;
+			highestHand = candidate;
 		}
 
 		return;
@@ -645,7 +762,7 @@ void Hand::bestStudHandHelper(std::list<Card> & partialHand, size_t select, std:
 	
 	// Invariant 1: the card at selectStart is always found after the last card of partialHand.
 	// Invariant 2: there will always be enough cards after selectStart to complete partialHand.
-	std::list<Card>::const_iterator end = cards.end();
+	CardList::const_iterator end = cards.end();
 	std::advance(end, (int)partialHand.size() - (int)select + 1);
 	while (selectStart != end)
 	{
@@ -670,8 +787,8 @@ Hand & operator<< (Hand & hand, Deck & deck)
 Inserts a string representation of all the cards in this Hand into an ostream.  
 It will be in the format "[card_1, card_2, .. , card_n]"
 */
-std::ostream & operator<< (std::ostream &out, Hand & hand)
+std::ostream & operator<< (std::ostream &out, const Hand & hand)
 {
-	out << hand.toString();
+	hand.print(out);
 	return out;
 }
@@ -14,8 +14,10 @@ class Deck;
 class Hand;
 
 #include "Card.h"
+#include "RoundArena.h"
 
 #include <list>
+#include <iosfwd>
 
 #define STR_RANKS_COUNT 9
 #define STR_RANKS {"High card", "One pair", "Two pair", "Three of a kind", "Straight", "Flush", "Full house", "Four of a kind", "Straight flush"}
@@ -35,12 +37,16 @@ enum pokerRank
 
 typedef bool (*pokerRankFxnPtr)(const Hand & h1, const Hand & h2);
 
+// Cards in a Hand come from the active RoundArena, if there is one
+typedef std::list<Card, ArenaAllocator<Card> > CardList;
+
 class Hand
 {
 public:
 	// Constructors and assignment
 	Hand();
 	Hand(std::list<Card> list);
+	explicit Hand(CardMask mask, CardMask faceDown = 0);
 	Hand(const Hand & other);
 	Hand & operator= (const Hand & other);
 	// Default destructor is fine since Hand objects only have static memory (i.e. no calls to "new")
@@ -58,16 +64,20 @@ public:
 
 	// Information
 	int size() const;
+	CardMask toMask() const;
+	CardMask faceDownMask() const;
 	const Card & operator[] (size_t n);
 	std::string toString() const;
 	std::string toString_hideFaceDown() const;
+	void print(std::ostream & out) const;
+	void print_hideFaceDown(std::ostream & out) const;
 
 	// Ranking
 	virtual void calculateRank();
 	pokerRank getRank() const;
 	std::string getStrRank() const;
 	bool sameRankAs(const Hand & other) const;
-	Hand * bestStudHand();
+	Hand bestStudHand();
 	static bool poker_rank(const Hand & h1, const Hand & h2);
 
 	friend Hand & operator<< (Hand & hand, Deck & deck); // FYI: Found at bottom of Hand.cpp
@@ -76,12 +86,13 @@ public:
 	static const size_t POKER_HAND_SIZE = 5;
 
 protected:
-	std::list<Card> cards;
+	CardList cards;
 	pokerRank rank;
 
 private:
 	static bool compInOrder(const Hand & h1, const Hand & h2);
 	static bool compInOrder_ignore(const Hand & h1, const Hand & h2, CardRank ignore, int skip);
+	static bool compStraight(const Hand & h1, const Hand & h2);
 	static bool compPair(const Hand & h1, const Hand & h2);
 	static bool compTwoPair(const Hand & h1, const Hand & h2);
 	static bool compThreeKind(const Hand & h1, const Hand & h2);
@@ -89,7 +100,10 @@ private:
 	static bool compFourKind(const Hand & h1, const Hand & h2);
 	static const pokerRankFxnPtr rankingFxns[9];
 
-	void bestStudHandHelper(std::list<Card> & partialHand, size_t select, std::list<Card>::const_iterator selectStart, Hand * highestHand) const;
+	template <class Sink>
+	void format(Sink & sink, bool hideFaceDown) const; // FYI: Found in Hand.cpp, which is the only user
+
+	void bestStudHandHelper(CardList & partialHand, size_t select, CardList::const_iterator selectStart, Hand & highestHand) const;
 
 	static const int MAX_SAME_RANK = 4; // Means we can't have more than a four of a kind
 	static const int STRAIGHT_THRESHOLD = 4; // Pairs of consecutive cards in a row before we consider it a straight
@@ -104,6 +118,6 @@ private:
 	CardRank duplicateRanks[MAX_SAME_RANK - 1]; // Saves the ranks of any pairs, three of a kinds, or four of a kinds
 };
 
-std::ostream & operator<< (std::ostream &out, Hand & hand);
+std::ostream & operator<< (std::ostream &out, const Hand & hand);
 
 #endif
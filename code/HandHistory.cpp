@@ -0,0 +1,476 @@
+/*
+HandHistory.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Defines HandRecord's encoding, the HistoryWriter thread, and HistoryReader.
+*/
+
+#include "stdafx.h"
+#include "HandHistory.h"
+
+#include <chrono>
+#include <random>
+#include <assert.h>
+#include <string.h>
+
+using namespace std;
+
+const char HistoryWriter::MAGIC[4] = {'T', 'P', 'H', 'H'};
+
+namespace
+{
+	void putByte(vector<unsigned char> & out, unsigned long value)
+	{
+		out.push_back((unsigned char)value);
+	}
+
+	void putU16(vector<unsigned char> & out, unsigned long value)
+	{
+		out.push_back((unsigned char)value);
+		out.push_back((unsigned char)(value >> 8));
+	}
+
+	void putU32(vector<unsigned char> & out, unsigned long value)
+	{
+		for (int i = 0; i < 4; i++)
+			out.push_back((unsigned char)(value >> (8 * i)));
+	}
+
+	void putCards(vector<unsigned char> & out, CardMask cards)
+	{
+		unsigned char indices[Card::NUM_CARDS];
+		size_t numCards = 0;
+		for (int index = 0; cards != 0; index++, cards >>= 1)
+		{
+			if (cards & 1)
+				indices[numCards++] = (unsigned char)index;
+		}
+
+		putByte(out, numCards);
+		size_t start = out.size();
+		out.resize(start + Scenario::packedSize(numCards));
+		Scenario::packCards(indices, numCards, &out[0] + start);
+	}
+
+	/*
+	Reads from a record being decoded.  Every get*() returns false, and
+	reads nothing, if the record is too short.
+	*/
+	class RecordIn
+	{
+	public:
+		RecordIn(const unsigned char * data, size_t length) : pos(data), end(data + length) {}
+
+		bool getNumber(unsigned long & value, size_t numBytes)
+		{
+			if ((size_t)(end - pos) < numBytes)
+				return false;
+			value = 0;
+			for (size_t i = 0; i < numBytes; i++)
+				value |= (unsigned long)pos[i] << (8 * i);
+			pos += numBytes;
+			return true;
+		}
+
+		bool getString(std::string & value)
+		{
+			unsigned long length;
+			if (!getNumber(length, 1) || (size_t)(end - pos) < length)
+				return false;
+			value.assign(reinterpret_cast<const char *>(pos), length);
+			pos += length;
+			return true;
+		}
+
+		// Fails on bad or repeated cards as well
+		bool getCards(CardMask & cards)
+		{
+			unsigned long numCards;
+			if (!getNumber(numCards, 1) || numCards > (unsigned long)Card::NUM_CARDS)
+				return false;
+			size_t size = Scenario::packedSize(numCards);
+			if ((size_t)(end - pos) < size)
+				return false;
+
+			unsigned char indices[Card::NUM_CARDS];
+			Scenario::unpackCards(pos, numCards, indices);
+			pos += size;
+
+			cards = 0;
+			for (size_t i = 0; i < numCards; i++)
+			{
+				CardMask bit = (CardMask)1 << indices[i];
+				if (indices[i] >= Card::NUM_CARDS || (cards & bit))
+					return false;
+				cards |= bit;
+			}
+			return true;
+		}
+
+		bool atEnd() const { return pos == end; }
+
+	private:
+		const unsigned char * pos;
+		const unsigned char * end;
+	};
+}
+
+////////////////
+// HandRecord //
+////////////////
+
+HandRecord::HandRecord()
+	: variant(SCENARIO_ANY), dealerPos(0), tableId(0), session(0), handNumber(0), board(0) {}
+
+/*
+Starts a new round with numSeats seats.  Keeps the variant, table id and
+seat names; clears everything else.
+*/
+void HandRecord::begin(size_t numSeats)
+{
+	assert(numSeats <= MAX_SEATS);
+
+	seats.resize(numSeats); // Not clear(), so that the names keep their memory
+	for (size_t i = 0; i < numSeats; i++)
+	{
+		seats[i].startChips = seats[i].finalChips = 0;
+		seats[i].cards = 0;
+	}
+	actions.clear();
+	winners.clear();
+	board = 0;
+}
+
+void HandRecord::addAction(size_t street, size_t seat, HandAction action, unsigned long amount, unsigned long potAfter)
+{
+	Action toAdd = {(unsigned char)street, (unsigned char)seat, (unsigned char)action, amount, potAfter};
+	actions.push_back(toAdd);
+}
+
+void HandRecord::addWinner(size_t seat, unsigned long amount)
+{
+	Winner toAdd = {(unsigned char)seat, amount};
+	winners.push_back(toAdd);
+}
+
+/*
+Appends the record, with its length in front, to out.  The record is 
+marked as written in the specified session, whatever its own session is.
+*/
+void HandRecord::encode(vector<unsigned char> & out, unsigned session) const
+{
+	size_t lengthPos = out.size();
+	putU32(out, 0); // Filled in at the end
+
+	putByte(out, variant);
+	putByte(out, dealerPos);
+	putByte(out, seats.size());
+	putU32(out, tableId);
+	putU32(out, session);
+	putU32(out, handNumber);
+
+	for (size_t i = 0; i < seats.size(); i++)
+	{
+		size_t nameLength = (seats[i].name.length() < 255 ? seats[i].name.length() : 255);
+		putByte(out, nameLength);
+		out.insert(out.end(), seats[i].name.begin(), seats[i].name.begin() + nameLength);
+		putU32(out, seats[i].startChips);
+		putU32(out, seats[i].finalChips);
+		putCards(out, seats[i].cards);
+	}
+
+	putCards(out, board);
+
+	size_t numActions = (actions.size() < MAX_ACTIONS ? actions.size() : MAX_ACTIONS);
+	putU16(out, numActions);
+	for (size_t i = 0; i < numActions; i++)
+	{
+		putByte(out, actions[i].street);
+		putByte(out, actions[i].seat);
+		putByte(out, actions[i].action);
+		putU32(out, actions[i].amount);
+		putU32(out, actions[i].potAfter);
+	}
+
+	putByte(out, winners.size());
+	for (size_t i = 0; i < winners.size(); i++)
+	{
+		putByte(out, winners[i].seat);
+		putU32(out, winners[i].amount);
+	}
+
+	unsigned long length = out.size() - lengthPos - 4;
+	for (int i = 0; i < 4; i++)
+		out[lengthPos + i] = (unsigned char)(length >> (8 * i));
+}
+
+/*
+Replaces this record with one encoded by encode(), without the length in 
+front.  Returns false if the bytes are not a valid record, in which case 
+this record is left in an unspecified state.
+*/
+bool HandRecord::decode(const unsigned char * data, size_t length)
+{
+	RecordIn in(data, length);
+	unsigned long value, numSeats;
+
+	if (!in.getNumber(value, 1) || value > SCENARIO_TEXAS_HOLD_EM)
+		return false;
+	variant = (unsigned char)value;
+	if (!in.getNumber(value, 1))
+		return false;
+	dealerPos = (unsigned char)value;
+	if (!in.getNumber(numSeats, 1) || !in.getNumber(value, 4))
+		return false;
+	tableId = (unsigned)value;
+	if (!in.getNumber(value, 4))
+		return false;
+	session = (unsigned)value;
+	if (!in.getNumber(handNumber, 4))
+		return false;
+
+	begin(numSeats);
+	for (size_t i = 0; i < numSeats; i++)
+	{
+		if (!in.getString(seats[i].name) || !in.getNumber(seats[i].startChips, 4) ||
+			!in.getNumber(seats[i].finalChips, 4) || !in.getCards(seats[i].cards))
+			return false;
+	}
+	if (!in.getCards(board))
+		return false;
+
+	unsigned long numActions;
+	if (!in.getNumber(numActions, 2))
+		return false;
+	for (size_t i = 0; i < numActions; i++)
+	{
+		unsigned long street, seat, action, amount, potAfter;
+		if (!in.getNumber(street, 1) || !in.getNumber(seat, 1) || !in.getNumber(action, 1) ||
+			!in.getNumber(amount, 4) || !in.getNumber(potAfter, 4))
+			return false;
+		if (seat >= numSeats || action > ACTION_FOLD)
+			return false;
+		addAction(street, seat, (HandAction)action, amount, potAfter);
+	}
+
+	unsigned long numWinners;
+	if (!in.getNumber(numWinners, 1))
+		return false;
+	for (size_t i = 0; i < numWinners; i++)
+	{
+		unsigned long seat, amount;
+		if (!in.getNumber(seat, 1) || !in.getNumber(amount, 4) || seat >= numSeats)
+			return false;
+		addWinner(seat, amount);
+	}
+
+	return in.atEnd();
+}
+
+///////////////////
+// HistoryWriter //
+///////////////////
+
+/*
+Opens the specified file for appending, writes a header if the file is
+new, picks this writer's session number, and starts the writer thread.
+
+Throws fstream::failure if the file cannot be opened, or if it is not a
+hand history of this version.
+*/
+HistoryWriter::HistoryWriter(const char fileName[])
+	: file(fileName, ios::out | ios::binary | ios::app), front(0), submitted(0), written(0),
+	flushRequested(false), stopping(false), failed(false)
+{
+	if (!file)
+		throw fstream::failure("History file could not be opened");
+
+	file.seekp(0, ios::end);
+	if (file.tellp() == 0)
+	{
+		char header[HEADER_SIZE] = {MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3], (char)VERSION, (char)(VERSION >> 8), 0, 0};
+		file.write(header, sizeof(header));
+		file.flush();
+	}
+	else
+	{
+		ifstream existing(fileName, ios::in | ios::binary);
+		char header[HEADER_SIZE];
+		existing.read(header, sizeof(header));
+		if (existing.gcount() != sizeof(header) || memcmp(header, MAGIC, sizeof(MAGIC)) != 0 ||
+			((unsigned char)header[4] | ((unsigned char)header[5] << 8)) != VERSION)
+			throw fstream::failure("History file is not a hand history of this version");
+	}
+
+	random_device device;
+	session = device() ^ (unsigned)chrono::system_clock::now().time_since_epoch().count();
+
+	buffers[0].reserve(WRITE_THRESHOLD * 2);
+	buffers[1].reserve(WRITE_THRESHOLD * 2);
+	thread = std::thread(&HistoryWriter::run, this);
+}
+
+/*
+Writes everything that was submitted and stops the writer thread.
+*/
+HistoryWriter::~HistoryWriter()
+{
+	{
+		lock_guard<mutex> guard(lock);
+		stopping = true;
+	}
+	wake.notify_one();
+	thread.join();
+}
+
+/*
+Encodes a record into memory for the writer thread.  Only waits for the
+writer thread while it swaps buffers, never while it writes.
+*/
+void HistoryWriter::submit(const HandRecord & record)
+{
+	bool full;
+	{
+		lock_guard<mutex> guard(lock);
+		record.encode(buffers[front], session);
+		submitted++;
+		full = (buffers[front].size() >= WRITE_THRESHOLD);
+	}
+
+	if (full)
+		wake.notify_one();
+}
+
+/*
+Waits until every record submitted so far is in the file.
+
+Throws fstream::failure if the writer thread could not write.
+*/
+void HistoryWriter::flush()
+{
+	unique_lock<mutex> guard(lock);
+	flushRequested = true;
+	wake.notify_one();
+	done.wait(guard, [this] { return written == submitted || failed; });
+	flushRequested = false;
+
+	if (failed)
+		throw fstream::failure("Could not write to history file");
+}
+
+unsigned long HistoryWriter::getRecordsWritten() const
+{
+	lock_guard<mutex> guard(lock);
+	return written;
+}
+
+/*
+The number every record this writer writes is marked with.
+*/
+unsigned HistoryWriter::getSession() const
+{
+	return session;
+}
+
+/*
+The writer thread.  Waits until the front buffer is big enough, a flush is
+requested, or a second has passed; then swaps buffers and writes the full
+one while submit() fills the other.
+*/
+void HistoryWriter::run()
+{
+	unique_lock<mutex> guard(lock);
+	while (true)
+	{
+		wake.wait_for(guard, chrono::seconds(1), [this] {
+			return stopping || buffers[front].size() >= WRITE_THRESHOLD || (flushRequested && !buffers[front].empty());
+		});
+
+		if (!buffers[front].empty() && !failed)
+		{
+			vector<unsigned char> & toWrite = buffers[front];
+			front = 1 - front;
+			unsigned long count = submitted;
+
+			guard.unlock();
+			file.write(reinterpret_cast<const char *>(&toWrite[0]), toWrite.size());
+			file.flush();
+			bool ok = !file.fail();
+			toWrite.clear();
+			guard.lock();
+
+			if (ok)
+				written = count;
+			else
+				failed = true;
+		}
+		else if (failed)
+		{
+			buffers[front].clear(); // Nowhere to put it
+		}
+
+		if (buffers[front].empty())
+			done.notify_all();
+		if (stopping && buffers[front].empty())
+			break;
+	}
+}
+
+///////////////////
+// HistoryReader //
+///////////////////
+
+/*
+Opens a hand-history file and checks its header.
+
+Throws fstream::failure if the file cannot be opened or is not a hand 
+history of a version this reader understands.
+*/
+HistoryReader::HistoryReader(const char fileName[])
+	: file(fileName, ios::in | ios::binary), recordsRead(0)
+{
+	if (!file)
+		throw fstream::failure("History file could not be opened");
+
+	char header[HistoryWriter::HEADER_SIZE];
+	file.read(header, sizeof(header));
+	if (file.gcount() != sizeof(header) || memcmp(header, HistoryWriter::MAGIC, sizeof(HistoryWriter::MAGIC)) != 0)
+		throw fstream::failure("Not a hand-history file");
+	if (((unsigned char)header[4] | ((unsigned char)header[5] << 8)) != HistoryWriter::VERSION)
+		throw fstream::failure("Unsupported hand-history version");
+}
+
+/*
+Reads the next record into record.  Returns false at the end of the file.
+
+Throws fstream::failure if the file is cut short or a record is corrupt.
+*/
+bool HistoryReader::next(HandRecord & record)
+{
+	unsigned char lengthBytes[4];
+	file.read(reinterpret_cast<char *>(lengthBytes), sizeof(lengthBytes));
+	if (file.gcount() == 0 && file.eof())
+		return false;
+	if (file.gcount() != sizeof(lengthBytes))
+		throw fstream::failure("History file is cut short");
+
+	size_t length = lengthBytes[0] | (lengthBytes[1] << 8) | (lengthBytes[2] << 16) | ((size_t)lengthBytes[3] << 24);
+	if (length == 0 || length > MAX_RECORD_SIZE)
+		throw fstream::failure("History file is corrupt");
+
+	buffer.resize(length);
+	file.read(reinterpret_cast<char *>(&buffer[0]), length);
+	if ((size_t)file.gcount() != length)
+		throw fstream::failure("History file is cut short");
+	if (!record.decode(&buffer[0], length))
+		throw fstream::failure("History file is corrupt");
+
+	recordsRead++;
+	return true;
+}
+
+unsigned long HistoryReader::getRecordsRead() const
+{
+	return recordsRead;
+}
@@ -0,0 +1,169 @@
+/*
+HandHistory.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Declares HandRecord, everything that happened in one round; HistoryWriter,
+which appends HandRecords to a binary hand-history file from a background
+thread; and HistoryReader, which streams them back one at a time.  Tables
+fill in a HandRecord as the round goes and hand it to
+HistoryWriter::submit() at the end; submit() only copies the encoded
+record into memory, so the table never waits on the disk.
+
+Any number of runs may append to the same file, one after another.  Table
+ids and hand numbers start over with every run, so each HistoryWriter picks
+a random session number when it opens the file and writes it into every
+record; a table's hands are only in order within a session.  A writer will
+not append to a file of a different version.
+
+File: an 8-byte header ("TPHH", format version, 2 reserved bytes), then
+one record after another.  Each record is a 4-byte length followed by that
+many bytes.  All numbers are little-endian.
+	u8  variant (a ScenarioVariant)
+	u8  dealer position
+	u8  number of seats
+	u32 table id
+	u32 session (see HistoryWriter)
+	u32 hand number
+	for each seat:
+		u8 name length, then the name
+		u32 chips at the start of the round, u32 chips at the end
+		u8 number of cards, then the cards packed as in Scenario::packCards()
+	u8  number of board cards, then the cards, packed
+	u16 number of actions
+	for each action:
+		u8 street, u8 seat, u8 HandAction, u32 chips paid, u32 pot afterwards
+	u8  number of winners
+	for each winner: u8 seat, u32 chips won
+*/
+
+#ifndef HAND_HISTORY_H
+#define HAND_HISTORY_H
+
+#include "Card.h"
+#include "Scenario.h"
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+enum HandAction
+{
+	ACTION_ANTE = 0,
+	ACTION_CHECK = 1,
+	ACTION_BET = 2,
+	ACTION_CALL = 3,
+	ACTION_RAISE = 4, // Amount includes the call
+	ACTION_FOLD = 5
+};
+
+struct HandRecord
+{
+	struct Seat
+	{
+		std::string name;
+		unsigned long startChips;
+		unsigned long finalChips;
+		CardMask cards;
+	};
+
+	struct Action
+	{
+		unsigned char street;
+		unsigned char seat;
+		unsigned char action; // A HandAction
+		unsigned long amount;
+		unsigned long potAfter;
+	};
+
+	struct Winner
+	{
+		unsigned char seat;
+		unsigned long amount;
+	};
+
+	HandRecord();
+	void begin(size_t numSeats);
+	void addAction(size_t street, size_t seat, HandAction action, unsigned long amount, unsigned long potAfter);
+	void addWinner(size_t seat, unsigned long amount);
+	void encode(std::vector<unsigned char> & out, unsigned session) const;
+	bool decode(const unsigned char * data, size_t length);
+
+	unsigned char variant;
+	unsigned char dealerPos;
+	unsigned tableId;
+	unsigned session; // Read back from the file; HistoryWriter fills it in when it writes
+	unsigned long handNumber;
+	CardMask board;
+	std::vector<Seat> seats;
+	std::vector<Action> actions;
+	std::vector<Winner> winners;
+
+	static const size_t MAX_SEATS = 255;
+	static const size_t MAX_ACTIONS = 65535;
+};
+
+class HistoryWriter
+{
+public:
+	HistoryWriter(const char fileName[]);
+	~HistoryWriter();
+
+	void submit(const HandRecord & record);
+	void flush();
+	unsigned long getRecordsWritten() const;
+	unsigned getSession() const;
+
+	static const char MAGIC[4];
+	static const unsigned VERSION = 2;
+	static const size_t HEADER_SIZE = 8;
+
+private:
+	// Undefined, so that no copies can be made.
+	HistoryWriter(const HistoryWriter & other);
+	HistoryWriter & operator= (const HistoryWriter & other);
+
+	void run();
+
+	std::ofstream file;
+	unsigned session;
+	std::vector<unsigned char> buffers[2]; // submit() fills buffers[front] while run() writes the other
+	size_t front;
+	unsigned long submitted; // Records
+	unsigned long written;
+	bool flushRequested;
+	bool stopping;
+	bool failed;
+
+	mutable std::mutex lock;
+	std::condition_variable wake; // Signals run()
+	std::condition_variable done; // Signals flush()
+	std::thread thread;
+
+	static const size_t WRITE_THRESHOLD = 64 * 1024; // Bytes buffered before run() is woken
+};
+
+class HistoryReader
+{
+public:
+	HistoryReader(const char fileName[]);
+
+	bool next(HandRecord & record);
+	unsigned long getRecordsRead() const;
+
+private:
+	// Undefined, so that no copies can be made.
+	HistoryReader(const HistoryReader & other);
+	HistoryReader & operator= (const HistoryReader & other);
+
+	std::ifstream file;
+	std::vector<unsigned char> buffer; // One record's bytes
+	unsigned long recordsRead;
+
+	static const size_t MAX_RECORD_SIZE = 1 << 24; // Anything longer is corrupt
+};
+
+#endif
@@ -0,0 +1,105 @@
+/*
+HistoryQuery.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Entry point for the hand-history query tool, built as its own executable.
+Opens one or more hand-history files through a HistoryStore (building
+their indexes if needed) and prints a player's totals, and optionally the
+player's hands.
+
+Usage: HistoryQuery [--hands] [--pocket-pairs] name historyFile...
+--hands lists every hand the player played.  --pocket-pairs lists only the
+Texas Hold 'Em hands where the player's two cards were a pair.
+Exits with 1 if the player is in none of the files.
+*/
+
+#include "stdafx.h"
+#include "HistoryStore.h"
+#include "Hand.h"
+
+#include <iostream>
+#include <string.h>
+
+using namespace std;
+
+/*
+True if the seat was dealt two Texas Hold 'Em cards of the same rank.
+*/
+bool pocketPair(const HandRecord & record, size_t seat)
+{
+	if (record.variant != SCENARIO_TEXAS_HOLD_EM)
+		return false;
+
+	Hand cards(record.seats[seat].cards);
+	return cards.size() == 2 && cards[0].getRank() == cards[1].getRank();
+}
+
+void printHand(const HandRecord & record, size_t seat)
+{
+	const HandRecord::Seat & info = record.seats[seat];
+	cout << "Table " << record.tableId << ", hand " << record.handNumber << ", seat " << seat << ": "
+		<< Hand(info.cards);
+	if (record.board)
+		cout << " board " << Hand(record.board);
+	cout << ", " << info.startChips << " -> " << info.finalChips << " chips" << endl;
+}
+
+int main(int argc, char * argv[])
+{
+	bool listHands = false;
+	bool pocketPairsOnly = false;
+	bool usage = false;
+	int argNum = 1;
+	for (; argNum < argc && argv[argNum][0] == '-'; argNum++)
+	{
+		if (strcmp(argv[argNum], "--hands") == 0)
+			listHands = true;
+		else if (strcmp(argv[argNum], "--pocket-pairs") == 0)
+			listHands = pocketPairsOnly = true;
+		else
+			usage = true;
+	}
+	if (usage || argc - argNum < 2)
+	{
+		cout << "Usage: " << argv[0] << " [--hands] [--pocket-pairs] name historyFile..." << endl;
+		return 2;
+	}
+
+	string name(argv[argNum++]);
+	HistoryStore store;
+	try
+	{
+		for (; argNum < argc; argNum++)
+			store.addSegment(argv[argNum]);
+
+		PlayerSummary summary;
+		if (!store.summary(name, summary))
+		{
+			cout << name << " is not in any of the histories." << endl;
+			return 1;
+		}
+
+		cout << summary.name << ": " << summary.hands << " hands, " << summary.wins << " wins, " << summary.losses
+			<< " losses, " << summary.chipsWon << " chips won, " << summary.netChips << " net" << endl;
+
+		if (listHands)
+		{
+			unsigned long numListed = 0;
+			store.forEachHand(name, [&](const HandRecord & record, size_t seat) {
+				if (pocketPairsOnly && !pocketPair(record, seat))
+					return;
+				printHand(record, seat);
+				numListed++;
+			});
+			cout << numListed << " hand(s) listed." << endl;
+		}
+	}
+	catch (fstream::failure & e)
+	{
+		cout << e.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
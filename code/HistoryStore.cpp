@@ -0,0 +1,424 @@
+/*
+HistoryStore.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Defines HistoryStore and the building of its sidecar indexes.
+*/
+
+#include "stdafx.h"
+#include "HistoryStore.h"
+
+#include <fstream>
+#include <map>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+using namespace std;
+
+const char HistoryStore::MAGIC[4] = {'T', 'P', 'H', 'I'};
+
+namespace
+{
+	void putLittleEndian(unsigned char * bytes, unsigned long long value, size_t numBytes)
+	{
+		for (size_t i = 0; i < numBytes; i++)
+			bytes[i] = (unsigned char)(value >> (8 * i));
+	}
+
+	unsigned long long getLittleEndian(const unsigned char * bytes, size_t numBytes)
+	{
+		unsigned long long value = 0;
+		for (size_t i = 0; i < numBytes; i++)
+			value |= (unsigned long long)bytes[i] << (8 * i);
+		return value;
+	}
+
+	string upperCase(const string & str)
+	{
+		string upper(str);
+		for (size_t i = 0; i < upper.length(); i++)
+			upper[i] = (char)toupper((unsigned char)upper[i]);
+		return upper;
+	}
+
+	/*
+	Compares like string::compare() on the upper-cased strings, without
+	making copies.
+	*/
+	int compareUpper(const char * one, size_t oneLength, const char * two, size_t twoLength)
+	{
+		size_t shorter = (oneLength < twoLength ? oneLength : twoLength);
+		for (size_t i = 0; i < shorter; i++)
+		{
+			int diff = toupper((unsigned char)one[i]) - toupper((unsigned char)two[i]);
+			if (diff != 0)
+				return diff;
+		}
+		return (oneLength < twoLength ? -1 : (oneLength > twoLength ? 1 : 0));
+	}
+
+	// Everything the index says about one player, while it is being built
+	struct PlayerTotals
+	{
+		PlayerTotals() : wins(0), losses(0), chipsWon(0), netChips(0) {}
+
+		string name; // As first seen
+		unsigned long wins;
+		unsigned long losses;
+		unsigned long long chipsWon;
+		long long netChips;
+		vector<unsigned long long> postings;
+	};
+
+	const unsigned long long OFFSET_MASK = (1ULL << 48) - 1;
+	const int SEAT_SHIFT = 56;
+
+	/*
+	Reads an index back into players, so that only the records past the
+	ones it covers need to be read.  Returns false, leaving players empty,
+	if the index is missing or corrupt.
+	*/
+	bool loadIndex(const string & indexFile, map<string, PlayerTotals> & players)
+	{
+		try
+		{
+			MappedFile index(indexFile.c_str());
+			const unsigned char * data = index.data();
+			size_t size = index.size();
+			if (size < HistoryStore::HEADER_SIZE)
+				return false;
+
+			unsigned long long numPlayers = getLittleEndian(data + 24, 4);
+			unsigned long long numPostings = getLittleEndian(data + 28, 4);
+			const unsigned char * entry = data + HistoryStore::HEADER_SIZE;
+			const unsigned char * postings = entry + numPlayers * HistoryStore::ENTRY_SIZE;
+			const unsigned char * names = postings + numPostings * HistoryStore::POSTING_SIZE;
+			if (HistoryStore::HEADER_SIZE + numPlayers * HistoryStore::ENTRY_SIZE + numPostings * HistoryStore::POSTING_SIZE > size)
+				return false;
+			size_t namesSize = size - (names - data);
+
+			for (unsigned long long p = 0; p < numPlayers; p++, entry += HistoryStore::ENTRY_SIZE)
+			{
+				size_t nameOffset = (size_t)getLittleEndian(entry, 4);
+				size_t nameLength = (size_t)getLittleEndian(entry + 4, 4);
+				unsigned long long firstPosting = getLittleEndian(entry + 8, 4);
+				unsigned long long count = getLittleEndian(entry + 12, 4);
+				if (nameOffset + nameLength > namesSize || firstPosting + count > numPostings)
+				{
+					players.clear();
+					return false;
+				}
+
+				string name(reinterpret_cast<const char *>(names + nameOffset), nameLength);
+				PlayerTotals & totals = players[upperCase(name)];
+				totals.name = name;
+				totals.wins = (unsigned long)getLittleEndian(entry + 16, 4);
+				totals.losses = (unsigned long)getLittleEndian(entry + 20, 4);
+				totals.chipsWon = getLittleEndian(entry + 24, 8);
+				totals.netChips = (long long)getLittleEndian(entry + 32, 8);
+				totals.postings.reserve((size_t)count);
+				for (unsigned long long i = 0; i < count; i++)
+					totals.postings.push_back(getLittleEndian(postings + (firstPosting + i) * HistoryStore::POSTING_SIZE, HistoryStore::POSTING_SIZE));
+			}
+			return true;
+		}
+		catch (fstream::failure &)
+		{
+			players.clear();
+			return false;
+		}
+	}
+}
+
+HistoryStore::HistoryStore() {}
+
+HistoryStore::~HistoryStore()
+{
+	for (size_t i = 0; i < segments.size(); i++)
+	{
+		delete segments[i].history;
+		delete segments[i].index;
+	}
+}
+
+/*
+Maps a hand-history file and its index, building the index first if it is
+missing, or bringing it up to date if the history has grown.
+
+Throws fstream::failure if either file cannot be read or written, or if the
+history is not a hand-history file.
+*/
+void HistoryStore::addSegment(const char historyFile[])
+{
+	Segment segment;
+	segment.history = new MappedFile(historyFile);
+	segment.index = 0;
+
+	try
+	{
+		string indexFile = indexFileName(historyFile);
+		unsigned long long indexedSize;
+		unsigned long long bytesIndexed;
+		if (!readIndexHeader(indexFile.c_str(), indexedSize, bytesIndexed) ||
+			indexedSize > segment.history->size() || bytesIndexed > indexedSize)
+			buildIndex(*segment.history, indexFile, 0); // Missing, or not from this history
+		else if (indexedSize < segment.history->size())
+			buildIndex(*segment.history, indexFile, bytesIndexed); // Grown since
+
+		segment.index = new MappedFile(indexFile.c_str());
+		const unsigned char * data = segment.index->data();
+		segment.numPlayers = (unsigned long)getLittleEndian(data + 24, 4);
+		unsigned long numPostings = (unsigned long)getLittleEndian(data + 28, 4);
+		segment.entries = data + HEADER_SIZE;
+		segment.postings = segment.entries + segment.numPlayers * ENTRY_SIZE;
+		segment.names = segment.postings + numPostings * POSTING_SIZE;
+		if ((size_t)(segment.names - data) > segment.index->size())
+			throw fstream::failure("Index " + indexFile + " is corrupt");
+	}
+	catch (fstream::failure &)
+	{
+		delete segment.history;
+		delete segment.index;
+		throw;
+	}
+
+	segments.push_back(segment);
+}
+
+size_t HistoryStore::getNumSegments() const
+{
+	return segments.size();
+}
+
+/*
+Adds up the named player's totals over every segment.  Returns false,
+leaving out alone, if the player is in none of them.
+*/
+bool HistoryStore::summary(const std::string & name, PlayerSummary & out) const
+{
+	PlayerSummary total;
+	bool found = false;
+	for (size_t s = 0; s < segments.size(); s++)
+	{
+		const unsigned char * entry = findEntry(segments[s], name);
+		if (!entry)
+			continue;
+
+		if (!found)
+		{
+			size_t nameOffset = (size_t)getLittleEndian(entry, 4);
+			size_t nameLength = (size_t)getLittleEndian(entry + 4, 4);
+			total.name.assign(reinterpret_cast<const char *>(segments[s].names + nameOffset), nameLength);
+			found = true;
+		}
+		total.hands += (unsigned long)getLittleEndian(entry + 12, 4);
+		total.wins += (unsigned long)getLittleEndian(entry + 16, 4);
+		total.losses += (unsigned long)getLittleEndian(entry + 20, 4);
+		total.chipsWon += getLittleEndian(entry + 24, 8);
+		total.netChips += (long long)getLittleEndian(entry + 32, 8);
+	}
+
+	if (found)
+		out = total;
+	return found;
+}
+
+/*
+The name of the index that goes with a history file.
+*/
+std::string HistoryStore::indexFileName(const char historyFile[])
+{
+	return string(historyFile) + ".idx";
+}
+
+/*
+Binary-searches a segment's entries for a name, ignoring case.  Returns the
+entry, or 0 if there is none.
+*/
+const unsigned char * HistoryStore::findEntry(const Segment & segment, const std::string & name) const
+{
+	size_t low = 0;
+	size_t high = segment.numPlayers;
+	while (low < high)
+	{
+		size_t mid = low + (high - low) / 2;
+		const unsigned char * entry = segment.entries + mid * ENTRY_SIZE;
+		const char * entryName = reinterpret_cast<const char *>(segment.names + getLittleEndian(entry, 4));
+		int diff = compareUpper(entryName, (size_t)getLittleEndian(entry + 4, 4), name.data(), name.length());
+		if (diff == 0)
+			return entry;
+		if (diff < 0)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return 0;
+}
+
+size_t HistoryStore::entryPostings(const unsigned char * entry) const
+{
+	return (size_t)getLittleEndian(entry + 12, 4);
+}
+
+/*
+Decodes the record of the nth hand in an entry's postings, and gets the
+player's seat in it.
+
+Throws fstream::failure if the history does not match the index.
+*/
+void HistoryStore::readHand(const Segment & segment, const unsigned char * entry, size_t n, HandRecord & record, size_t & seat) const
+{
+	size_t firstPosting = (size_t)getLittleEndian(entry + 8, 4);
+	unsigned long long posting = getLittleEndian(segment.postings + (firstPosting + n) * POSTING_SIZE, POSTING_SIZE);
+	size_t offset = (size_t)(posting & OFFSET_MASK);
+	seat = (size_t)(posting >> SEAT_SHIFT);
+
+	const MappedFile & history = *segment.history;
+	if (offset + 4 > history.size())
+		throw fstream::failure("History does not match its index");
+	size_t length = (size_t)getLittleEndian(history.data() + offset, 4);
+	if (offset + 4 + length > history.size() || !record.decode(history.data() + offset + 4, length) ||
+		seat >= record.seats.size())
+		throw fstream::failure("History does not match its index");
+}
+
+/*
+Reads the size of the history that indexFile was built from, and how many
+bytes of it were indexed.  Returns false if indexFile is missing or is not
+an index.  Histories are only ever appended to, so the same size means the
+same records, and a larger one means the same records and then some.
+*/
+bool HistoryStore::readIndexHeader(const char indexFile[], unsigned long long & historySize, unsigned long long & bytesIndexed)
+{
+	ifstream file(indexFile, ios::in | ios::binary);
+	unsigned char header[HEADER_SIZE];
+	file.read(reinterpret_cast<char *>(header), sizeof(header));
+	if (file.gcount() != sizeof(header))
+		return false;
+	if (memcmp(header, MAGIC, sizeof(MAGIC)) != 0 || getLittleEndian(header + 4, 2) != VERSION)
+		return false;
+
+	historySize = getLittleEndian(header + 8, 8);
+	bytesIndexed = getLittleEndian(header + 16, 8);
+	return true;
+}
+
+/*
+Writes the index for the history.  If bytesIndexed is not 0, the index
+already covers the history up to there: its entries are read back, and
+only the records past it are read from the history.  Otherwise (or if
+the index turns out to be corrupt) every record is read.  A record cut
+short at the end of the history (one still being written) is left out.
+The index is written to a temporary file and renamed into place, so a
+reader never sees half an index.
+
+Throws fstream::failure if the history is not a hand-history file or is
+corrupt, or if the index cannot be written.
+*/
+void HistoryStore::buildIndex(const MappedFile & history, const std::string & indexFile, unsigned long long bytesIndexed)
+{
+	const unsigned char * data = history.data();
+	size_t size = history.size();
+	if (size < HistoryWriter::HEADER_SIZE || memcmp(data, HistoryWriter::MAGIC, sizeof(HistoryWriter::MAGIC)) != 0)
+		throw fstream::failure("Not a hand-history file");
+	if (getLittleEndian(data + 4, 2) != HistoryWriter::VERSION)
+		throw fstream::failure("Unsupported hand-history version");
+
+	map<string, PlayerTotals> players; // By upper-cased name, which is the index's order
+	size_t offset = HistoryWriter::HEADER_SIZE;
+	if (bytesIndexed > offset && bytesIndexed <= size && loadIndex(indexFile, players))
+		offset = (size_t)bytesIndexed; // Postings stay in file order, since the new records all come later
+
+	HandRecord record;
+	while (offset + 4 <= size)
+	{
+		size_t length = (size_t)getLittleEndian(data + offset, 4);
+		if (offset + 4 + length > size)
+			break; // Still being written
+		if (!record.decode(data + offset + 4, length))
+			throw fstream::failure("History file is corrupt");
+
+		for (size_t i = 0; i < record.seats.size(); i++)
+		{
+			const HandRecord::Seat & seat = record.seats[i];
+			PlayerTotals & totals = players[upperCase(seat.name)];
+			if (totals.postings.empty())
+				totals.name = seat.name;
+
+			bool won = false;
+			for (size_t w = 0; w < record.winners.size(); w++)
+			{
+				if (record.winners[w].seat == i)
+				{
+					won = true;
+					totals.chipsWon += record.winners[w].amount;
+				}
+			}
+			if (won)
+				totals.wins++;
+			else
+				totals.losses++;
+			totals.netChips += (long long)seat.finalChips - (long long)seat.startChips;
+			totals.postings.push_back((unsigned long long)offset | ((unsigned long long)i << SEAT_SHIFT));
+		}
+
+		offset += 4 + length;
+	}
+
+	unsigned long numPostings = 0;
+	unsigned long namesSize = 0;
+	for (map<string, PlayerTotals>::const_iterator iter = players.begin(); iter != players.end(); iter++)
+	{
+		numPostings += iter->second.postings.size();
+		namesSize += iter->second.name.length();
+	}
+
+	vector<unsigned char> index(HEADER_SIZE + players.size() * ENTRY_SIZE + numPostings * POSTING_SIZE + namesSize);
+	unsigned char * header = &index[0];
+	memcpy(header, MAGIC, sizeof(MAGIC));
+	putLittleEndian(header + 4, VERSION, 2);
+	putLittleEndian(header + 8, size, 8);
+	putLittleEndian(header + 16, offset, 8);
+	putLittleEndian(header + 24, players.size(), 4);
+	putLittleEndian(header + 28, numPostings, 4);
+
+	unsigned char * entry = header + HEADER_SIZE;
+	unsigned char * posting = entry + players.size() * ENTRY_SIZE;
+	unsigned char * names = posting + numPostings * POSTING_SIZE;
+	unsigned long firstPosting = 0;
+	unsigned long nameOffset = 0;
+	for (map<string, PlayerTotals>::const_iterator iter = players.begin(); iter != players.end(); iter++, entry += ENTRY_SIZE)
+	{
+		const PlayerTotals & totals = iter->second;
+		putLittleEndian(entry, nameOffset, 4);
+		putLittleEndian(entry + 4, totals.name.length(), 4);
+		putLittleEndian(entry + 8, firstPosting, 4);
+		putLittleEndian(entry + 12, totals.postings.size(), 4);
+		putLittleEndian(entry + 16, totals.wins, 4);
+		putLittleEndian(entry + 20, totals.losses, 4);
+		putLittleEndian(entry + 24, totals.chipsWon, 8);
+		putLittleEndian(entry + 32, (unsigned long long)totals.netChips, 8);
+
+		for (size_t i = 0; i < totals.postings.size(); i++, posting += POSTING_SIZE)
+			putLittleEndian(posting, totals.postings[i], POSTING_SIZE);
+		memcpy(names + nameOffset, totals.name.data(), totals.name.length());
+
+		firstPosting += totals.postings.size();
+		nameOffset += totals.name.length();
+	}
+
+	string tempFile = indexFile + ".tmp";
+	{
+		ofstream file(tempFile.c_str(), ios::out | ios::binary | ios::trunc);
+		file.write(reinterpret_cast<const char *>(&index[0]), index.size());
+		if (!file)
+			throw fstream::failure("Could not write " + tempFile);
+	}
+#ifdef _WIN32
+	remove(indexFile.c_str()); // rename() will not replace a file on Windows
+#endif
+	if (rename(tempFile.c_str(), indexFile.c_str()) != 0)
+		throw fstream::failure("Could not write " + indexFile);
+}
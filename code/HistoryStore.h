@@ -0,0 +1,129 @@
+/*
+HistoryStore.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Declares HistoryStore, a read-only store over one or more hand-history
+files (segments), for looking up a player's hands and totals without
+scanning the histories.  Every segment is memory-mapped along with a
+sidecar index (the history's file name plus ".idx"), which is built the
+first time the segment is added.  When the history has grown since, only
+the records past the bytes already indexed are read, and their postings
+and totals are merged into a new index.
+
+Index, little-endian:
+	header, 32 bytes:
+		"TPHI", u16 format version, u16 reserved,
+		u64 size of the history when indexed, u64 bytes of it indexed,
+		u32 number of players, u32 number of postings
+	one 40-byte entry per player, sorted by upper-cased name:
+		u32 name offset, u32 name length,
+		u32 first posting, u32 number of postings (hands played),
+		u32 wins, u32 losses, u64 chips won, u64 net chips (two's complement)
+	one 8-byte posting per hand per player, grouped by player, in file order:
+		bits 0-47 the record's offset in the history, bits 56-63 the seat
+	the names, as in Player::name
+
+A lookup binary-searches the entries and then reads only the postings and
+records of that player, so it touches a handful of pages however large the
+histories grow.  Names are matched ignoring case, like Game::find_player().
+*/
+
+#ifndef HISTORY_STORE_H
+#define HISTORY_STORE_H
+
+#include "HandHistory.h"
+#include "MappedFile.h"
+
+#include <string>
+#include <vector>
+
+struct PlayerSummary
+{
+	PlayerSummary() : hands(0), wins(0), losses(0), chipsWon(0), netChips(0) {}
+
+	std::string name;
+	unsigned long hands;
+	unsigned long wins; // Same as Player::wins: rounds won or split
+	unsigned long losses;
+	unsigned long long chipsWon; // Pots won, before subtracting what was paid in
+	long long netChips; // Chips at the end of each round minus at the start
+};
+
+class HistoryStore
+{
+public:
+	HistoryStore();
+	~HistoryStore();
+
+	void addSegment(const char historyFile[]);
+	size_t getNumSegments() const;
+
+	bool summary(const std::string & name, PlayerSummary & out) const;
+	template <class HandFxn>
+	unsigned long forEachHand(const std::string & name, HandFxn doWhat) const;
+
+	static std::string indexFileName(const char historyFile[]);
+
+	static const char MAGIC[4];
+	static const unsigned VERSION = 1;
+	static const size_t HEADER_SIZE = 32;
+	static const size_t ENTRY_SIZE = 40;
+	static const size_t POSTING_SIZE = 8;
+
+private:
+	// Undefined, so that no copies can be made.
+	HistoryStore(const HistoryStore & other);
+	HistoryStore & operator= (const HistoryStore & other);
+
+	struct Segment
+	{
+		MappedFile * history;
+		MappedFile * index;
+		unsigned long numPlayers;
+		const unsigned char * entries;
+		const unsigned char * postings;
+		const unsigned char * names;
+	};
+
+	const unsigned char * findEntry(const Segment & segment, const std::string & name) const;
+	void readHand(const Segment & segment, const unsigned char * entry, size_t n, HandRecord & record, size_t & seat) const;
+	size_t entryPostings(const unsigned char * entry) const;
+
+	static bool readIndexHeader(const char indexFile[], unsigned long long & historySize, unsigned long long & bytesIndexed);
+	static void buildIndex(const MappedFile & history, const std::string & indexFile, unsigned long long bytesIndexed);
+
+	std::vector<Segment> segments;
+};
+
+/*
+Calls doWhat(record, seat) for every hand the named player played, segment
+by segment and in file order, where seat is the player's seat in record.
+Returns how many hands there were.
+
+Throws fstream::failure if a history does not match its index.
+*/
+template <class HandFxn>
+unsigned long HistoryStore::forEachHand(const std::string & name, HandFxn doWhat) const
+{
+	unsigned long numHands = 0;
+	HandRecord record;
+	for (size_t s = 0; s < segments.size(); s++)
+	{
+		const unsigned char * entry = findEntry(segments[s], name);
+		if (!entry)
+			continue;
+
+		size_t numPostings = entryPostings(entry);
+		for (size_t i = 0; i < numPostings; i++)
+		{
+			size_t seat;
+			readHand(segments[s], entry, i, record, seat);
+			doWhat(static_cast<const HandRecord &>(record), seat);
+			numHands++;
+		}
+	}
+	return numHands;
+}
+
+#endif
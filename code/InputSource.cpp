@@ -0,0 +1,204 @@
+/*
+InputSource.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Defines TerminalInput, ScriptInput and QueueInput.
+*/
+
+#include "stdafx.h"
+#include "InputSource.h"
+
+#include <iostream>
+
+#ifdef _WIN32
+#include <conio.h>
+#include <io.h>
+#define isatty _isatty
+#else
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/*
+Takes one line, without its line ending, out of [data + pos, data + length).  
+Returns false if there is nothing left.
+*/
+static bool takeLine(const char * data, size_t length, size_t & pos, string & line)
+{
+	if (pos >= length)
+		return false;
+
+	size_t end = pos;
+	while (end < length && data[end] != '\n')
+		end++;
+
+	size_t lineEnd = end;
+	if (lineEnd > pos && data[lineEnd - 1] == '\r')
+		lineEnd--;
+	line.assign(data + pos, lineEnd - pos);
+
+	pos = (end < length ? end + 1 : end);
+	return true;
+}
+
+/*
+Takes the next character that is not a line ending out of 
+[data + pos, data + length), or returns END if there is none.
+*/
+static int takeKey(const char * data, size_t length, size_t & pos)
+{
+	while (pos < length && (data[pos] == '\n' || data[pos] == '\r'))
+		pos++;
+
+	if (pos >= length)
+		return InputSource::END;
+	return (unsigned char)data[pos++];
+}
+
+/*
+The keyboard, shared by everything in the process.
+*/
+InputSource & InputSource::terminal()
+{
+	static TerminalInput keyboard;
+	return keyboard;
+}
+
+TerminalInput::TerminalInput()
+	: isTerminal(isatty(0) != 0)
+{
+}
+
+/*
+Waits for one keystroke, which is not echoed.  Returns END if standard 
+input has ended.
+*/
+int TerminalInput::getKey()
+{
+	int key;
+	do
+	{
+		key = readRawKey();
+	} while (key == '\n' || key == '\r');
+
+	return key;
+}
+
+/*
+Waits for a line.  Returns false if standard input has ended.
+*/
+bool TerminalInput::getLine(std::string & line)
+{
+	if (!getline(cin, line))
+		return false;
+
+	if (line.length() > 0 && line[line.length() - 1] == '\r')
+		line.erase(line.length() - 1);
+	return true;
+}
+
+int TerminalInput::readRawKey()
+{
+#ifdef _WIN32
+	if (isTerminal)
+		return _getch();
+#else
+	if (isTerminal)
+	{
+		termios saved;
+		if (tcgetattr(0, &saved) == 0)
+		{
+			termios raw = saved;
+			raw.c_lflag &= ~(ICANON | ECHO); // One key at a time, not shown
+			raw.c_cc[VMIN] = 1;
+			raw.c_cc[VTIME] = 0;
+			tcsetattr(0, TCSANOW, &raw);
+
+			int key = cin.get();
+			tcsetattr(0, TCSANOW, &saved);
+			return (key == EOF ? END : key);
+		}
+	}
+#endif
+
+	int key = cin.get(); // A pipe or file: no modes to change
+	return (key == EOF ? END : key);
+}
+
+/*
+Opens a script of keystrokes.
+
+Throws fstream::failure if the file cannot be opened.
+*/
+ScriptInput::ScriptInput(const char fileName[])
+	: file(fileName), pos(0)
+{
+}
+
+int ScriptInput::getKey()
+{
+	return takeKey((const char *)file.data(), file.size(), pos);
+}
+
+bool ScriptInput::getLine(std::string & line)
+{
+	return takeLine((const char *)file.data(), file.size(), pos, line);
+}
+
+QueueInput::QueueInput()
+	: pos(0)
+{
+}
+
+/*
+Adds keystrokes after everything pushed so far.
+*/
+void QueueInput::push(const std::string & keys)
+{
+	if (pos > 0 && pos * 2 >= buffer.length()) // Mostly read; drop what was
+	{
+		buffer.erase(0, pos);
+		pos = 0;
+	}
+	buffer += keys;
+}
+
+/*
+How many characters are waiting to be read.
+*/
+size_t QueueInput::available() const
+{
+	return buffer.length() - pos;
+}
+
+/*
+Whether getKey() would get a key rather than END.
+*/
+bool QueueInput::hasKey() const
+{
+	return buffer.find_first_not_of("\r\n", pos) != string::npos;
+}
+
+/*
+Whether a whole line, newline and all, is waiting for getLine().
+*/
+bool QueueInput::hasLine() const
+{
+	return buffer.find('\n', pos) != string::npos;
+}
+
+int QueueInput::getKey()
+{
+	return takeKey(buffer.data(), buffer.length(), pos);
+}
+
+/*
+Takes the next line.  A last line without a newline counts as a line.
+*/
+bool QueueInput::getLine(std::string & line)
+{
+	return takeLine(buffer.data(), buffer.length(), pos, line);
+}
@@ -0,0 +1,99 @@
+/*
+InputSource.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Declares InputSource, where a Game gets keystrokes and lines of text, and 
+three kinds of it:
+	TerminalInput - the keyboard.  Keys are read without waiting for Enter 
+		and without echo, using raw mode on POSIX and _getch() on Windows.
+	ScriptInput - a file of recorded keystrokes, so that a run needs nobody 
+		at the keyboard.  The file is exactly what would have been typed: a 
+		key is one character, and a line ends with a newline.
+	QueueInput - keystrokes pushed from memory, for tests and for anything 
+		that drives a Game itself.
+Line endings are skipped when a key is wanted, as pressing Enter at a key 
+prompt does nothing.  Before each read, a Game calls expect() with the name 
+of the Player whose decision it is, or nothing if anybody may answer; only 
+a server, where every Player types on a client of their own, cares.
+*/
+
+#ifndef INPUT_SOURCE_H
+#define INPUT_SOURCE_H
+
+#include "MappedFile.h"
+
+#include <string>
+
+class InputSource
+{
+public:
+	virtual ~InputSource() {}
+
+	virtual int getKey() = 0;
+	virtual bool getLine(std::string & line) = 0;
+	virtual void expect(const std::string & /* seat */) {}
+
+	static InputSource & terminal();
+
+	static const int END = -1; // From getKey(), when there is no more input
+};
+
+class TerminalInput : public InputSource
+{
+public:
+	TerminalInput();
+
+	int getKey();
+	bool getLine(std::string & line);
+
+private:
+	// Undefined, so that no copies can be made.
+	TerminalInput(const TerminalInput & other);
+	TerminalInput & operator= (const TerminalInput & other);
+
+	int readRawKey();
+
+	bool isTerminal; // False if standard input is a pipe or file
+};
+
+class ScriptInput : public InputSource
+{
+public:
+	ScriptInput(const char fileName[]);
+
+	int getKey();
+	bool getLine(std::string & line);
+
+private:
+	// Undefined, so that no copies can be made.
+	ScriptInput(const ScriptInput & other);
+	ScriptInput & operator= (const ScriptInput & other);
+
+	MappedFile file;
+	size_t pos;
+};
+
+class QueueInput : public InputSource
+{
+public:
+	QueueInput();
+
+	void push(const std::string & keys);
+	size_t available() const;
+	bool hasKey() const;
+	bool hasLine() const;
+
+	int getKey();
+	bool getLine(std::string & line);
+
+private:
+	// Undefined, so that no copies can be made.
+	QueueInput(const QueueInput & other);
+	QueueInput & operator= (const QueueInput & other);
+
+	std::string buffer;
+	size_t pos; // Everything before this has been read
+};
+
+#endif
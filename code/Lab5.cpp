@@ -8,9 +8,14 @@ Main entry point.
 
 #include "stdafx.h"
 #include "Game.h"
+#include "GameException.h"
+#include "Renderer.h"
+#include "InputSource.h"
 
 #include <iostream>
-#include <conio.h>
+#include <fstream>
+#include <memory>
+#include <stdlib.h>
 
 using namespace std;
 
@@ -22,49 +27,124 @@ enum MenuChoice
 	QUIT = '4'
 };
 
-char mainMenu()
+/*
+Prints the menu and waits for a valid choice.  Quits if the input runs out.
+*/
+char mainMenu(Renderer & screen, InputSource & input)
 {
-	cout << "Welcome to text poker!  Main menu:\n" <<
+	screen.at(NORMAL) << "Welcome to text poker!  Main menu:\n" <<
 		(char)FIVE_CARD_DRAW << " - play Five Card Draw\n" <<
 		(char)SEVEN_CARD_STUD << " - play Seven Card Stud\n" <<
 		(char)TEXAS_HOLD_EM << " - play Texas Hold 'Em\n" <<
-		(char)QUIT << " - Quit" << endl;
-	cout << "-> ";
+		(char)QUIT << " - Quit\n";
+	screen.at(NORMAL) << "-> ";
 
-	char ans = toupper(_getch());
-	cout << ans << endl;
-	while (ans < FIVE_CARD_DRAW || ans > QUIT)
+	char ans = '\0';
+	while (true)
 	{
-		cout << "Choose a valid option.\n-> ";
-		ans = toupper(_getch());
-		cout << ans << endl;
+		screen.present();
+		int key = input.getKey();
+		if (key == InputSource::END)
+			ans = QUIT;
+		else
+			ans = (char)toupper(key);
+		screen.at(NORMAL) << ans << '\n';
+
+		if (ans >= FIVE_CARD_DRAW && ans <= QUIT)
+			break;
+		screen.at(NORMAL) << "Choose a valid option.\n-> ";
 	}
 
+	screen.present(); // Before the Game prints anything
 	return ans;
 }
 
+/*
+Usage: Lab5 [--scenario file] [--history file] [--script file] [--seed n] [--quiet | --silent]
+With a scenario file, every round is dealt from the file instead of 
+shuffling.  With a history file, every round is appended to it.  With a 
+script file, keystrokes are read from it instead of the keyboard, and the 
+program quits when it runs out.  Quiet prints only results and problems, 
+not tables or prompts; silent prints nothing, for scripted runs.  With a 
+seed, every game shuffles the same way each run, so a script replays 
+exactly.
+*/
 int main (int argc, char * argv[])
 {
+	const char * scenarioFile = 0;
+	const char * historyFile = 0;
+	const char * scriptFile = 0;
+	const char * seed = 0;
+	Verbosity verbosity = NORMAL;
+	for (int i = 1; i < argc; i++)
+	{
+		string arg(argv[i]);
+		if (arg == "--scenario" && i + 1 < argc)
+			scenarioFile = argv[++i];
+		else if (arg == "--history" && i + 1 < argc)
+			historyFile = argv[++i];
+		else if (arg == "--script" && i + 1 < argc)
+			scriptFile = argv[++i];
+		else if (arg == "--seed" && i + 1 < argc)
+			seed = argv[++i];
+		else if (arg == "--quiet")
+			verbosity = QUIET;
+		else if (arg == "--silent")
+			verbosity = SILENT;
+		else
+		{
+			cout << "Usage: " << argv[0] << " [--scenario file] [--history file] [--script file] [--seed n] [--quiet | --silent]" << endl;
+			return 1;
+		}
+	}
+
+	unique_ptr<InputSource> script;
+	if (scriptFile)
+	{
+		try
+		{
+			script.reset(new ScriptInput(scriptFile));
+		}
+		catch (fstream::failure & e)
+		{
+			cout << e.what() << endl;
+			return 1;
+		}
+	}
+	InputSource & input = (script ? *script : InputSource::terminal());
+
+	Renderer screen(verbosity);
+
 	do
 	{
-		char ans = mainMenu();
-		switch (ans)
+		char ans = mainMenu(screen, input);
+		try
 		{
-		case FIVE_CARD_DRAW:
-			Game::start_game("FiveCardDraw");
-			break;
-		case SEVEN_CARD_STUD:
-			Game::start_game("SevenCardStud");
-			break;
-		case TEXAS_HOLD_EM:
-			Game::start_game("TexasHoldEm");
-			break;
-		case QUIT:
-			return 0;
+			switch (ans)
+			{
+			case FIVE_CARD_DRAW:
+				Game::start_game("FiveCardDraw", scenarioFile, historyFile, verbosity, &input);
+				break;
+			case SEVEN_CARD_STUD:
+				Game::start_game("SevenCardStud", scenarioFile, historyFile, verbosity, &input);
+				break;
+			case TEXAS_HOLD_EM:
+				Game::start_game("TexasHoldEm", scenarioFile, historyFile, verbosity, &input);
+				break;
+			case QUIT:
+				return 0;
+			}
+		}
+		catch (GameException & e)
+		{
+			screen.at(QUIET) << e.what() << '\n';
+			continue;
 		}
 		
+		if (seed)
+			Game::instance()->setSeed(strtoull(seed, 0, 10));
 		Game::instance()->play();
-		cout << endl;
+		screen.at(NORMAL) << '\n';
 
 	} while (true);
 
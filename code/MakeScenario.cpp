@@ -0,0 +1,181 @@
+/*
+MakeScenario.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Entry point for the scenario maker, built as its own executable.  Writes a
+scenario file (see Scenario.h) for Lab5, Sim and Bench to deal from, then
+reads it back and checks that every deal survived the trip.
+
+Usage: MakeScenario [--variant name] out deckFile...
+       MakeScenario [--variant name] --sim seed table hands out
+The first form makes one deal of each deck file, which lists cards the way
+Deck::load() reads them, top card first.  Cards a deck leaves out are
+dealt after it in standard order.  The second form writes the deals that
+Sim would shuffle for the first hands of the specified table with the
+specified seed, so that
+	Sim --tables 1 --seed s --scenario out
+plays what Sim --tables 1 --seed s plays when out was made with
+--sim s 0 n.  The variant is FiveCardDraw, SevenCardStud or TexasHoldEm;
+without one, the scenario can be dealt by any variant.
+Exits with 1 if a deck cannot be read or the file does not read back the
+same.
+*/
+
+#include "stdafx.h"
+#include "Scenario.h"
+#include "Deck.h"
+#include "TableState.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+
+/*
+Where the deals come from: either deck files or Sim's shuffles.
+*/
+struct DealSource
+{
+	vector<const char *> deckFiles;
+	unsigned long long seed;
+	unsigned table;
+	unsigned long long numHands;
+
+	unsigned long long size() const
+	{
+		return deckFiles.empty() ? numHands : deckFiles.size();
+	}
+
+	/*
+	Puts deal number n in indices and sets numCards.
+
+	Throws fstream::failure if a deck file cannot be read.
+	*/
+	void get(unsigned long long n, unsigned char indices[], size_t & numCards) const
+	{
+		if (deckFiles.empty())
+		{
+			TableState state;
+			state.reset(2, 0);
+			state.dealFor(seed, table, n);
+			memcpy(indices, state.deck, Card::NUM_CARDS);
+			numCards = Card::NUM_CARDS;
+			return;
+		}
+
+		Deck deck(deckFiles[(size_t)n]);
+		numCards = min((size_t)deck.size(), Scenario::MAX_DEAL_CARDS);
+		for (size_t i = 0; i < numCards; i++)
+			indices[i] = (unsigned char)deck[i].toIndex();
+	}
+
+	string describe(unsigned long long n) const
+	{
+		if (deckFiles.empty())
+			return "hand " + to_string(n);
+		return deckFiles[(size_t)n];
+	}
+};
+
+int main(int argc, char * argv[])
+{
+	ScenarioVariant variant = SCENARIO_ANY;
+	DealSource source;
+	source.seed = 0;
+	source.table = 0;
+	source.numHands = 0;
+	bool fromSim = false;
+	bool usage = false;
+	int argNum = 1;
+	for (; argNum < argc && argv[argNum][0] == '-'; argNum++)
+	{
+		string arg(argv[argNum]);
+		if (arg == "--variant" && argNum + 1 < argc)
+		{
+			string name(argv[++argNum]);
+			if (name == "FiveCardDraw")
+				variant = SCENARIO_FIVE_CARD_DRAW;
+			else if (name == "SevenCardStud")
+				variant = SCENARIO_SEVEN_CARD_STUD;
+			else if (name == "TexasHoldEm")
+				variant = SCENARIO_TEXAS_HOLD_EM;
+			else
+				usage = true;
+		}
+		else if (arg == "--sim" && argNum + 3 < argc)
+		{
+			source.seed = strtoull(argv[++argNum], 0, 10);
+			source.table = (unsigned)strtoul(argv[++argNum], 0, 10);
+			source.numHands = strtoull(argv[++argNum], 0, 10);
+			fromSim = true;
+		}
+		else
+			usage = true;
+	}
+	if (usage || argNum >= argc || (fromSim ? argc - argNum != 1 : argc - argNum < 2))
+	{
+		cout << "Usage: " << argv[0] << " [--variant name] out deckFile..." << endl;
+		cout << "       " << argv[0] << " [--variant name] --sim seed table hands out" << endl;
+		cout << "Variants are FiveCardDraw, SevenCardStud and TexasHoldEm." << endl;
+		return 2;
+	}
+
+	const char * outFile = argv[argNum++];
+	for (; argNum < argc; argNum++)
+		source.deckFiles.push_back(argv[argNum]);
+
+	unsigned char indices[Scenario::MAX_DEAL_CARDS];
+	size_t numCards;
+	unsigned long long n = 0;
+	try
+	{
+		ScenarioWriter writer(outFile, variant);
+		for (; n < source.size(); n++)
+		{
+			source.get(n, indices, numCards);
+			writer.addDeal(indices, numCards);
+		}
+		writer.close();
+	}
+	catch (invalid_argument & e)
+	{
+		cout << source.describe(n) << ": " << e.what() << endl;
+		return 1;
+	}
+	catch (fstream::failure & e)
+	{
+		cout << (n < source.size() ? source.describe(n) + ": " : string()) << e.what() << endl;
+		return 1;
+	}
+
+	// Read it back, deal by deal
+	try
+	{
+		ScenarioReader reader(outFile);
+		if (reader.getVariant() != variant || reader.getNumDeals() != source.size())
+			throw fstream::failure("The header did not read back the same");
+
+		unsigned char readBack[Scenario::MAX_DEAL_CARDS];
+		size_t numRead;
+		for (n = 0; n < source.size(); n++)
+		{
+			source.get(n, indices, numCards);
+			if (!reader.nextDeal(readBack, numRead) || numRead != numCards || memcmp(readBack, indices, numCards) != 0)
+				throw fstream::failure(source.describe(n) + " did not read back the same");
+		}
+		if (reader.nextDeal(readBack, numRead))
+			throw fstream::failure("There are more deals than were written");
+	}
+	catch (fstream::failure & e)
+	{
+		cout << outFile << ": " << e.what() << endl;
+		return 1;
+	}
+
+	cout << "Wrote " << source.size() << " deal(s) to " << outFile << " and read them back unchanged." << endl;
+	return 0;
+}
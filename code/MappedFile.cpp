@@ -0,0 +1,109 @@
+/*
+MappedFile.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Defines MappedFile, with CreateFileMapping on Windows and mmap elsewhere.
+*/
+
+#include "stdafx.h"
+#include "MappedFile.h"
+
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/*
+Maps the whole of the specified file.  The mapping is a snapshot of the
+file's length when it was opened; later appends are not visible.
+
+Throws fstream::failure if the file cannot be opened or mapped.
+*/
+MappedFile::MappedFile(const char fileName[])
+	: view(0), length(0)
+{
+#ifdef _WIN32
+	mapping = 0;
+	HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+	if (file == INVALID_HANDLE_VALUE)
+		throw fstream::failure("Could not open " + string(fileName));
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize))
+	{
+		CloseHandle(file);
+		throw fstream::failure("Could not get the size of " + string(fileName));
+	}
+	length = (size_t)fileSize.QuadPart;
+
+	if (length > 0)
+	{
+		mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+		if (mapping)
+			view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	}
+	CloseHandle(file); // The mapping keeps the file open
+
+	if (length > 0 && !view)
+	{
+		if (mapping)
+			CloseHandle(mapping);
+		throw fstream::failure("Could not map " + string(fileName));
+	}
+#else
+	int fd = open(fileName, O_RDONLY);
+	if (fd < 0)
+		throw fstream::failure("Could not open " + string(fileName));
+
+	struct stat info;
+	if (fstat(fd, &info) != 0)
+	{
+		close(fd);
+		throw fstream::failure("Could not get the size of " + string(fileName));
+	}
+	length = (size_t)info.st_size;
+
+	if (length > 0)
+	{
+		view = mmap(0, length, PROT_READ, MAP_SHARED, fd, 0);
+		if (view == MAP_FAILED)
+			view = 0;
+	}
+	close(fd); // The mapping keeps the file open
+
+	if (length > 0 && !view)
+		throw fstream::failure("Could not map " + string(fileName));
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+	if (view)
+		UnmapViewOfFile(view);
+	if (mapping)
+		CloseHandle(mapping);
+#else
+	if (view)
+		munmap(view, length);
+#endif
+}
+
+const unsigned char * MappedFile::data() const
+{
+	return static_cast<const unsigned char *>(view);
+}
+
+size_t MappedFile::size() const
+{
+	return length;
+}
@@ -0,0 +1,37 @@
+/*
+MappedFile.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Declares MappedFile, a whole file mapped read-only into memory.  Pages are
+read from disk only when they are touched, so a lookup in a large file
+costs only the pages it reads.
+*/
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <stddef.h>
+
+class MappedFile
+{
+public:
+	MappedFile(const char fileName[]);
+	~MappedFile();
+
+	const unsigned char * data() const;
+	size_t size() const;
+
+private:
+	// Undefined, so that no copies can be made.
+	MappedFile(const MappedFile & other);
+	MappedFile & operator= (const MappedFile & other);
+
+	void * view; // 0 if the file is empty
+	size_t length;
+#ifdef _WIN32
+	void * mapping; // A HANDLE
+#endif
+};
+
+#endif
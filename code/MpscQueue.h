@@ -0,0 +1,101 @@
+/*
+MpscQueue.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Declares and defines MpscQueue, an unbounded lock-free queue for any
+number of producer threads and one consumer thread.  push() is one atomic
+exchange and one store, and never waits for the consumer or for other
+producers.  Each node is a linked list entry; the consumer always holds one
+already-consumed node (initially a stub) as the tail.
+
+Only one thread at a time may call pop().  T must be default
+constructible.
+*/
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+#include <utility>
+
+template <class T>
+class MpscQueue
+{
+public:
+	MpscQueue();
+	~MpscQueue();
+
+	void push(const T & value);
+	bool pop(T & value);
+
+private:
+	// Undefined, so that no copies can be made.
+	MpscQueue(const MpscQueue & other);
+	MpscQueue & operator= (const MpscQueue & other);
+
+	struct Node
+	{
+		Node() : next(0) {}
+		explicit Node(const T & value) : next(0), value(value) {}
+
+		std::atomic<Node *> next;
+		T value;
+	};
+
+	std::atomic<Node *> head; // Most recently pushed; producers swap themselves in
+	Node * tail; // Consumed; only touched by pop()
+};
+
+template <class T>
+MpscQueue<T>::MpscQueue()
+	: head(new Node()), tail(0)
+{
+	tail = head.load(std::memory_order_relaxed);
+}
+
+/*
+Frees every node.  No other thread may be using the queue.
+*/
+template <class T>
+MpscQueue<T>::~MpscQueue()
+{
+	while (tail)
+	{
+		Node * next = tail->next.load(std::memory_order_relaxed);
+		delete tail;
+		tail = next;
+	}
+}
+
+/*
+Adds a copy of value to the back of the queue.  Safe to call from any
+number of threads at once.
+*/
+template <class T>
+void MpscQueue<T>::push(const T & value)
+{
+	Node * node = new Node(value);
+	Node * previous = head.exchange(node, std::memory_order_acq_rel);
+	previous->next.store(node, std::memory_order_release);
+}
+
+/*
+Moves the front of the queue into value.  Returns false if the queue is
+empty, or if the next producer has not finished linking its node yet; try
+again later in that case.
+*/
+template <class T>
+bool MpscQueue<T>::pop(T & value)
+{
+	Node * next = tail->next.load(std::memory_order_acquire);
+	if (!next)
+		return false;
+
+	value = std::move(next->value);
+	delete tail;
+	tail = next; // next's value is moved-from; it is the new stub
+	return true;
+}
+
+#endif
@@ -0,0 +1,238 @@
+/*
+PersistenceService.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Defines PersistenceService and its writer thread.
+*/
+
+#include "stdafx.h"
+#include "PersistenceService.h"
+
+#include <unordered_map>
+#include <functional>
+#include <fstream>
+#include <chrono>
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+	string upperCase(const string & str)
+	{
+		string upper(str);
+		for (size_t i = 0; i < upper.length(); i++)
+			upper[i] = (char)toupper((unsigned char)upper[i]);
+		return upper;
+	}
+}
+
+/*
+Starts the writer thread.  The store must outlive this service.
+*/
+PersistenceService::PersistenceService(PlayerStore & store)
+	: store(store), pushed(0), applied(0), synced(0), playersSaved(0), waiters(0), flushWaiters(0),
+	stopping(false), failed(false)
+{
+	thread = std::thread(&PersistenceService::run, this);
+}
+
+/*
+Saves and syncs everything that was pushed, then stops the writer thread.
+*/
+PersistenceService::~PersistenceService()
+{
+	{
+		lock_guard<mutex> guard(lock);
+		stopping = true;
+	}
+	wake.notify_one();
+	thread.join();
+}
+
+/*
+Queues a snapshot of p's wins, losses and chips.  Never waits on the
+disk, and waits on the writer thread only while it erases one snapshot
+from the same stripe.  Safe to call from any number of tables at once.
+*/
+void PersistenceService::push(const Player & p)
+{
+	Snapshot snapshot;
+	snapshot.name = p.name;
+	snapshot.wins = p.wins;
+	snapshot.losses = p.losses;
+	snapshot.chips = p.chips;
+	snapshot.number = pushed.fetch_add(1, memory_order_relaxed) + 1; // Before the push, so that a waiter's target covers it
+
+	{
+		string upperName = upperCase(p.name);
+		Stripe & stripe = stripeFor(upperName);
+		lock_guard<mutex> guard(stripe.lock);
+		Snapshot & newest = stripe.unsaved[upperName];
+		if (newest.number < snapshot.number)
+			newest = snapshot;
+	}
+	queue.push(snapshot);
+}
+
+/*
+Loads the player with the specified name (ignoring case) into p as the
+store will have it once everything pushed so far is saved: from the
+newest snapshot not yet saved, or else from the store.  Returns false,
+leaving p alone, if neither has the player.  Never waits on the writer
+thread.
+*/
+bool PersistenceService::load(const std::string & name, Player & p) const
+{
+	{
+		string upperName = upperCase(name);
+		const Stripe & stripe = stripeFor(upperName);
+		lock_guard<mutex> guard(stripe.lock);
+		unordered_map<string, Snapshot>::const_iterator found = stripe.unsaved.find(upperName);
+		if (found != stripe.unsaved.end())
+		{
+			p.name = found->second.name;
+			p.wins = found->second.wins;
+			p.losses = found->second.losses;
+			p.chips = found->second.chips;
+			return true;
+		}
+	}
+
+	return store.load(name, p); // Has every snapshot that has left unsaved
+}
+
+/*
+Waits until every snapshot pushed so far is saved to the store, so that
+PlayerStore::load() sees it.  Does not wait for the disk.
+*/
+void PersistenceService::drain()
+{
+	waitFor(false);
+}
+
+/*
+Waits until every snapshot pushed so far is saved and synced to disk.
+
+Throws fstream::failure if the store could not write.
+*/
+void PersistenceService::flush()
+{
+	waitFor(true);
+}
+
+unsigned long PersistenceService::getSnapshotsPushed() const
+{
+	return pushed.load(memory_order_relaxed);
+}
+
+unsigned long PersistenceService::getPlayersSaved() const
+{
+	lock_guard<mutex> guard(lock);
+	return playersSaved;
+}
+
+PersistenceService::Stripe & PersistenceService::stripeFor(const string & upperName)
+{
+	return stripes[(hash<string>()(upperName) >> 7) % STRIPES]; // Not the low bits, which the stripe's own table uses
+}
+
+const PersistenceService::Stripe & PersistenceService::stripeFor(const string & upperName) const
+{
+	return stripes[(hash<string>()(upperName) >> 7) % STRIPES];
+}
+
+void PersistenceService::waitFor(bool durable)
+{
+	unique_lock<mutex> guard(lock);
+	unsigned long target = pushed.load(memory_order_relaxed);
+	waiters++;
+	if (durable)
+		flushWaiters++;
+	wake.notify_one();
+
+	done.wait(guard, [&] { return (durable && failed) || (durable ? synced : applied) >= target; });
+	waiters--;
+	if (durable)
+		flushWaiters--;
+
+	if (durable && failed)
+		throw fstream::failure("Could not save players");
+}
+
+/*
+The writer thread.  Every PERIOD_MILLISECONDS, or at once if somebody is
+waiting, takes everything off the queue, keeps the newest snapshot of each
+player, and saves those to the store.  Asks the store to sync if somebody
+is in flush() or the service is stopping.
+*/
+void PersistenceService::run()
+{
+	unique_lock<mutex> guard(lock);
+	while (true)
+	{
+		wake.wait_for(guard, chrono::milliseconds(PERIOD_MILLISECONDS), [this] { return stopping || waiters > 0; });
+		bool stop = stopping;
+		bool syncing = stop || flushWaiters > 0;
+		guard.unlock();
+
+		unordered_map<string, Snapshot> newest;
+		unsigned long count = 0;
+		Snapshot snapshot;
+		while (queue.pop(snapshot))
+		{
+			Snapshot & kept = newest[upperCase(snapshot.name)]; // As the store and unsaved tell names apart
+			if (kept.number < snapshot.number)
+				kept = snapshot;
+			count++;
+		}
+
+		for (unordered_map<string, Snapshot>::const_iterator iter = newest.begin(); iter != newest.end(); iter++)
+		{
+			const Snapshot & latest = iter->second;
+			try
+			{
+				store.save(latest.name, latest.wins, latest.losses, latest.chips);
+			}
+			catch (invalid_argument &) {} // Name too long; Game does not let these join
+		}
+
+		for (unordered_map<string, Snapshot>::const_iterator iter = newest.begin(); iter != newest.end(); iter++)
+		{
+			Stripe & stripe = stripeFor(iter->first);
+			lock_guard<mutex> stripeGuard(stripe.lock); // One entry at a time, so push() never waits long
+			unordered_map<string, Snapshot>::iterator found = stripe.unsaved.find(iter->first);
+			if (found != stripe.unsaved.end() && found->second.number <= iter->second.number) // Not pushed again since
+				stripe.unsaved.erase(found);
+		}
+
+		bool ok = true;
+		if (syncing)
+		{
+			try
+			{
+				store.flush();
+			}
+			catch (fstream::failure &)
+			{
+				ok = false;
+			}
+		}
+
+		guard.lock();
+		applied += count;
+		playersSaved += newest.size();
+		if (syncing)
+		{
+			if (ok)
+				synced = applied;
+			else
+				failed = true;
+		}
+		done.notify_all();
+
+		if (stop && applied == pushed.load(memory_order_relaxed))
+			break;
+	}
+}
@@ -0,0 +1,98 @@
+/*
+PersistenceService.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Declares PersistenceService, which saves Players to a PlayerStore in the
+background.  Tables push a snapshot of a Player whenever its wins, losses
+or chips change, and a table never waits on the store or the disk.  A
+single writer thread empties a lock-free queue of snapshots every
+PERIOD_MILLISECONDS, keeps only the newest snapshot of each player, and
+saves those to the store, which syncs them to its log.
+
+Until a snapshot is saved, the newest one of each player is also kept in
+a map, so that load() can find a player who left a moment ago without
+waiting for the writer thread.  The map is split into STRIPES stripes by
+name, as in PlayerRegistry, each with its own lock.  push() holds one
+stripe's lock to copy one snapshot in, and the writer thread holds it to
+erase one saved snapshot, so tables pushing different players rarely
+wait on each other, and never on the store.
+*/
+
+#ifndef PERSISTENCE_SERVICE_H
+#define PERSISTENCE_SERVICE_H
+
+#include "Player.h"
+#include "PlayerStore.h"
+#include "MpscQueue.h"
+
+#include <string>
+#include <unordered_map>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class PersistenceService
+{
+public:
+	PersistenceService(PlayerStore & store);
+	~PersistenceService();
+
+	void push(const Player & p);
+	bool load(const std::string & name, Player & p) const;
+	void drain();
+	void flush();
+
+	unsigned long getSnapshotsPushed() const;
+	unsigned long getPlayersSaved() const;
+
+	static const size_t STRIPES = 64;
+
+private:
+	// Undefined, so that no copies can be made.
+	PersistenceService(const PersistenceService & other);
+	PersistenceService & operator= (const PersistenceService & other);
+
+	struct Snapshot
+	{
+		std::string name;
+		unsigned wins;
+		unsigned losses;
+		ChipAmt chips;
+		unsigned long number; // Counts pushes, from 1
+	};
+
+	struct Stripe // Padded rather than alignas(64), since the service itself is made with new
+	{
+		mutable std::mutex lock; // Only for unsaved
+		std::unordered_map<std::string, Snapshot> unsaved; // Newest snapshot of each player not yet saved, by upper-cased name
+		char padding[64]; // Keeps neighbours' locks off this one's cache line
+	};
+
+	void waitFor(bool durable);
+	void run();
+	Stripe & stripeFor(const std::string & upperName);
+	const Stripe & stripeFor(const std::string & upperName) const;
+
+	PlayerStore & store;
+	MpscQueue<Snapshot> queue;
+	Stripe stripes[STRIPES];
+	std::atomic<unsigned long> pushed; // Snapshots
+	unsigned long applied; // Snapshots saved to the store (in memory)
+	unsigned long synced; // Snapshots the store has synced
+	unsigned long playersSaved; // After coalescing
+	unsigned waiters; // Threads in drain() or flush()
+	unsigned flushWaiters; // Threads in flush()
+	bool stopping;
+	bool failed;
+
+	mutable std::mutex lock; // For the counters above and for waking; never taken by push()
+	std::condition_variable wake; // Signals run()
+	std::condition_variable done; // Signals drain() and flush()
+	std::thread thread;
+
+	static const unsigned PERIOD_MILLISECONDS = 100;
+};
+
+#endif
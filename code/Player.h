@@ -16,7 +16,6 @@ typedef unsigned long ChipAmt;
 struct Player
 {
 	Player(const char * name);
-	int saveToFile();
 
 	std::string name;
 	Hand hand;
@@ -26,7 +25,6 @@ struct Player
 	ChipAmt amtPaid;
 	bool inRound;
 
-	static const int SAVE_ERR = 1;
 	static const ChipAmt DEFAULT_CHIPS = 20;
 	static bool compHands(Player * one, Player * two);
 };
@@ -0,0 +1,105 @@
+/*
+PlayerRegistry.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Defines PlayerRegistry.
+*/
+
+#include "stdafx.h"
+#include "PlayerRegistry.h"
+
+#include <functional>
+#include <ctype.h>
+
+using namespace std;
+
+PlayerRegistry::Key::Key(const std::string & name)
+	: folded(name)
+{
+	for (size_t i = 0; i < folded.length(); i++)
+		folded[i] = (char)toupper((unsigned char)folded[i]);
+	hash = std::hash<string>()(folded);
+}
+
+/*
+The registry shared by every table in the process.
+*/
+PlayerRegistry & PlayerRegistry::global()
+{
+	static PlayerRegistry registry;
+	return registry;
+}
+
+PlayerRegistry::PlayerRegistry() {}
+
+/*
+Records that p is seated at the specified table.  Returns false, changing
+nothing, if a player by that name (ignoring case) is already seated
+anywhere.
+*/
+bool PlayerRegistry::add(const Key & key, Player * p, unsigned tableId)
+{
+	Stripe & stripe = stripeFor(key);
+	PlayerLocation location = {p, tableId};
+
+	lock_guard<mutex> guard(stripe.lock);
+	return stripe.players.insert(make_pair(key, location)).second;
+}
+
+/*
+Forgets the player by that name, if it is p.  Returns false if it is not.
+*/
+bool PlayerRegistry::remove(const Key & key, const Player * p)
+{
+	Stripe & stripe = stripeFor(key);
+
+	lock_guard<mutex> guard(stripe.lock);
+	unordered_map<Key, PlayerLocation, KeyHash>::iterator found = stripe.players.find(key);
+	if (found == stripe.players.end() || found->second.player != p)
+		return false;
+
+	stripe.players.erase(found);
+	return true;
+}
+
+/*
+Finds where the player by that name is seated.  Returns false if nowhere.
+*/
+bool PlayerRegistry::find(const Key & key, PlayerLocation & out) const
+{
+	const Stripe & stripe = stripeFor(key);
+
+	lock_guard<mutex> guard(stripe.lock);
+	unordered_map<Key, PlayerLocation, KeyHash>::const_iterator found = stripe.players.find(key);
+	if (found == stripe.players.end())
+		return false;
+
+	out = found->second;
+	return true;
+}
+
+/*
+How many players are seated, in all.  Locks every stripe in turn, so the
+count may be slightly out of date by the time it is returned.
+*/
+size_t PlayerRegistry::size() const
+{
+	size_t total = 0;
+	for (size_t i = 0; i < STRIPES; i++)
+	{
+		lock_guard<mutex> guard(stripes[i].lock);
+		total += stripes[i].players.size();
+	}
+	return total;
+}
+
+PlayerRegistry::Stripe & PlayerRegistry::stripeFor(const Key & key)
+{
+	return stripes[(key.hash >> 7) % STRIPES]; // Not the low bits, which the stripe's own table uses
+}
+
+const PlayerRegistry::Stripe & PlayerRegistry::stripeFor(const Key & key) const
+{
+	return stripes[(key.hash >> 7) % STRIPES];
+}
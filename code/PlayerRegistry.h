@@ -0,0 +1,76 @@
+/*
+PlayerRegistry.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Declares PlayerRegistry, which knows every Player seated at any table in
+the process and which table each one is at.  Names are matched ignoring
+case, like strComp_ignoreCase().  A Key folds and hashes a name once;
+lookups with it are O(1) however many players are connected.
+
+The registry is split into STRIPES independent hash tables, each with its
+own lock, chosen by the Key's hash.  Table threads looking up different
+players almost never wait for each other.
+*/
+
+#ifndef PLAYER_REGISTRY_H
+#define PLAYER_REGISTRY_H
+
+#include "Player.h"
+
+#include <string>
+#include <unordered_map>
+#include <mutex>
+
+struct PlayerLocation
+{
+	Player * player;
+	unsigned tableId;
+};
+
+class PlayerRegistry
+{
+public:
+	// A name, upper-cased and hashed once
+	struct Key
+	{
+		explicit Key(const std::string & name);
+		bool operator == (const Key & other) const { return hash == other.hash && folded == other.folded; }
+
+		std::string folded;
+		size_t hash;
+	};
+
+	static PlayerRegistry & global();
+
+	bool add(const Key & key, Player * p, unsigned tableId);
+	bool remove(const Key & key, const Player * p);
+	bool find(const Key & key, PlayerLocation & out) const;
+	size_t size() const;
+
+	static const size_t STRIPES = 64;
+
+private:
+	PlayerRegistry();
+	// Undefined, so that no copies can be made.
+	PlayerRegistry(const PlayerRegistry & other);
+	PlayerRegistry & operator= (const PlayerRegistry & other);
+
+	struct KeyHash
+	{
+		size_t operator() (const Key & key) const { return key.hash; }
+	};
+
+	struct alignas(64) Stripe // A cache line each, so that stripes do not share one
+	{
+		mutable std::mutex lock;
+		std::unordered_map<Key, PlayerLocation, KeyHash> players;
+	};
+
+	Stripe & stripeFor(const Key & key);
+	const Stripe & stripeFor(const Key & key) const;
+
+	Stripe stripes[STRIPES];
+};
+
+#endif
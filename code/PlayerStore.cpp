@@ -0,0 +1,457 @@
+/*
+PlayerStore.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Defines PlayerStore, its write-ahead log, and its background sync thread.
+*/
+
+#include "stdafx.h"
+#include "PlayerStore.h"
+
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <string.h>
+#include <ctype.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+const char PlayerStore::DEFAULT_FILE[] = "players.db";
+
+namespace
+{
+	const char MAGIC[4] = {'T', 'P', 'P', 'S'};
+	const unsigned VERSION = 1;
+
+	void putLittleEndian(unsigned char * bytes, unsigned long long value, size_t numBytes)
+	{
+		for (size_t i = 0; i < numBytes; i++)
+			bytes[i] = (unsigned char)(value >> (8 * i));
+	}
+
+	unsigned long long getLittleEndian(const unsigned char * bytes, size_t numBytes)
+	{
+		unsigned long long value = 0;
+		for (size_t i = 0; i < numBytes; i++)
+			value |= (unsigned long long)bytes[i] << (8 * i);
+		return value;
+	}
+
+	string upperCase(const string & str)
+	{
+		string upper(str);
+		for (size_t i = 0; i < upper.length(); i++)
+			upper[i] = (char)toupper((unsigned char)upper[i]);
+		return upper;
+	}
+
+	// FNV-1a
+	unsigned long checksum(const unsigned char * bytes, size_t length)
+	{
+		unsigned long hash = 2166136261UL;
+		for (size_t i = 0; i < length; i++)
+			hash = ((hash ^ bytes[i]) * 16777619UL) & 0xFFFFFFFFUL;
+		return hash;
+	}
+
+	/*
+	Flushes a file and waits until the operating system has it on disk.
+	Returns false on failure.
+	*/
+	bool syncFile(FILE * file)
+	{
+		if (fflush(file) != 0)
+			return false;
+#ifdef _WIN32
+		return _commit(_fileno(file)) == 0;
+#else
+		return fsync(fileno(file)) == 0;
+#endif
+	}
+
+	/*
+	Reads a whole file.  Returns false if it does not exist.
+	*/
+	bool readWholeFile(const string & fileName, vector<unsigned char> & contents)
+	{
+		ifstream file(fileName.c_str(), ios::in | ios::binary | ios::ate);
+		if (!file)
+			return false;
+
+		contents.resize((size_t)file.tellg());
+		file.seekg(0);
+		if (!contents.empty())
+			file.read(reinterpret_cast<char *>(&contents[0]), contents.size());
+		if ((size_t)file.gcount() != contents.size())
+			throw fstream::failure("Could not read " + fileName);
+		return true;
+	}
+}
+
+/*
+Opens the store in the specified file, creating it if there is none, and
+replays its log.  Starts the sync thread.
+
+Throws fstream::failure if the store cannot be opened or is corrupt.
+*/
+PlayerStore::PlayerStore(const char fileName[])
+	: fileName(fileName), logName(string(fileName) + ".wal"), store(0), log(0), saved(0), synced(0), logSize(0),
+	flushRequested(false), stopping(false), failed(false)
+{
+	try
+	{
+		readStore();
+		replayLog();
+
+		if (!dirty.empty())
+		{
+			if (!checkpoint())
+				throw fstream::failure("Could not update " + this->fileName);
+		}
+		else
+		{
+			log = fopen(logName.c_str(), "wb"); // Drops a torn entry, if any
+			if (!log)
+				throw fstream::failure("Could not open " + logName);
+		}
+	}
+	catch (fstream::failure &)
+	{
+		if (store)
+			fclose(store);
+		if (log)
+			fclose(log);
+		throw;
+	}
+
+	thread = std::thread(&PlayerStore::run, this);
+}
+
+/*
+Syncs everything that was saved, copies it into the store file, and empties
+the log.
+*/
+PlayerStore::~PlayerStore()
+{
+	{
+		lock_guard<mutex> guard(lock);
+		stopping = true;
+	}
+	wake.notify_one();
+	thread.join();
+
+	if (!failed && !dirty.empty())
+		checkpoint();
+	fclose(store);
+	if (log)
+		fclose(log);
+}
+
+/*
+Fills in p's name, wins, losses and chips from the store.  Returns false,
+leaving p alone, if the store has no player by that name (ignoring case).
+Never touches the disk.
+*/
+bool PlayerStore::load(const std::string & name, Player & p) const
+{
+	lock_guard<mutex> guard(lock);
+	unordered_map<string, size_t>::const_iterator found = index.find(upperCase(name));
+	if (found == index.end())
+		return false;
+
+	const Record & record = records[found->second];
+	p.name = record.name;
+	p.wins = record.wins;
+	p.losses = record.losses;
+	p.chips = record.chips;
+	return true;
+}
+
+/*
+Records p's name, wins, losses and chips.  Returns at once; the sync thread
+writes the change to the log within GROUP_MILLISECONDS.  Use flush() to
+wait for it.
+
+Throws invalid_argument if p's name is longer than MAX_NAME_LENGTH.
+*/
+void PlayerStore::save(const Player & p)
+{
+	save(p.name, p.wins, p.losses, p.chips);
+}
+
+/*
+Same as above, without a Player.
+*/
+void PlayerStore::save(const std::string & name, unsigned wins, unsigned losses, ChipAmt chips)
+{
+	if (name.length() > MAX_NAME_LENGTH)
+		throw invalid_argument("Name is too long to save");
+
+	unsigned char entry[LOG_ENTRY_SIZE];
+	bool wasEmpty;
+	{
+		lock_guard<mutex> guard(lock);
+		string key = upperCase(name);
+		unordered_map<string, size_t>::iterator found = index.find(key);
+		size_t slot;
+		if (found == index.end())
+		{
+			slot = records.size();
+			records.push_back(Record());
+			isDirty.push_back(false);
+			index[key] = slot;
+			records[slot].name = name;
+		}
+		else
+			slot = found->second;
+
+		Record & record = records[slot];
+		record.wins = wins;
+		record.losses = losses;
+		record.chips = chips;
+		if (!isDirty[slot])
+		{
+			isDirty[slot] = true;
+			dirty.push_back(slot);
+		}
+
+		putLittleEndian(entry, slot, 4);
+		encode(record, entry + 4);
+		putLittleEndian(entry + 4 + RECORD_SIZE, checksum(entry, 4 + RECORD_SIZE), 4);
+
+		wasEmpty = pending.empty();
+		pending.insert(pending.end(), entry, entry + LOG_ENTRY_SIZE);
+		saved++;
+	}
+
+	if (wasEmpty)
+		wake.notify_one();
+}
+
+/*
+Waits until every save so far is synced to the log.
+
+Throws fstream::failure if the sync thread could not write.
+*/
+void PlayerStore::flush()
+{
+	unique_lock<mutex> guard(lock);
+	flushRequested = true;
+	wake.notify_one();
+	done.wait(guard, [this] { return synced == saved || failed; });
+	flushRequested = false;
+
+	if (failed)
+		throw fstream::failure("Could not write to " + logName);
+}
+
+size_t PlayerStore::getNumPlayers() const
+{
+	lock_guard<mutex> guard(lock);
+	return records.size();
+}
+
+/*
+Opens the store file, creating it if needed, and reads every record into
+memory in one read.
+
+Throws fstream::failure if the file cannot be opened or is not a store.
+*/
+void PlayerStore::readStore()
+{
+	vector<unsigned char> contents;
+	if (!readWholeFile(fileName, contents))
+	{
+		store = fopen(fileName.c_str(), "w+b");
+		if (!store)
+			throw fstream::failure("Could not create " + fileName);
+
+		unsigned char header[HEADER_SIZE] = {0};
+		memcpy(header, MAGIC, sizeof(MAGIC));
+		putLittleEndian(header + 4, VERSION, 2);
+		putLittleEndian(header + 6, RECORD_SIZE, 2);
+		if (fwrite(header, 1, sizeof(header), store) != sizeof(header) || !syncFile(store))
+			throw fstream::failure("Could not create " + fileName);
+		return;
+	}
+
+	if (contents.size() < HEADER_SIZE || memcmp(&contents[0], MAGIC, sizeof(MAGIC)) != 0)
+		throw fstream::failure(fileName + " is not a player store");
+	if (getLittleEndian(&contents[4], 2) != VERSION || getLittleEndian(&contents[6], 2) != RECORD_SIZE)
+		throw fstream::failure(fileName + " is an unsupported version");
+
+	size_t numRecords = (size_t)getLittleEndian(&contents[8], 4);
+	if (contents.size() < HEADER_SIZE + numRecords * RECORD_SIZE)
+		throw fstream::failure(fileName + " is cut short");
+
+	records.resize(numRecords);
+	isDirty.assign(numRecords, false);
+	for (size_t slot = 0; slot < numRecords; slot++)
+	{
+		const unsigned char * bytes = &contents[HEADER_SIZE + slot * RECORD_SIZE];
+		Record & record = records[slot];
+		size_t nameLength = bytes[0];
+		if (nameLength > MAX_NAME_LENGTH)
+			throw fstream::failure(fileName + " is corrupt");
+		record.name.assign(reinterpret_cast<const char *>(bytes + 1), nameLength);
+		record.wins = (unsigned)getLittleEndian(bytes + 1 + MAX_NAME_LENGTH, 4);
+		record.losses = (unsigned)getLittleEndian(bytes + 5 + MAX_NAME_LENGTH, 4);
+		record.chips = (ChipAmt)getLittleEndian(bytes + 9 + MAX_NAME_LENGTH, 8);
+		index[upperCase(record.name)] = slot;
+	}
+
+	store = fopen(fileName.c_str(), "r+b");
+	if (!store)
+		throw fstream::failure("Could not open " + fileName);
+}
+
+/*
+Applies every whole, intact entry in the log, stopping at the first that
+is not (the end of a write that was cut off).  Marks the changed slots
+dirty, so that the constructor checkpoints them.
+*/
+void PlayerStore::replayLog()
+{
+	vector<unsigned char> contents;
+	if (!readWholeFile(logName, contents))
+		return;
+
+	for (size_t pos = 0; pos + LOG_ENTRY_SIZE <= contents.size(); pos += LOG_ENTRY_SIZE)
+	{
+		const unsigned char * entry = &contents[pos];
+		if (getLittleEndian(entry + 4 + RECORD_SIZE, 4) != checksum(entry, 4 + RECORD_SIZE))
+			break;
+
+		size_t slot = (size_t)getLittleEndian(entry, 4);
+		const unsigned char * bytes = entry + 4;
+		if (slot > records.size() || bytes[0] > MAX_NAME_LENGTH)
+			break;
+
+		if (slot == records.size())
+		{
+			records.push_back(Record());
+			isDirty.push_back(false);
+		}
+		Record & record = records[slot];
+		if (!record.name.empty())
+			index.erase(upperCase(record.name));
+		record.name.assign(reinterpret_cast<const char *>(bytes + 1), bytes[0]);
+		record.wins = (unsigned)getLittleEndian(bytes + 1 + MAX_NAME_LENGTH, 4);
+		record.losses = (unsigned)getLittleEndian(bytes + 5 + MAX_NAME_LENGTH, 4);
+		record.chips = (ChipAmt)getLittleEndian(bytes + 9 + MAX_NAME_LENGTH, 8);
+		index[upperCase(record.name)] = slot;
+
+		if (!isDirty[slot])
+		{
+			isDirty[slot] = true;
+			dirty.push_back(slot);
+		}
+	}
+}
+
+void PlayerStore::encode(const Record & record, unsigned char * bytes) const
+{
+	memset(bytes, 0, RECORD_SIZE);
+	bytes[0] = (unsigned char)record.name.length();
+	memcpy(bytes + 1, record.name.data(), record.name.length());
+	putLittleEndian(bytes + 1 + MAX_NAME_LENGTH, record.wins, 4);
+	putLittleEndian(bytes + 5 + MAX_NAME_LENGTH, record.losses, 4);
+	putLittleEndian(bytes + 9 + MAX_NAME_LENGTH, record.chips, 8);
+}
+
+/*
+Writes every dirty record into its slot in the store file, updates the
+header's record count, syncs the store, then empties the log.  Called by
+the sync thread, or by the constructor and destructor when there is no
+sync thread.  Returns false on failure.
+*/
+bool PlayerStore::checkpoint()
+{
+	vector<size_t> slots;
+	vector<unsigned char> bytes;
+	size_t numRecords;
+	{
+		lock_guard<mutex> guard(lock);
+		slots.swap(dirty);
+		sort(slots.begin(), slots.end());
+		bytes.resize(slots.size() * RECORD_SIZE);
+		for (size_t i = 0; i < slots.size(); i++)
+		{
+			isDirty[slots[i]] = false;
+			encode(records[slots[i]], &bytes[i * RECORD_SIZE]);
+		}
+		numRecords = records.size();
+	}
+
+	bool ok = true;
+	for (size_t i = 0; i < slots.size() && ok; i++)
+	{
+		ok = fseek(store, (long)(HEADER_SIZE + slots[i] * RECORD_SIZE), SEEK_SET) == 0 &&
+			fwrite(&bytes[i * RECORD_SIZE], 1, RECORD_SIZE, store) == RECORD_SIZE;
+	}
+
+	unsigned char count[4];
+	putLittleEndian(count, numRecords, 4);
+	ok = ok && fseek(store, 8, SEEK_SET) == 0 && fwrite(count, 1, sizeof(count), store) == sizeof(count);
+	ok = ok && syncFile(store);
+	if (!ok)
+		return false;
+
+	// Only now that the store has every change is it safe to empty the log
+	if (log)
+		fclose(log);
+	log = fopen(logName.c_str(), "wb");
+	logSize = 0;
+	return log && syncFile(log);
+}
+
+/*
+The sync thread.  Waits for a save, then up to GROUP_MILLISECONDS more so
+that saves close together share one write and one sync.  Checkpoints when
+the log is big enough.
+*/
+void PlayerStore::run()
+{
+	unique_lock<mutex> guard(lock);
+	while (true)
+	{
+		wake.wait(guard, [this] { return stopping || !pending.empty(); });
+		wake.wait_for(guard, chrono::milliseconds(GROUP_MILLISECONDS), [this] { return stopping || flushRequested; });
+
+		if (!pending.empty() && !failed)
+		{
+			vector<unsigned char> toWrite;
+			toWrite.swap(pending);
+			unsigned long count = saved;
+
+			guard.unlock();
+			bool ok = fwrite(&toWrite[0], 1, toWrite.size(), log) == toWrite.size() && syncFile(log);
+			logSize += toWrite.size();
+			if (ok && logSize >= CHECKPOINT_SIZE)
+				ok = checkpoint();
+			guard.lock();
+
+			if (ok)
+				synced = count;
+			else
+				failed = true;
+		}
+		else if (failed)
+		{
+			pending.clear(); // Nowhere to put it
+		}
+
+		if (pending.empty())
+			done.notify_all();
+		if (stopping && pending.empty())
+			break;
+	}
+}
@@ -0,0 +1,104 @@
+/*
+PlayerStore.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Declares PlayerStore, which keeps every Player's name, wins, losses and
+chips in one file instead of one file per Player.
+
+The store file is a 16-byte header followed by fixed-size records, one
+slot per player, so a record is rewritten in place.  The whole store is
+read into memory when it is opened, with a hash index from upper-cased
+name to slot, so loading a Player never touches the disk.
+
+save() only updates memory and queues a copy of the record.  A background
+thread appends queued records to a write-ahead log (the store's file name
+plus ".wal") and syncs the log once for the whole group.  When the log
+grows large, the thread copies the changed records into the store file,
+syncs it, and empties the log.  Opening a store replays whatever is in the
+log, so a crash loses at most the saves that were not yet synced.
+
+Store header, little-endian: "TPPS", u16 format version, u16 record size,
+u32 number of records, 4 reserved bytes.
+Record, RECORD_SIZE bytes: u8 name length, the name padded to
+MAX_NAME_LENGTH bytes, u32 wins, u32 losses, u64 chips.
+Log entry: u32 slot, a record, u32 checksum of the slot and record.
+*/
+
+#ifndef PLAYER_STORE_H
+#define PLAYER_STORE_H
+
+#include "Player.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <stdio.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class PlayerStore
+{
+public:
+	PlayerStore(const char fileName[] = DEFAULT_FILE);
+	~PlayerStore();
+
+	bool load(const std::string & name, Player & p) const;
+	void save(const Player & p);
+	void save(const std::string & name, unsigned wins, unsigned losses, ChipAmt chips);
+	void flush();
+	size_t getNumPlayers() const;
+
+	static const char DEFAULT_FILE[];
+	static const size_t MAX_NAME_LENGTH = 47;
+	static const size_t RECORD_SIZE = 64;
+
+private:
+	// Undefined, so that no copies can be made.
+	PlayerStore(const PlayerStore & other);
+	PlayerStore & operator= (const PlayerStore & other);
+
+	struct Record
+	{
+		std::string name;
+		unsigned wins;
+		unsigned losses;
+		ChipAmt chips;
+	};
+
+	void readStore();
+	void replayLog();
+	void encode(const Record & record, unsigned char * bytes) const;
+	bool checkpoint();
+	void run();
+
+	std::string fileName;
+	std::string logName;
+	FILE * store;
+	FILE * log;
+
+	std::vector<Record> records; // By slot
+	std::unordered_map<std::string, size_t> index; // Upper-cased name to slot
+	std::vector<unsigned char> pending; // Log entries not yet written
+	std::vector<size_t> dirty; // Slots changed since the last checkpoint
+	std::vector<bool> isDirty;
+	unsigned long saved; // Log entries queued
+	unsigned long synced; // Log entries in the log and synced
+	size_t logSize; // Bytes
+	bool flushRequested;
+	bool stopping;
+	bool failed;
+
+	mutable std::mutex lock;
+	std::condition_variable wake; // Signals run()
+	std::condition_variable done; // Signals flush()
+	std::thread thread;
+
+	static const size_t HEADER_SIZE = 16;
+	static const size_t LOG_ENTRY_SIZE = 4 + RECORD_SIZE + 4;
+	static const size_t CHECKPOINT_SIZE = 1024 * 1024; // Log bytes before the store file is updated
+	static const unsigned GROUP_MILLISECONDS = 20; // Longest a save waits to be synced
+};
+
+#endif
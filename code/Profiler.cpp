@@ -0,0 +1,241 @@
+/*
+Profiler.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Defines the Profiler registry, its report, and (when profiling is on) the
+replacement global operator new that counts allocations per thread.
+Everything in this file is compiled out unless TEXTPOKER_PROFILE is defined.
+*/
+
+#include "stdafx.h"
+#include "Profiler.h"
+
+#ifdef TEXTPOKER_PROFILE
+
+#include <string.h>
+#include <stdlib.h>
+#include <chrono>
+#include <mutex>
+#include <new>
+#include <iomanip>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace
+{
+	ProfileStats phases[Profiler::MAX_PHASES + 1]; // The last entry catches overflow
+	int numPhases = 0;
+	ProfileCounter counters[Profiler::MAX_COUNTERS + 1];
+	int numCounters = 0;
+	std::mutex registryLock;
+
+	thread_local unsigned long long allocCount = 0;
+	thread_local unsigned long long allocBytes = 0;
+}
+
+/*
+Returns the totals for the phase with the specified name and index,
+creating them the first time they are asked for.
+*/
+ProfileStats & Profiler::stats(const char * name, int index)
+{
+	std::lock_guard<std::mutex> lock(registryLock);
+	for (int i = 0; i < numPhases; i++)
+	{
+		if (phases[i].index == index && strcmp(phases[i].name, name) == 0)
+			return phases[i];
+	}
+
+	if (numPhases == MAX_PHASES)
+	{
+		phases[MAX_PHASES].name = "(other)";
+		phases[MAX_PHASES].index = -1;
+		return phases[MAX_PHASES];
+	}
+
+	phases[numPhases].name = name;
+	phases[numPhases].index = index;
+	return phases[numPhases++];
+}
+
+/*
+Returns the call counter with the specified name, creating it the first
+time it is asked for.
+*/
+ProfileCounter & Profiler::counter(const char * name)
+{
+	std::lock_guard<std::mutex> lock(registryLock);
+	for (int i = 0; i < numCounters; i++)
+	{
+		if (strcmp(counters[i].name, name) == 0)
+			return counters[i];
+	}
+
+	if (numCounters == MAX_COUNTERS)
+	{
+		counters[MAX_COUNTERS].name = "(other)";
+		return counters[MAX_COUNTERS];
+	}
+
+	counters[numCounters].name = name;
+	return counters[numCounters++];
+}
+
+/*
+Prints one line per phase and one line per counter.
+*/
+void Profiler::report(std::ostream & out)
+{
+	std::lock_guard<std::mutex> lock(registryLock);
+
+	out << "---- Profile ----" << '\n';
+	out << std::left << std::setw(28) << "Phase" << std::right <<
+		std::setw(12) << "Calls" <<
+		std::setw(14) << "Wall ms" <<
+		std::setw(14) << "CPU ms" <<
+		std::setw(14) << "Allocs" <<
+		std::setw(16) << "Bytes" << '\n';
+
+	for (int i = 0; i <= MAX_PHASES; i++)
+	{
+		ProfileStats & s = phases[i];
+		if (!s.name)
+			continue;
+
+		std::string label = s.name;
+		if (s.index >= MAX_INDEX)
+			label += " #" + std::to_string(MAX_INDEX + 1) + "+";
+		else if (s.index >= 0)
+		{
+			label += " #";
+			label += (char)('1' + s.index);
+		}
+
+		out << std::left << std::setw(28) << label << std::right << std::fixed << std::setprecision(3) <<
+			std::setw(12) << s.calls.load() <<
+			std::setw(14) << s.wallNs.load() / 1e6 <<
+			std::setw(14) << s.cpuNs.load() / 1e6 <<
+			std::setw(14) << s.allocs.load() <<
+			std::setw(16) << s.bytes.load() << '\n';
+	}
+
+	for (int i = 0; i <= MAX_COUNTERS; i++)
+	{
+		if (counters[i].name)
+			out << std::left << std::setw(28) << counters[i].name << std::right << std::setw(12) << counters[i].calls.load() << '\n';
+	}
+
+	out << std::flush;
+}
+
+/*
+Zeros every total and counter, keeping their names.
+*/
+void Profiler::reset()
+{
+	std::lock_guard<std::mutex> lock(registryLock);
+	for (int i = 0; i <= MAX_PHASES; i++)
+	{
+		phases[i].calls = 0;
+		phases[i].wallNs = 0;
+		phases[i].cpuNs = 0;
+		phases[i].allocs = 0;
+		phases[i].bytes = 0;
+	}
+	for (int i = 0; i <= MAX_COUNTERS; i++)
+		counters[i].calls = 0;
+}
+
+unsigned long long Profiler::threadAllocs()
+{
+	return allocCount;
+}
+
+unsigned long long Profiler::threadBytes()
+{
+	return allocBytes;
+}
+
+unsigned long long Profiler::wallNow()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+CPU time used by the calling thread.
+*/
+unsigned long long Profiler::cpuNow()
+{
+#ifdef _WIN32
+	FILETIME creation, exit, kernel, user;
+	GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+	unsigned long long k = ((unsigned long long)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime;
+	unsigned long long u = ((unsigned long long)user.dwHighDateTime << 32) | user.dwLowDateTime;
+	return (k + u) * 100; // FILETIME ticks are 100 ns
+#else
+	timespec ts;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+#endif
+}
+
+//////////////////////////////////////////////////
+// Replacement global allocation functions that //
+// count every allocation made by this thread.  //
+//////////////////////////////////////////////////
+
+void * operator new(size_t size)
+{
+	allocCount++;
+	allocBytes += size;
+
+	void * p = malloc(size ? size : 1);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+void * operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void * operator new(size_t size, const std::nothrow_t &) noexcept
+{
+	allocCount++;
+	allocBytes += size;
+	return malloc(size ? size : 1);
+}
+
+void * operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+	return operator new(size, std::nothrow);
+}
+
+void operator delete(void * p) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void * p) noexcept
+{
+	free(p);
+}
+
+void operator delete(void * p, size_t) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void * p, size_t) noexcept
+{
+	free(p);
+}
+
+#endif
@@ -0,0 +1,152 @@
+/*
+Profiler.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Optional instrumentation.  PROFILE_PHASE() measures wall time, CPU time,
+heap allocations and bytes allocated for the rest of the enclosing block;
+PROFILE_COUNT() counts calls.  Profiler::report() prints everything
+measured so far; Game::stop_game() calls it through PROFILE_REPORT().
+
+Profiling is compiled out completely unless TEXTPOKER_PROFILE is defined,
+either by the build or by uncommenting the lines below.  When it is on,
+global operator new is replaced so that allocations can be counted.
+*/
+
+/*
+#ifndef TEXTPOKER_PROFILE
+#define TEXTPOKER_PROFILE
+#endif
+*/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#ifdef TEXTPOKER_PROFILE
+
+#include <atomic>
+#include <ostream>
+
+/*
+Totals for one phase.  Times are in nanoseconds.
+*/
+struct ProfileStats
+{
+	const char * name;
+	int index; // -1 unless the phase is one of a numbered series, like betting streets; MAX_INDEX for the rest of a series
+	std::atomic<unsigned long long> calls;
+	std::atomic<unsigned long long> wallNs;
+	std::atomic<unsigned long long> cpuNs;
+	std::atomic<unsigned long long> allocs;
+	std::atomic<unsigned long long> bytes;
+};
+
+struct ProfileCounter
+{
+	const char * name;
+	std::atomic<unsigned long long> calls;
+};
+
+class Profiler
+{
+public:
+	static ProfileStats & stats(const char * name, int index = -1);
+	static ProfileStats & seriesStats(std::atomic<ProfileStats *> series[], const char * name, int index);
+	static ProfileCounter & counter(const char * name);
+
+	static void report(std::ostream & out);
+	static void reset();
+
+	// This thread's allocations so far; maintained by the replaced operator new
+	static unsigned long long threadAllocs();
+	static unsigned long long threadBytes();
+
+	static unsigned long long wallNow();
+	static unsigned long long cpuNow();
+
+	static const int MAX_PHASES = 64;
+	static const int MAX_COUNTERS = 32;
+	static const int MAX_INDEX = 8; // Phases of a series numbered this or higher are added together
+};
+
+/*
+Returns the totals for one phase of a numbered series, looking them up
+only the first time each index is used at a call site.  series is the
+call site's cache, MAX_INDEX + 1 entries that start out null.
+*/
+inline ProfileStats & Profiler::seriesStats(std::atomic<ProfileStats *> series[], const char * name, int index)
+{
+	if (index < 0 || index > MAX_INDEX)
+		index = MAX_INDEX;
+
+	ProfileStats * found = series[index].load(std::memory_order_acquire);
+	if (!found)
+	{
+		found = &stats(name, index); // Threads that race here all get the same stats
+		series[index].store(found, std::memory_order_release);
+	}
+	return *found;
+}
+
+/*
+Adds the time and allocations between its construction and destruction
+to a ProfileStats.
+*/
+class ProfileTimer
+{
+public:
+	ProfileTimer(ProfileStats & stats)
+		: stats(stats), wallStart(Profiler::wallNow()), cpuStart(Profiler::cpuNow()),
+		allocStart(Profiler::threadAllocs()), bytesStart(Profiler::threadBytes()) {}
+
+	~ProfileTimer()
+	{
+		stats.calls.fetch_add(1, std::memory_order_relaxed);
+		stats.wallNs.fetch_add(Profiler::wallNow() - wallStart, std::memory_order_relaxed);
+		stats.cpuNs.fetch_add(Profiler::cpuNow() - cpuStart, std::memory_order_relaxed);
+		stats.allocs.fetch_add(Profiler::threadAllocs() - allocStart, std::memory_order_relaxed);
+		stats.bytes.fetch_add(Profiler::threadBytes() - bytesStart, std::memory_order_relaxed);
+	}
+
+private:
+	ProfileTimer(const ProfileTimer & other);
+	ProfileTimer & operator= (const ProfileTimer & other);
+
+	ProfileStats & stats;
+	unsigned long long wallStart;
+	unsigned long long cpuStart;
+	unsigned long long allocStart;
+	unsigned long long bytesStart;
+};
+
+#define PROFILE_CAT2(a, b) a##b
+#define PROFILE_CAT(a, b) PROFILE_CAT2(a, b)
+
+// name must be a string literal; the lookup happens once per call site
+#define PROFILE_PHASE(name) \
+	static ProfileStats & PROFILE_CAT(profileStats_, __LINE__) = Profiler::stats(name); \
+	ProfileTimer PROFILE_CAT(profileTimer_, __LINE__)(PROFILE_CAT(profileStats_, __LINE__))
+
+// One of a numbered series of phases, counting from 0; like PROFILE_PHASE(), the lookup happens once per call site and index
+#define PROFILE_PHASE_INDEXED(name, index) \
+	static std::atomic<ProfileStats *> PROFILE_CAT(profileSeries_, __LINE__)[Profiler::MAX_INDEX + 1]; \
+	ProfileTimer PROFILE_CAT(profileTimer_, __LINE__)(Profiler::seriesStats(PROFILE_CAT(profileSeries_, __LINE__), name, (int)(index)))
+
+#define PROFILE_COUNT(name) \
+	do { \
+		static ProfileCounter & profileCounter = Profiler::counter(name); \
+		profileCounter.calls.fetch_add(1, std::memory_order_relaxed); \
+	} while (0)
+
+#define PROFILE_REPORT(out) Profiler::report(out)
+
+#else
+
+#define PROFILE_PHASE(name)
+#define PROFILE_PHASE_INDEXED(name, index)
+#define PROFILE_COUNT(name) do { } while (0)
+#define PROFILE_REPORT(out) do { } while (0)
+
+#endif
+
+#endif
@@ -0,0 +1,147 @@
+/*
+Renderer.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Defines Renderer and its frame buffer.
+*/
+
+#include "stdafx.h"
+#include "Renderer.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+Renderer::Renderer(Verbosity verbosity)
+	: verbosity(verbosity), frame(&buffer), discard(0)
+{
+}
+
+/*
+Presents whatever is left of the last frame.
+*/
+Renderer::~Renderer()
+{
+	present();
+}
+
+/*
+Writes the frame to standard output, or hands it to the sink, then starts 
+an empty one.  Does nothing if nothing was printed.  Write errors are 
+ignored, as cout does.
+*/
+void Renderer::present()
+{
+	const char * data = buffer.data();
+	size_t left = buffer.size();
+	if (sink && left > 0)
+	{
+		presenting.shared.assign(data, left);
+		sink(presenting);
+		presenting.secrets.clear();
+		left = 0;
+	}
+
+	while (left > 0) // A terminal or pipe may take less than all of it
+	{
+#ifdef _WIN32
+		int written = _write(1, data, (unsigned)left);
+#else
+		ssize_t written = ::write(1, data, left);
+#endif
+		if (written <= 0)
+			break;
+		data += written;
+		left -= written;
+	}
+
+	buffer.clear();
+}
+
+/*
+Prints text that only owner may see all of: owner sees full, and everybody 
+else sees hidden.  Standard output shows full if showFull, as when the 
+owner is the one at the keyboard, and hidden otherwise.
+*/
+void Renderer::secret(Verbosity level, const std::string & owner, const std::string & full, const std::string & hidden, bool showFull)
+{
+	if (!shows(level))
+		return;
+
+	const string & shared = (showFull ? full : hidden);
+	if (sink)
+	{
+		Frame::Secret secret;
+		secret.begin = buffer.size();
+		secret.length = shared.length();
+		secret.owner = owner;
+		secret.full = full;
+		secret.hidden = hidden;
+		presenting.secrets.push_back(secret);
+	}
+	frame.write(shared.data(), shared.length());
+}
+
+Verbosity Renderer::getVerbosity() const
+{
+	return verbosity;
+}
+
+void Renderer::setVerbosity(Verbosity level)
+{
+	verbosity = level;
+}
+
+void Renderer::setSink(const Sink & newSink)
+{
+	sink = newSink;
+}
+
+/*
+The frame as viewer may see it: every secret of viewer's in full, and 
+everybody else's hidden.  An empty viewer sees every secret hidden.
+*/
+std::string Renderer::Frame::viewFor(const std::string & viewer) const
+{
+	string view;
+	view.reserve(shared.length());
+	size_t pos = 0;
+	for (size_t i = 0; i < secrets.size(); i++)
+	{
+		const Secret & secret = secrets[i];
+		view.append(shared, pos, secret.begin - pos);
+		view += (!viewer.empty() && secret.owner == viewer ? secret.full : secret.hidden);
+		pos = secret.begin + secret.length;
+	}
+	view.append(shared, pos, string::npos);
+	return view;
+}
+
+Renderer::FrameBuffer::FrameBuffer()
+	: storage(INITIAL_SIZE)
+{
+	setp(&storage[0], &storage[0] + storage.size());
+}
+
+/*
+Called when the buffer is full: doubles it, keeping what was written.
+*/
+Renderer::FrameBuffer::int_type Renderer::FrameBuffer::overflow(int_type c)
+{
+	if (traits_type::eq_int_type(c, traits_type::eof()))
+		return traits_type::not_eof(c);
+
+	size_t used = size();
+	storage.resize(storage.size() * 2);
+	setp(&storage[0], &storage[0] + storage.size());
+	pbump((int)used);
+
+	*pptr() = traits_type::to_char_type(c);
+	pbump(1);
+	return c;
+}
@@ -0,0 +1,104 @@
+/*
+Renderer.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Declares Renderer, through which a Game prints everything.  Text goes 
+into a frame buffer that is kept between frames, and present() writes the 
+whole frame to standard output at once instead of flushing every line.  
+Output below the Renderer's verbosity goes nowhere: at() hands back a 
+stream that ignores it, and callers can test shows() to skip formatting 
+altogether.  A frame can be handed to a sink instead, such as a server 
+that sends it to a table's clients.
+
+Some text, such as the cards in a Player's hand, is a secret: only that 
+Player may see all of it.  Standard output is one screen that every Player 
+shares, so it gets whichever version the Game chose; a sink gets both, and 
+Frame::viewFor() renders the frame as one viewer may see it.
+*/
+
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <functional>
+
+enum Verbosity
+{
+	SILENT, // Nothing
+	QUIET, // Results: who joins, leaves and wins, and problems
+	NORMAL // Everything, including tables, hands and prompts
+};
+
+class Renderer
+{
+public:
+	// A presented frame, with its secrets
+	class Frame
+	{
+	public:
+		const std::string & text() const { return shared; } // As standard output shows it
+		std::string viewFor(const std::string & viewer) const;
+
+	private:
+		friend class Renderer;
+
+		struct Secret
+		{
+			size_t begin; // Where its shared version is in the text
+			size_t length;
+			std::string owner;
+			std::string full; // For the owner
+			std::string hidden; // For everybody else
+		};
+
+		std::string shared;
+		std::vector<Secret> secrets; // In order
+	};
+
+	typedef std::function<void (const Frame & frame)> Sink;
+
+	Renderer(Verbosity verbosity = NORMAL);
+	~Renderer();
+
+	bool shows(Verbosity level) const { return level != SILENT && level <= verbosity; }
+	std::ostream & at(Verbosity level) { return shows(level) ? frame : discard; }
+	void secret(Verbosity level, const std::string & owner, const std::string & full, const std::string & hidden, bool showFull);
+	void present();
+	Verbosity getVerbosity() const;
+	void setVerbosity(Verbosity level);
+	void setSink(const Sink & newSink);
+
+private:
+	// Undefined, so that no copies can be made.
+	Renderer(const Renderer & other);
+	Renderer & operator= (const Renderer & other);
+
+	// Appends to a growable buffer that keeps its memory when cleared
+	class FrameBuffer : public std::streambuf
+	{
+	public:
+		FrameBuffer();
+		const char * data() const { return pbase(); }
+		size_t size() const { return pptr() - pbase(); }
+		void clear() { setp(pbase(), epptr()); }
+	protected:
+		int_type overflow(int_type c);
+	private:
+		std::vector<char> storage;
+	};
+
+	Verbosity verbosity;
+	Sink sink; // Empty for standard output
+	FrameBuffer buffer;
+	Frame presenting; // Its secrets so far, if there is a sink; its text is only filled in by present()
+	std::ostream frame;
+	std::ostream discard; // No buffer, so every insertion fails at once
+
+	static const size_t INITIAL_SIZE = 4096;
+};
+
+#endif
@@ -0,0 +1,242 @@
+/*
+Replay.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Entry point for the hand-history replayer, built as its own executable.
+Streams a hand-history file (see HandHistory.h) and re-executes every
+round through its variant's rules with a Replayer, which checks the
+antes, every betting action, the pot, the winners and the final chips
+against the record.  Also checks that each table's hand numbers go up
+within each session (each run that appended to the file).
+
+Rounds are handed out to worker threads by table id, so that every table's
+rounds are replayed in order on one thread while independent tables run in
+parallel.  Nothing is printed per round, so the replay rate is also a
+measure of the rules engine alone.
+
+Usage: Replay [--threads n] [--errors n] historyFile
+Prints the first few errors (10 by default) and exits with 1 if any round
+fails to check out.
+*/
+
+#include "stdafx.h"
+#include "HandHistory.h"
+#include "Replayer.h"
+#include "Rules.h"
+#include "Profiler.h"
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <map>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+
+const size_t BATCH_SIZE = 256; // Records handed to a worker at a time
+const size_t MAX_QUEUED_BATCHES = 8; // Per worker; the reader waits past this
+
+/*
+A worker thread's queue of batches of records, all from the tables that
+belong to the worker.  An empty batch means there is no more work.
+*/
+class BatchQueue
+{
+public:
+	void push(vector<HandRecord> & batch)
+	{
+		unique_lock<mutex> guard(lock);
+		notFull.wait(guard, [this] { return batches.size() < MAX_QUEUED_BATCHES; });
+		batches.push_back(vector<HandRecord>());
+		batches.back().swap(batch);
+		notEmpty.notify_one();
+	}
+
+	void pop(vector<HandRecord> & batch)
+	{
+		unique_lock<mutex> guard(lock);
+		notEmpty.wait(guard, [this] { return !batches.empty(); });
+		batch.swap(batches.front());
+		batches.pop_front();
+		notFull.notify_one();
+	}
+
+private:
+	deque<vector<HandRecord>> batches;
+	mutex lock;
+	condition_variable notEmpty;
+	condition_variable notFull;
+};
+
+/*
+What one worker found.
+*/
+struct ReplayShard
+{
+	ReplayShard() : replayed(0), failed(0) {}
+
+	unsigned long replayed;
+	unsigned long failed;
+	vector<string> errors; // The first few
+};
+
+/*
+Replays every batch in queue until it gets an empty one.
+*/
+void replayWorker(BatchQueue * queue, ReplayShard * shard, size_t maxErrors)
+{
+	Replayer<FiveCardDrawRules> draw;
+	Replayer<SevenCardStudRules> stud;
+	Replayer<TexasHoldEmRules> holdEm;
+	map<pair<unsigned, unsigned>, unsigned long> nextHand; // Lowest hand number each table may have next, by session and table
+
+	vector<HandRecord> batch;
+	while (true)
+	{
+		queue->pop(batch);
+		if (batch.empty())
+			break;
+
+		for (size_t i = 0; i < batch.size(); i++)
+		{
+			const HandRecord & record = batch[i];
+			bool ok;
+			string error;
+			switch (record.variant)
+			{
+			case SCENARIO_FIVE_CARD_DRAW:
+				ok = draw.replay(record);
+				error = draw.getError();
+				break;
+			case SCENARIO_SEVEN_CARD_STUD:
+				ok = stud.replay(record);
+				error = stud.getError();
+				break;
+			case SCENARIO_TEXAS_HOLD_EM:
+				ok = holdEm.replay(record);
+				error = holdEm.getError();
+				break;
+			default:
+				ok = false;
+				error = "Table " + to_string((unsigned long long)record.tableId) + ": no variant";
+				break;
+			}
+
+			pair<unsigned, unsigned> table(record.session, record.tableId);
+			map<pair<unsigned, unsigned>, unsigned long>::iterator found = nextHand.find(table);
+			if (ok && found != nextHand.end() && record.handNumber < found->second)
+			{
+				ok = false;
+				error = "Table " + to_string((unsigned long long)record.tableId) + ", hand " +
+					to_string((unsigned long long)record.handNumber) + ": hand number went down";
+			}
+			nextHand[table] = record.handNumber + 1;
+
+			shard->replayed++;
+			if (!ok)
+			{
+				shard->failed++;
+				if (shard->errors.size() < maxErrors)
+					shard->errors.push_back(error);
+			}
+		}
+	}
+}
+
+int main(int argc, char * argv[])
+{
+	unsigned numThreads = thread::hardware_concurrency();
+	size_t maxErrors = 10;
+	const char * fileName = 0;
+	bool usage = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+			numThreads = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--errors") == 0 && i + 1 < argc)
+			maxErrors = atoi(argv[++i]);
+		else if (!fileName && argv[i][0] != '-')
+			fileName = argv[i];
+		else
+			usage = true;
+	}
+	if (usage || !fileName)
+	{
+		cout << "Usage: " << argv[0] << " [--threads n] [--errors n] historyFile" << endl;
+		return 2;
+	}
+	if (numThreads == 0)
+		numThreads = 1;
+
+	vector<BatchQueue> queues(numThreads);
+	vector<ReplayShard> shards(numThreads);
+	vector<thread> threads;
+	for (unsigned t = 0; t < numThreads; t++)
+		threads.push_back(thread(replayWorker, &queues[t], &shards[t], maxErrors));
+
+	int exitCode = 0;
+	unsigned long recordsRead = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	try
+	{
+		HistoryReader reader(fileName);
+		vector<vector<HandRecord>> batches(numThreads);
+		HandRecord record;
+		while (reader.next(record))
+		{
+			recordsRead++;
+			vector<HandRecord> & batch = batches[record.tableId % numThreads];
+			batch.push_back(record);
+			if (batch.size() == BATCH_SIZE)
+				queues[record.tableId % numThreads].push(batch);
+		}
+
+		for (unsigned t = 0; t < numThreads; t++)
+		{
+			if (!batches[t].empty())
+				queues[t].push(batches[t]);
+		}
+	}
+	catch (fstream::failure & e)
+	{
+		cout << e.what() << endl;
+		exitCode = 1;
+	}
+
+	for (unsigned t = 0; t < numThreads; t++)
+	{
+		vector<HandRecord> done;
+		queues[t].push(done);
+	}
+	for (size_t t = 0; t < threads.size(); t++)
+		threads[t].join();
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	ReplayShard total;
+	for (size_t t = 0; t < shards.size(); t++)
+	{
+		total.replayed += shards[t].replayed;
+		total.failed += shards[t].failed;
+		for (size_t i = 0; i < shards[t].errors.size() && total.errors.size() < maxErrors; i++)
+			total.errors.push_back(shards[t].errors[i]);
+	}
+
+	for (size_t i = 0; i < total.errors.size(); i++)
+		cout << "  FAIL  " << total.errors[i] << endl;
+	cout << "Replayed " << total.replayed << " of " << recordsRead << " hand(s) on " << numThreads << " thread(s) in "
+		<< seconds << " s (" << (unsigned long)(total.replayed / seconds * 60) << " hands/min); "
+		<< total.failed << " failed" << endl;
+	PROFILE_REPORT(cout);
+
+	if (total.failed != 0)
+		exitCode = 1;
+	return exitCode;
+}
@@ -0,0 +1,370 @@
+/*
+Replayer.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Declares and defines the Replayer class template, which re-executes a
+recorded round (a HandRecord) through one variant's rules and checks that
+the record could really have happened.  Like Simulation, the variant is a
+Rules policy and all table state lives in one TableState; the Replayer
+takes every decision from the record instead of from a Strategy, and
+prints nothing.
+
+For each round it checks that the antes, the order of play, and the amount
+of every check, bet, call, raise and fold follow Game's betting rules; that
+the pot after every action matches; that the pot went to the right seats
+(the only seat left, or the best hands at showdown, split as dividePot()
+splits it); and that every seat's final chips match.
+*/
+
+#ifndef REPLAYER_H
+#define REPLAYER_H
+
+#include "Game.h"
+#include "TexasHoldEm.h"
+#include "TableState.h"
+#include "HandHistory.h"
+#include "Hand.h"
+
+#include <string>
+#include <sstream>
+#include <algorithm>
+
+template <class Rules>
+class Replayer
+{
+public:
+	Replayer();
+
+	bool replay(const HandRecord & record);
+	const std::string & getError() const;
+	unsigned long getHandsReplayed() const;
+
+	static const size_t MAX_SEATS = (Rules::MAX_PLAYERS < TableState::MAX_SEATS ? Rules::MAX_PLAYERS : TableState::MAX_SEATS);
+
+private:
+	bool collectAnte();
+	bool collectBets(size_t street);
+	bool checkEarlyWin();
+	bool checkShowdown();
+	bool checkWinners(const size_t winners[], size_t numWinners);
+	bool checkFinalChips();
+	bool fail(const std::string & what);
+
+	static size_t countCards(CardMask cards);
+
+	TableState table;
+	const HandRecord * record; // The round being replayed
+	size_t nextAction; // Index into record->actions
+	std::string error;
+	unsigned long handsReplayed;
+};
+
+template <class Rules>
+Replayer<Rules>::Replayer()
+	: record(0), nextAction(0), handsReplayed(0) {}
+
+/*
+Replays one round.  Returns true if the record checks out.  Otherwise,
+returns false, and getError() says what was wrong and where.
+*/
+template <class Rules>
+bool Replayer<Rules>::replay(const HandRecord & record)
+{
+	this->record = &record;
+	nextAction = 0;
+	error.clear();
+
+	if (record.variant != Rules::SCENARIO)
+		return fail("recorded for a different variant");
+	if (record.seats.size() == 0 || record.seats.size() > MAX_SEATS)
+		return fail("unsupported number of seats");
+	if (record.dealerPos >= record.seats.size())
+		return fail("dealer position is not a seat");
+
+	table.reset(record.seats.size(), 0);
+	table.dealerPos = record.dealerPos;
+	for (size_t i = 0; i < table.numSeats; i++)
+	{
+		table.chips[i] = (SeatChips)record.seats[i].startChips;
+		table.flags[i] = TableState::IN_ROUND;
+	}
+	table.playersInRound = table.numSeats;
+
+	if (!collectAnte())
+		return false;
+
+	bool early = false;
+	for (size_t street = 0; street < Rules::STREETS && !early; street++)
+	{
+		if (!collectBets(street))
+			return false;
+		early = (table.playersInRound == 1);
+	}
+
+	if (nextAction != record.actions.size())
+		return fail("actions after the round was over");
+	if (early ? !checkEarlyWin() : !checkShowdown())
+		return false;
+	if (!checkFinalChips())
+		return false;
+
+	handsReplayed++;
+	return true;
+}
+
+template <class Rules>
+const std::string & Replayer<Rules>::getError() const
+{
+	return error;
+}
+
+template <class Rules>
+unsigned long Replayer<Rules>::getHandsReplayed() const
+{
+	return handsReplayed;
+}
+
+/*
+Same as Simulation::collectAnte(): every seat pays one chip, in seat order.
+*/
+template <class Rules>
+bool Replayer<Rules>::collectAnte()
+{
+	for (size_t i = 0; i < table.numSeats; i++, nextAction++)
+	{
+		if (nextAction >= record->actions.size())
+			return fail("missing ante");
+
+		const HandRecord::Action & action = record->actions[nextAction];
+		if (action.action != ACTION_ANTE || action.seat != i || action.amount != 1)
+			return fail("expected an ante of 1");
+		if (table.chips[i] == 0)
+			return fail("seat with no chips paid the ante");
+
+		if (--table.chips[i] == 0)
+			table.flags[i] |= TableState::ALL_IN;
+		table.pot++;
+		if (action.potAfter != table.pot)
+			return fail("pot does not match");
+	}
+
+	return true;
+}
+
+/*
+Walks the seats in the same order as Simulation::collectBets(), taking
+each seat's action from the record and checking it against what the
+prompts would have allowed.
+*/
+template <class Rules>
+bool Replayer<Rules>::collectBets(size_t street)
+{
+	size_t finalResponder = table.dealerPos;
+	size_t seatNum = table.dealerPos;
+	bool betMade = false;
+	SeatChips bet = 0;
+
+	do
+	{
+		seatNum = table.nextSeat(seatNum);
+		if (!table.canAct(seatNum))
+			continue;
+
+		if (nextAction >= record->actions.size())
+			return fail("missing action");
+		const HandRecord::Action & action = record->actions[nextAction];
+		if (action.street != street || action.seat != seatNum)
+			return fail("action out of turn");
+
+		SeatChips callAmt = bet - table.amtPaid[seatNum];
+		SeatChips chips = table.chips[seatNum];
+		switch (action.action)
+		{
+		case ACTION_CHECK:
+			if (betMade || action.amount != 0)
+				return fail("bad check");
+			break;
+
+		case ACTION_BET:
+			if (betMade || action.amount < Game::MIN_BET || action.amount > std::min<ChipAmt>(chips, Game::MAX_BET))
+				return fail("bad bet");
+			betMade = true;
+			bet = (SeatChips)action.amount;
+			table.amtPaid[seatNum] += bet;
+			finalResponder = (seatNum == 0 ? table.numSeats - 1 : seatNum - 1);
+			break;
+
+		case ACTION_CALL: // Or all in, if the seat cannot cover the call
+			if (!betMade || action.amount != std::min(chips, callAmt))
+				return fail("bad call");
+			table.amtPaid[seatNum] += (SeatChips)action.amount;
+			break;
+
+		case ACTION_RAISE: // The amount includes the call
+			if (!betMade || chips <= callAmt || action.amount < callAmt + Game::MIN_BET ||
+				action.amount - callAmt > std::min<ChipAmt>(chips - callAmt, Game::MAX_BET))
+				return fail("bad raise");
+			bet += (SeatChips)(action.amount - callAmt);
+			table.amtPaid[seatNum] += (SeatChips)action.amount;
+			finalResponder = (seatNum == 0 ? table.numSeats - 1 : seatNum - 1);
+			break;
+
+		case ACTION_FOLD:
+			if (!betMade || action.amount != 0)
+				return fail("bad fold");
+			table.fold(seatNum);
+			break;
+
+		default:
+			return fail("unexpected action");
+		}
+
+		table.chips[seatNum] -= (SeatChips)action.amount;
+		table.pot += action.amount;
+		if (table.chips[seatNum] == 0)
+			table.flags[seatNum] |= TableState::ALL_IN;
+		if (action.potAfter != table.pot)
+			return fail("pot does not match");
+		nextAction++;
+
+	} while (seatNum != finalResponder);
+
+	for (size_t i = 0; i < table.numSeats; i++)
+		table.amtPaid[i] = 0;
+	return true;
+}
+
+/*
+The only seat that did not fold must have won the whole pot.
+*/
+template <class Rules>
+bool Replayer<Rules>::checkEarlyWin()
+{
+	size_t winner = 0;
+	while (!table.inRound(winner))
+		winner++;
+
+	return checkWinners(&winner, 1);
+}
+
+/*
+Ranks the recorded cards of every seat still in the round with
+Rules::showdownHand(), then checks the recorded winners against the best.
+*/
+template <class Rules>
+bool Replayer<Rules>::checkShowdown()
+{
+	if (Rules::USES_COMMUNITY)
+	{
+		if (countCards(record->board) != TexasHoldEm::COMMUNITY_SIZE)
+			return fail("wrong number of board cards");
+		table.community = record->board;
+	}
+	else if (record->board != 0)
+		return fail("board cards in a variant without them");
+
+	Hand best[MAX_SEATS];
+	size_t contenders[MAX_SEATS];
+	size_t numContenders = 0;
+	CardMask seen = table.community;
+	for (size_t i = 0; i < table.numSeats; i++)
+	{
+		CardMask cards = record->seats[i].cards;
+		if (cards & seen)
+			return fail("the same card was dealt twice");
+		seen |= cards;
+
+		if (table.inRound(i))
+		{
+			if (countCards(cards) != Rules::HAND_SIZE)
+				return fail("wrong number of cards at showdown");
+			table.holeCards[i] = cards;
+			Rules::showdownHand(table, i, best[i]);
+			contenders[numContenders++] = i;
+		}
+	}
+
+	std::sort(contenders, contenders + numContenders,
+		[&best](size_t one, size_t two) { return Hand::poker_rank(best[one], best[two]); });
+
+	size_t numWinners = 1;
+	while (numWinners < numContenders && best[contenders[0]].sameRankAs(best[contenders[numWinners]]))
+		numWinners++;
+
+	std::sort(contenders, contenders + numWinners); // Seat order, to match the record's winners
+	return checkWinners(contenders, numWinners);
+}
+
+/*
+Checks that exactly these seats won, and that the pot was split as
+dividePot() splits it: everybody gets an equal share, and the remainder
+goes one chip each to some of them.  Pays the winners.
+*/
+template <class Rules>
+bool Replayer<Rules>::checkWinners(const size_t winners[], size_t numWinners)
+{
+	const std::vector<HandRecord::Winner> & recorded = record->winners;
+	if (recorded.size() != numWinners)
+		return fail("wrong number of winners");
+
+	ChipAmt share = table.pot / numWinners;
+	size_t extraChips = table.pot % numWinners;
+	size_t extraPaid = 0;
+	for (size_t i = 0; i < numWinners; i++)
+	{
+		size_t seatNum = winners[i];
+		size_t found = 0;
+		while (found < recorded.size() && recorded[found].seat != seatNum)
+			found++;
+		if (found == recorded.size())
+			return fail("wrong winner");
+
+		ChipAmt amount = recorded[found].amount;
+		if (amount == share + 1)
+			extraPaid++;
+		else if (amount != share)
+			return fail("wrong share of the pot");
+		table.chips[seatNum] += (SeatChips)amount;
+	}
+
+	if (extraPaid != extraChips)
+		return fail("pot was not split evenly");
+	table.pot = 0;
+	return true;
+}
+
+template <class Rules>
+bool Replayer<Rules>::checkFinalChips()
+{
+	for (size_t i = 0; i < table.numSeats; i++)
+	{
+		if (table.chips[i] != record->seats[i].finalChips)
+			return fail("final chips do not match for " + record->seats[i].name);
+	}
+	return true;
+}
+
+/*
+Sets the error message, saying which round and which action, and returns
+false.
+*/
+template <class Rules>
+bool Replayer<Rules>::fail(const std::string & what)
+{
+	std::ostringstream message;
+	message << "Table " << record->tableId << ", hand " << record->handNumber << ", action " << nextAction << ": " << what;
+	error = message.str();
+	return false;
+}
+
+template <class Rules>
+size_t Replayer<Rules>::countCards(CardMask cards)
+{
+	size_t count = 0;
+	for (; cards != 0; cards &= cards - 1)
+		count++;
+	return count;
+}
+
+#endif
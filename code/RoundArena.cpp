@@ -0,0 +1,96 @@
+/*
+RoundArena.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Defines the RoundArena block allocator.
+*/
+
+#include "stdafx.h"
+#include "RoundArena.h"
+
+thread_local RoundArena * RoundArena::currentArena = 0;
+
+/*
+Creates an arena whose first block is blockSize bytes.  No memory is
+allocated until it is first needed.
+*/
+RoundArena::RoundArena(size_t blockSize)
+	: blocks(0), cursor(0), end(0), blockSize(blockSize), used(0) {}
+
+RoundArena::~RoundArena()
+{
+	while (blocks)
+	{
+		Block * next = blocks->next;
+		::operator delete(blocks);
+		blocks = next;
+	}
+}
+
+/*
+Returns bytes of memory aligned to ALIGNMENT.  Adds a new block if the
+current one is full.
+*/
+void * RoundArena::allocate(size_t bytes)
+{
+	bytes = (bytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+	if ((size_t)(end - cursor) < bytes)
+		addBlock(bytes);
+
+	void * p = cursor;
+	cursor += bytes;
+	used += bytes;
+	return p;
+}
+
+/*
+Releases everything allocated since the last reset.  If the round needed
+more than one block, the blocks are replaced by a single block big enough
+for the whole round, so the next round of the same size needs only one.
+*/
+void RoundArena::reset()
+{
+	if (blocks && blocks->next)
+	{
+		if (used > blockSize)
+			blockSize = used;
+
+		while (blocks)
+		{
+			Block * next = blocks->next;
+			::operator delete(blocks);
+			blocks = next;
+		}
+		cursor = end = 0;
+	}
+	else if (blocks)
+	{
+		cursor = reinterpret_cast<char *>(blocks) + ALIGNMENT;
+	}
+
+	used = 0;
+}
+
+/*
+Returns how many bytes have been handed out since the last reset.
+*/
+size_t RoundArena::bytesUsed() const
+{
+	return used;
+}
+
+/*
+Starts a new block with room for at least minBytes.
+*/
+void RoundArena::addBlock(size_t minBytes)
+{
+	size_t size = (minBytes > blockSize ? minBytes : blockSize);
+	Block * block = static_cast<Block *>(::operator new(size + ALIGNMENT)); // Header padded to ALIGNMENT
+	block->next = blocks;
+	block->size = size;
+	blocks = block;
+
+	cursor = reinterpret_cast<char *>(block) + ALIGNMENT;
+	end = cursor + size;
+}
@@ -0,0 +1,152 @@
+/*
+RoundArena.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Declares RoundArena, a monotonic allocator for objects that only live for
+one round (showdown hands, discard selections, and so on), and
+ArenaAllocator, an STL allocator that draws from whichever RoundArena is
+active on the current thread.  Memory handed out by an arena is never freed
+one piece at a time; reset() releases all of it at once.
+
+Every allocation made through ArenaAllocator is tagged with the arena it
+came from, so containers may be created inside a Scope and freed outside
+it (or the other way around).  A container that holds arena memory must
+be destroyed or emptied before its arena is reset.
+*/
+
+#ifndef ROUND_ARENA_H
+#define ROUND_ARENA_H
+
+#include <cstddef>
+#include <new>
+
+class RoundArena
+{
+public:
+	RoundArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+	~RoundArena();
+
+	void * allocate(size_t bytes);
+	void reset();
+	size_t bytesUsed() const;
+
+	static RoundArena * current();
+	static void * allocateTagged(size_t bytes);
+	static void deallocateTagged(void * p);
+
+	/*
+	Makes an arena the current thread's active arena until the Scope ends.
+	Never suspend a Coroutine inside a Scope: whatever runs on the thread
+	next would allocate from this arena.
+	*/
+	class Scope
+	{
+	public:
+		Scope(RoundArena & arena) : previous(currentArena) { currentArena = &arena; }
+		~Scope() { currentArena = previous; }
+
+	private:
+		Scope(const Scope & other);
+		Scope & operator= (const Scope & other);
+
+		RoundArena * previous;
+	};
+
+	static const size_t DEFAULT_BLOCK_SIZE = 16 * 1024;
+	static const size_t ALIGNMENT = 16;
+
+private:
+	// Undefined, so that no copies can be made.
+	RoundArena(const RoundArena & other);
+	RoundArena & operator= (const RoundArena & other);
+
+	struct Block
+	{
+		Block * next;
+		size_t size;
+	};
+
+	void addBlock(size_t minBytes);
+
+	Block * blocks; // Most recent first
+	char * cursor;
+	char * end;
+	size_t blockSize;
+	size_t used;
+
+	static thread_local RoundArena * currentArena;
+};
+
+/*
+Allocates from the current thread's active RoundArena, or from the heap if
+there is none.  All ArenaAllocators compare equal, so containers using them
+can be copied, swapped and spliced freely.
+*/
+template <class T>
+class ArenaAllocator
+{
+public:
+	typedef T value_type;
+
+	ArenaAllocator() {}
+	template <class U>
+	ArenaAllocator(const ArenaAllocator<U> & /* other */) {}
+
+	T * allocate(size_t n)
+	{
+		return static_cast<T *>(RoundArena::allocateTagged(n * sizeof(T)));
+	}
+
+	void deallocate(T * p, size_t /* n */)
+	{
+		RoundArena::deallocateTagged(p);
+	}
+
+	template <class U>
+	struct rebind
+	{
+		typedef ArenaAllocator<U> other;
+	};
+};
+
+template <class T, class U>
+bool operator== (const ArenaAllocator<T> & /* one */, const ArenaAllocator<U> & /* two */) { return true; }
+
+template <class T, class U>
+bool operator!= (const ArenaAllocator<T> & /* one */, const ArenaAllocator<U> & /* two */) { return false; }
+
+inline RoundArena * RoundArena::current()
+{
+	return currentArena;
+}
+
+/*
+Allocates bytes from the active arena (or the heap), preceded by a header
+that records where they came from.
+*/
+inline void * RoundArena::allocateTagged(size_t bytes)
+{
+	RoundArena * arena = currentArena;
+	char * p;
+	if (arena)
+		p = static_cast<char *>(arena->allocate(bytes + ALIGNMENT));
+	else
+		p = static_cast<char *>(::operator new(bytes + ALIGNMENT));
+
+	*reinterpret_cast<RoundArena **>(p) = arena;
+	return p + ALIGNMENT;
+}
+
+/*
+Frees memory from allocateTagged().  Heap memory is deleted; arena memory
+is left for the arena's next reset().
+*/
+inline void RoundArena::deallocateTagged(void * p)
+{
+	char * header = static_cast<char *>(p) - ALIGNMENT;
+	if (*reinterpret_cast<RoundArena **>(header) == 0)
+		::operator delete(header);
+}
+
+#endif
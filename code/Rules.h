@@ -0,0 +1,134 @@
+/*
+Rules.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Compile-time rule policies for the headless Simulation, one per variant.
+Each policy fixes the deck size, hand size, number of betting streets and
+seat limit as constants, and deals each street through static functions
+that the Simulation calls directly.  The interactive Game subclasses keep
+their virtual interface; these policies only describe the same rules.
+*/
+
+#ifndef RULES_H
+#define RULES_H
+
+#include "FiveCardDraw.h"
+#include "SevenCardStud.h"
+#include "TexasHoldEm.h"
+#include "TableState.h"
+
+struct FiveCardDrawRules
+{
+	static const size_t DECK_SIZE = FiveCardDraw::DECK_SIZE;
+	static const size_t HAND_SIZE = Hand::POKER_HAND_SIZE;
+	static const size_t STREETS = 2; // After the deal, and after the draw
+	static const size_t MAX_PLAYERS = FiveCardDraw::MAX_PLAYERS;
+	static const bool USES_COMMUNITY = false;
+	static const char * name() { return "FiveCardDraw"; }
+	static const ScenarioVariant SCENARIO = SCENARIO_FIVE_CARD_DRAW;
+
+	/*
+	Street 0 deals five cards to everybody, one at a time.  Street 1 lets
+	every player still in the round discard and draws back up to five.
+	*/
+	template <class Sim>
+	static void deal(Sim & sim, size_t street)
+	{
+		if (street == 0)
+		{
+			for (size_t i = 0; i < HAND_SIZE; i++)
+				sim.goAround([&sim](size_t seatNum) { sim.dealTo(seatNum); });
+		}
+		else
+		{
+			sim.goAround([&sim](size_t seatNum) { sim.drawCards(seatNum); });
+		}
+	}
+
+	static void showdownHand(const TableState & table, size_t seatNum, Hand & best)
+	{
+		best = Hand(table.holeCards[seatNum]);
+		best.calculateRank();
+	}
+};
+
+struct SevenCardStudRules
+{
+	static const size_t DECK_SIZE = SevenCardStud::DECK_SIZE;
+	static const size_t HAND_SIZE = Hand::STUD_HAND_SIZE;
+	static const size_t STREETS = 5; // Third street through seventh street
+	static const size_t MAX_PLAYERS = SevenCardStud::MAX_PLAYERS;
+	static const bool USES_COMMUNITY = false;
+	static const char * name() { return "SevenCardStud"; }
+	static const ScenarioVariant SCENARIO = SCENARIO_SEVEN_CARD_STUD;
+
+	/*
+	Street 0 deals three cards (two down, one up) and every later street
+	deals one.  The Simulation has no hidden information, so face up and
+	face down cards are dealt the same way.
+	*/
+	template <class Sim>
+	static void deal(Sim & sim, size_t street)
+	{
+		if (street == 0)
+		{
+			sim.goAround([&sim](size_t seatNum) {
+				sim.dealTo(seatNum);
+				sim.dealTo(seatNum);
+				sim.dealTo(seatNum);
+			});
+		}
+		else
+		{
+			sim.goAround([&sim](size_t seatNum) { sim.dealTo(seatNum); });
+		}
+	}
+
+	static void showdownHand(const TableState & table, size_t seatNum, Hand & best)
+	{
+		Hand whole(table.holeCards[seatNum]);
+		best = whole.bestStudHand();
+	}
+};
+
+struct TexasHoldEmRules
+{
+	static const size_t DECK_SIZE = TexasHoldEm::DECK_SIZE;
+	static const size_t HAND_SIZE = TexasHoldEm::HAND_SIZE;
+	static const size_t STREETS = 4; // Pre-flop, flop, turn and river
+	static const size_t MAX_PLAYERS = TexasHoldEm::MAX_PLAYERS;
+	static const bool USES_COMMUNITY = true;
+	static const char * name() { return "TexasHoldEm"; }
+	static const ScenarioVariant SCENARIO = SCENARIO_TEXAS_HOLD_EM;
+
+	/*
+	Street 0 deals two face down cards to everybody.  Street 1 is the
+	flop; streets 2 and 3 are the turn and the river.
+	*/
+	template <class Sim>
+	static void deal(Sim & sim, size_t street)
+	{
+		if (street == 0)
+		{
+			sim.goAround([&sim](size_t seatNum) {
+				sim.dealTo(seatNum);
+				sim.dealTo(seatNum);
+			});
+		}
+		else
+		{
+			size_t numCards = (street == 1 ? 3 : 1);
+			for (size_t i = 0; i < numCards; i++)
+				sim.dealCommunity();
+		}
+	}
+
+	static void showdownHand(const TableState & table, size_t seatNum, Hand & best)
+	{
+		Hand whole(table.holeCards[seatNum] | table.community);
+		best = whole.bestStudHand();
+	}
+};
+
+#endif
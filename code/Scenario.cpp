@@ -0,0 +1,309 @@
+/*
+Scenario.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Defines ScenarioWriter and ScenarioReader.
+*/
+
+#include "stdafx.h"
+#include "Scenario.h"
+#include "Deck.h"
+
+#include <string.h>
+
+using namespace std;
+
+namespace
+{
+	void putLittleEndian(unsigned char * bytes, unsigned long value, size_t numBytes)
+	{
+		for (size_t i = 0; i < numBytes; i++)
+			bytes[i] = (unsigned char)(value >> (8 * i));
+	}
+
+	unsigned long getLittleEndian(const unsigned char * bytes, size_t numBytes)
+	{
+		unsigned long value = 0;
+		for (size_t i = 0; i < numBytes; i++)
+			value |= (unsigned long)bytes[i] << (8 * i);
+		return value;
+	}
+
+	void writeHeader(ofstream & file, ScenarioVariant variant, unsigned long numDeals)
+	{
+		unsigned char header[Scenario::HEADER_SIZE] = {0};
+		memcpy(header, Scenario::MAGIC, sizeof(Scenario::MAGIC));
+		putLittleEndian(header + 4, Scenario::VERSION, 2);
+		header[6] = (unsigned char)variant;
+		putLittleEndian(header + 8, numDeals, 4);
+
+		file.seekp(0);
+		file.write(reinterpret_cast<const char *>(header), sizeof(header));
+	}
+}
+
+/*
+Packs numCards card indices into packed, which must hold 
+Scenario::packedSize(numCards) bytes.  A card may straddle two bytes.
+*/
+void Scenario::packCards(const unsigned char indices[], size_t numCards, unsigned char * packed)
+{
+	size_t size = packedSize(numCards);
+	memset(packed, 0, size);
+
+	size_t bitPos = 0;
+	for (size_t i = 0; i < numCards; i++, bitPos += BITS_PER_CARD)
+	{
+		unsigned bits = (unsigned)(indices[i] & 0x3F) << (bitPos % 8);
+		packed[bitPos / 8] |= (unsigned char)bits;
+		if (bitPos / 8 + 1 < size)
+			packed[bitPos / 8 + 1] |= (unsigned char)(bits >> 8);
+	}
+}
+
+/*
+Inverse of packCards().  Does not check the indices.
+*/
+void Scenario::unpackCards(const unsigned char * packed, size_t numCards, unsigned char indices[])
+{
+	size_t size = packedSize(numCards);
+
+	size_t bitPos = 0;
+	for (size_t i = 0; i < numCards; i++, bitPos += BITS_PER_CARD)
+	{
+		unsigned bits = packed[bitPos / 8];
+		if (bitPos / 8 + 1 < size)
+			bits |= (unsigned)packed[bitPos / 8 + 1] << 8;
+		indices[i] = (unsigned char)((bits >> (bitPos % 8)) & 0x3F);
+	}
+}
+
+////////////////////
+// ScenarioWriter //
+////////////////////
+
+/*
+Creates or truncates the specified file and writes a header to it.  The
+header's deal count is filled in by close().
+
+Throws fstream::failure if the file cannot be opened.
+*/
+ScenarioWriter::ScenarioWriter(const char fileName[], ScenarioVariant variant)
+	: file(fileName, ios::out | ios::binary | ios::trunc), variant(variant), numDeals(0)
+{
+	if (!file)
+		throw fstream::failure("Scenario file could not be opened");
+
+	writeHeader(file, variant, 0);
+}
+
+ScenarioWriter::~ScenarioWriter()
+{
+	try
+	{
+		close();
+	}
+	catch (fstream::failure &) {} // Destructors must not throw
+}
+
+/*
+Appends a deal.  indices holds numCards card indices (see Card::toIndex()),
+in the order they are to be dealt.
+
+Throws invalid_argument if there are too many cards, a bad index, or the
+same card twice.
+Throws fstream::failure if the writer is closed or the write fails.
+*/
+void ScenarioWriter::addDeal(const unsigned char indices[], size_t numCards)
+{
+	if (!file.is_open())
+		throw fstream::failure("Scenario file is closed");
+	if (numCards > Scenario::MAX_DEAL_CARDS)
+		throw invalid_argument("A deal cannot have more cards than a deck");
+
+	CardMask seen = 0;
+	for (size_t i = 0; i < numCards; i++)
+	{
+		if (indices[i] >= Card::NUM_CARDS)
+			throw invalid_argument("Bad card in deal");
+		if (seen & ((CardMask)1 << indices[i]))
+			throw invalid_argument("Duplicate card in deal");
+		seen |= (CardMask)1 << indices[i];
+	}
+
+	unsigned char record[1 + (Scenario::MAX_DEAL_CARDS * Scenario::BITS_PER_CARD + 7) / 8];
+	record[0] = (unsigned char)numCards;
+	Scenario::packCards(indices, numCards, record + 1);
+
+	file.write(reinterpret_cast<const char *>(record), 1 + Scenario::packedSize(numCards));
+	if (!file)
+		throw fstream::failure("Could not write to scenario file");
+	numDeals++;
+}
+
+/*
+Same as above, but takes Cards.
+
+Throws invalid_argument if any card is bad.
+*/
+void ScenarioWriter::addDeal(const std::vector<Card> & cards)
+{
+	unsigned char indices[Scenario::MAX_DEAL_CARDS];
+	if (cards.size() > Scenario::MAX_DEAL_CARDS)
+		throw invalid_argument("A deal cannot have more cards than a deck");
+
+	for (size_t i = 0; i < cards.size(); i++)
+	{
+		int index = cards[i].toIndex();
+		if (index < 0)
+			throw invalid_argument("Bad card in deal");
+		indices[i] = (unsigned char)index;
+	}
+
+	addDeal(indices, cards.size());
+}
+
+/*
+Fills in the header's deal count and closes the file.  Does nothing if the
+file is already closed.
+
+Throws fstream::failure if the header cannot be written.
+*/
+void ScenarioWriter::close()
+{
+	if (!file.is_open())
+		return;
+
+	writeHeader(file, variant, numDeals);
+	bool ok = !file.fail();
+	file.close();
+	if (!ok)
+		throw fstream::failure("Could not write to scenario file");
+}
+
+unsigned long ScenarioWriter::getNumDeals() const
+{
+	return numDeals;
+}
+
+////////////////////
+// ScenarioReader //
+////////////////////
+
+/*
+Opens a scenario file and reads its header.
+
+Throws fstream::failure if the file cannot be opened or is not a scenario
+of a version this reader understands.
+*/
+ScenarioReader::ScenarioReader(const char fileName[])
+	: file(fileName, ios::in | ios::binary), variant(SCENARIO_ANY), numDeals(0), dealsRead(0)
+{
+	if (!file)
+		throw fstream::failure("Scenario file could not be opened");
+
+	unsigned char header[Scenario::HEADER_SIZE];
+	file.read(reinterpret_cast<char *>(header), sizeof(header));
+	if (file.gcount() != sizeof(header) || memcmp(header, Scenario::MAGIC, sizeof(Scenario::MAGIC)) != 0)
+		throw fstream::failure("Not a scenario file");
+	if (getLittleEndian(header + 4, 2) != Scenario::VERSION)
+		throw fstream::failure("Unsupported scenario version");
+	if (header[6] > SCENARIO_TEXAS_HOLD_EM)
+		throw fstream::failure("Unknown variant in scenario file");
+
+	variant = (ScenarioVariant)header[6];
+	numDeals = getLittleEndian(header + 8, 4);
+}
+
+/*
+Reads the next deal into indices, which must hold Scenario::MAX_DEAL_CARDS
+entries, and sets numCards.  Returns false if every deal has been read.
+
+Throws fstream::failure if the file is cut short or holds a bad or
+duplicate card.
+*/
+bool ScenarioReader::nextDeal(unsigned char indices[], size_t & numCards)
+{
+	if (dealsRead >= numDeals)
+		return false;
+
+	unsigned char packed[1 + (Scenario::MAX_DEAL_CARDS * Scenario::BITS_PER_CARD + 7) / 8];
+	file.read(reinterpret_cast<char *>(packed), 1);
+	if (file.gcount() != 1 || packed[0] > Scenario::MAX_DEAL_CARDS)
+		throw fstream::failure("Scenario file is corrupt");
+
+	numCards = packed[0];
+	size_t length = Scenario::packedSize(numCards);
+	file.read(reinterpret_cast<char *>(packed + 1), length);
+	if ((size_t)file.gcount() != length)
+		throw fstream::failure("Scenario file is corrupt");
+
+	Scenario::unpackCards(packed + 1, numCards, indices);
+
+	CardMask seen = 0;
+	for (size_t i = 0; i < numCards; i++)
+	{
+		if (indices[i] >= Card::NUM_CARDS || (seen & ((CardMask)1 << indices[i])))
+			throw fstream::failure("Scenario file is corrupt");
+		seen |= (CardMask)1 << indices[i];
+	}
+
+	dealsRead++;
+	return true;
+}
+
+/*
+Replaces the contents of deck with the next deal, first card on top.
+Cards the deal does not list follow it in standard order, so a deal that
+only lists the cards that matter still leaves a full deck.  Returns false,
+leaving deck alone, if every deal has been read.
+
+Throws fstream::failure if the file is cut short or holds a bad card.
+*/
+bool ScenarioReader::nextDeal(Deck & deck)
+{
+	unsigned char indices[Scenario::MAX_DEAL_CARDS];
+	size_t numCards;
+	if (!nextDeal(indices, numCards))
+		return false;
+
+	deck.clear();
+	CardMask listed = 0;
+	for (size_t i = 0; i < numCards; i++)
+	{
+		deck.add_card(Card::fromIndex(indices[i]));
+		listed |= (CardMask)1 << indices[i];
+	}
+	for (int i = 0; i < Card::NUM_CARDS; i++)
+	{
+		if (!(listed & ((CardMask)1 << i)))
+			deck.add_card(Card::fromIndex(i));
+	}
+	return true;
+}
+
+/*
+Goes back to the first deal.
+*/
+void ScenarioReader::rewind()
+{
+	file.clear();
+	file.seekg(Scenario::HEADER_SIZE);
+	dealsRead = 0;
+}
+
+ScenarioVariant ScenarioReader::getVariant() const
+{
+	return variant;
+}
+
+unsigned long ScenarioReader::getNumDeals() const
+{
+	return numDeals;
+}
+
+unsigned long ScenarioReader::getDealsRead() const
+{
+	return dealsRead;
+}
@@ -0,0 +1,102 @@
+/*
+Scenario.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Declares ScenarioWriter and ScenarioReader, for binary files of
+predetermined deals.  A scenario is a 16-byte header followed by one record
+per deal.  Each record is a count of cards followed by the cards in the
+order they are to be dealt, packed 6 bits each.  Readers stream one deal
+at a time, so a scenario can hold millions of deals.
+
+Header, little-endian:
+	bytes 0-3    "TPSC"
+	bytes 4-5    format version
+	byte  6      ScenarioVariant
+	byte  7      reserved, 0
+	bytes 8-11   number of deals
+	bytes 12-15  reserved, 0
+*/
+
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include "Card.h"
+
+#include <fstream>
+#include <vector>
+
+class Deck;
+
+enum ScenarioVariant
+{
+	SCENARIO_ANY = 0, // Usable by every variant
+	SCENARIO_FIVE_CARD_DRAW = 1,
+	SCENARIO_SEVEN_CARD_STUD = 2,
+	SCENARIO_TEXAS_HOLD_EM = 3
+};
+
+class ScenarioWriter
+{
+public:
+	ScenarioWriter(const char fileName[], ScenarioVariant variant = SCENARIO_ANY);
+	~ScenarioWriter();
+
+	void addDeal(const unsigned char indices[], size_t numCards);
+	void addDeal(const std::vector<Card> & cards);
+	void close();
+
+	unsigned long getNumDeals() const;
+
+private:
+	// Undefined, so that no copies can be made.
+	ScenarioWriter(const ScenarioWriter & other);
+	ScenarioWriter & operator= (const ScenarioWriter & other);
+
+	std::ofstream file;
+	ScenarioVariant variant;
+	unsigned long numDeals;
+};
+
+class ScenarioReader
+{
+public:
+	ScenarioReader(const char fileName[]);
+
+	bool nextDeal(unsigned char indices[], size_t & numCards);
+	bool nextDeal(Deck & deck);
+	void rewind();
+
+	ScenarioVariant getVariant() const;
+	unsigned long getNumDeals() const;
+	unsigned long getDealsRead() const;
+
+private:
+	// Undefined, so that no copies can be made.
+	ScenarioReader(const ScenarioReader & other);
+	ScenarioReader & operator= (const ScenarioReader & other);
+
+	std::ifstream file;
+	ScenarioVariant variant;
+	unsigned long numDeals;
+	unsigned long dealsRead;
+};
+
+namespace Scenario
+{
+	static const char MAGIC[4] = {'T', 'P', 'S', 'C'};
+	static const unsigned VERSION = 1;
+	static const size_t HEADER_SIZE = 16;
+	static const size_t MAX_DEAL_CARDS = Card::NUM_CARDS;
+	static const size_t BITS_PER_CARD = 6;
+
+	// Bytes needed for numCards packed cards
+	inline size_t packedSize(size_t numCards) { return (numCards * BITS_PER_CARD + 7) / 8; }
+
+	// Packing of card indices, 6 bits each, least significant bit first.
+	// Also used by the hand history.
+	void packCards(const unsigned char indices[], size_t numCards, unsigned char * packed);
+	void unpackCards(const unsigned char * packed, size_t numCards, unsigned char indices[]);
+}
+
+#endif
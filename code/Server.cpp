@@ -0,0 +1,62 @@
+/*
+Server.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Entry point for the table server, built as its own executable.  See 
+TableServer.h for the protocol.  A client can be as simple as:
+	socat - UNIX-CONNECT:socketPath
+
+Usage: Server [--quiet] [--history file] socketPath
+Quiet tables send only results and problems, not tables or prompts.  With 
+a history file, every table's rounds are appended to it.
+*/
+
+#include "stdafx.h"
+#include "TableServer.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main(int argc, char * argv[])
+{
+	const char * socketPath = 0;
+	const char * historyFile = 0;
+	Verbosity verbosity = NORMAL;
+	bool usage = false;
+	for (int i = 1; i < argc; i++)
+	{
+		string arg(argv[i]);
+		if (arg == "--quiet")
+			verbosity = QUIET;
+		else if (arg == "--history" && i + 1 < argc)
+			historyFile = argv[++i];
+		else if (!socketPath && arg.length() > 0 && arg[0] != '-')
+			socketPath = argv[i];
+		else
+			usage = true;
+	}
+
+	if (usage || !socketPath)
+	{
+		cout << "Usage: " << argv[0] << " [--quiet] [--history file] socketPath" << endl;
+		return 1;
+	}
+
+	try
+	{
+		TableServer server(socketPath, verbosity, historyFile);
+		cout << "Listening on " << socketPath << endl;
+		server.run();
+	}
+	catch (runtime_error & e)
+	{
+		cout << e.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
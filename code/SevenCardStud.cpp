@@ -9,6 +9,7 @@ Defines all necessary functions for making a game of Seven Card Stud.
 #include "StdAfx.h"
 #include "SevenCardStud.h"
 #include "GameException.h"
+#include "Profiler.h"
 
 #include <iostream>
 #include <algorithm>
@@ -26,22 +27,23 @@ SevenCardStud::SevenCardStud() : Game(DECK_SIZE, MAX_PLAYERS)
 
 /*
 Runs the game until all players leave or there is an error.  
-Calls stop_game() automatically.
+Calls finish() automatically.
 */
 void SevenCardStud::play()
 {
 	addPlayersPrompt();
 
 	try{ while (true) {
-		cout << endl;
+		screen.present(); // Each round is a frame
+		screen.at(NORMAL) << '\n';
 		if (players.size() == 0)
 		{
-			cout << "There are no more players in the game.  Stopping..." << endl;
-			stop_game();
+			screen.at(QUIET) << "There are no more players in the game.  Stopping...\n";
+			finish();
 			break;
 		}
 
-		int winner = before_round();
+		int winner = SevenCardStud::before_round();
 		if (winner)
 		{
 			earlyWin();
@@ -49,8 +51,8 @@ void SevenCardStud::play()
 			continue;
 		}
 
-		cout << endl;
-		winner = round();
+		screen.at(NORMAL) << '\n';
+		winner = SevenCardStud::round();
 		if (winner)
 		{
 			earlyWin();
@@ -58,14 +60,14 @@ void SevenCardStud::play()
 			continue;
 		}
 
-		cout << endl;
-		after_round();
+		screen.at(NORMAL) << '\n';
+		SevenCardStud::after_round();
 	}}
 	catch (GameException e)
 	{
-		cout << "Oh dear - " << e.what() << endl;
-		cout << "The game ran into a problem.  Stopping..." << endl;
-		stop_game();
+		screen.at(QUIET) << "Oh dear - " << e.what() << '\n';
+		screen.at(QUIET) << "The game ran into a problem.  Stopping...\n";
+		finish();
 	}
 }
 
@@ -124,8 +126,8 @@ int SevenCardStud::after_turn(Player & p)
 }
 
 /*
-Shuffles the deck.  Collects ante.  Deals initial hands.  Prints them.  
-Does a round of betting.  
+Shuffles the deck, or takes the next deal from the scenario.  Collects 
+ante.  Deals initial hands.  Prints them.  Does a round of betting.  
 
 Returns 0 on success.  
 Returns EARLY_WINNER if only one player remains due to folding.  
@@ -134,20 +136,21 @@ Throws GameException if the deck runs out of cards.
 */
 int SevenCardStud::before_round()
 {
+	PROFILE_PHASE("before_round");
 	if (players.size() == 0)
 		return 0;
 
 	if (players.size() > MAX_PLAYERS)
 		throw GameException("Not enough cards to support this number of players.");
 
-	deck.shuffle();
+	prepareDeck();
 
 	allJoinRound();
 	collectAnte();
-	goAround(mem_fun(&Game::before_turn)); // Throws GameException
+	goAround([this](Player & p) { return SevenCardStud::before_turn(p); }); // Throws GameException
 
 	printAllHands();
-	cout << endl;
+	screen.at(NORMAL) << '\n';
 
 	collectBets();
 	if (playersInRound == 1)
@@ -165,24 +168,25 @@ Throws GameException if the deck runs out of cards.
 */
 int SevenCardStud::round()
 {
+	PROFILE_PHASE("round");
 	if (players.size() == 0)
 		return 0;
 
 	for (int i = 0; i < MIDDLE_TURNS; i++)
 	{
-		goAround(mem_fun(&Game::turn)); // Throws GameException 
+		goAround([this](Player & p) { return SevenCardStud::turn(p); }); // Throws GameException 
 		printAllHands();
 		
-		cout << endl;
+		screen.at(NORMAL) << '\n';
 		collectBets();
 		if (playersInRound == 1)
 			return EARLY_WINNER;
 	}
 
-	goAround(mem_fun(&Game::after_turn)); // Throws GameException
+	goAround([this](Player & p) { return SevenCardStud::after_turn(p); }); // Throws GameException
 	printAllHands();
 	
-	cout << endl;
+	screen.at(NORMAL) << '\n';
 	collectBets();
 	if (playersInRound == 1)
 		return EARLY_WINNER;
@@ -198,37 +202,38 @@ Returns 0 on success.
 */
 int SevenCardStud::after_round()
 {
+	PROFILE_PHASE("after_round");
 	if (players.size() == 0)
 		return 0;
 
-	vector<pair<Player *, Hand *>> bestHands;
+	vector<Player *> winners;
+	{
+	RoundArena::Scope scope(roundArena); // Showdown hands come from the arena
+	vector<pair<Player *, Hand>, ArenaAllocator<pair<Player *, Hand>>> bestHands;
 	for (unsigned int i = 0; i < players.size(); i++)
 	{ // bestStudHand will throw an exception on hands that are not 7 cards.
 		if (players[i]->inRound) // Only players that haven't folded should have 7 cards.
-			bestHands.push_back(pair<Player *, Hand *>(players[i], players[i]->hand.bestStudHand()));
+			bestHands.push_back(pair<Player *, Hand>(players[i], players[i]->hand.bestStudHand()));
 		else
 			players[i]->losses++;
 	}
 
 	sort(bestHands.begin(), bestHands.end(), compStudPlayers);
 
-	vector<Player *> winners;
 	winners.push_back(bestHands.front().first);
 	for (unsigned int i = 1; i < bestHands.size(); i++)
 	{
-		if (bestHands.front().second->sameRankAs(*bestHands[i].second))
+		if (bestHands.front().second.sameRankAs(bestHands[i].second))
 			winners.push_back(bestHands[i].first);
 		else
 			break;
 	}
 
-	awardWinners(winners);
-
 	for (unsigned int i = winners.size(); i < bestHands.size(); i++)
 		bestHands[i].first->losses++;
+	}
 
-	for (unsigned int i = 0; i < bestHands.size(); i++)
-		delete bestHands[i].second;
+	awardWinners(winners);
 
 	printStatsAndHands();
 	cleanup();
@@ -236,18 +241,19 @@ int SevenCardStud::after_round()
 	return 0;
 }
 
-bool SevenCardStud::compStudPlayers(std::pair<Player *, Hand *> one, std::pair<Player *, Hand *> two)
+bool SevenCardStud::compStudPlayers(const std::pair<Player *, Hand> & one, const std::pair<Player *, Hand> & two)
 {
-	return Hand::poker_rank(*one.second, *two.second);
+	return Hand::poker_rank(one.second, two.second);
 }
 
 /*
-Moves all Players' cards back to the main deck.  Prompts to add and remove Players.  
-Increments the dealer position.
+Moves all Players' cards back to the main deck and releases the round's 
+temporaries.  Prompts to add and remove Players.  Increments the dealer position.
 */
 void SevenCardStud::cleanup()
 {
 	allHandsToDeck();
+	roundArena.reset();
 	removePlayersPrompt();
 	addPlayersPrompt();
 
@@ -258,10 +264,18 @@ void SevenCardStud::cleanup()
 
 void SevenCardStud::printAllHands()
 {
-	cout << "Here's everybody's hands:" << endl;
+	if (!screen.shows(NORMAL))
+		return;
+
+	ostream & out = screen.at(NORMAL);
+	out << "Here's everybody's hands:\n";
 	for (unsigned int i = 0; i < players.size(); i++)
 	{
 		if (players[i]->inRound)
-			cout << players[i]->name << ": " << players[i]->hand.toString_hideFaceDown() << endl;
+		{
+			out << players[i]->name << ": ";
+			printHand(*players[i], false);
+			out << '\n';
+		}
 	}
 }
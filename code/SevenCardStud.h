@@ -24,7 +24,7 @@ public:
 	virtual int round();
 	virtual int after_round();
 	
-	static bool compStudPlayers(std::pair<Player *, Hand *> one, std::pair<Player *, Hand *> two);
+	static bool compStudPlayers(const std::pair<Player *, Hand> & one, const std::pair<Player *, Hand> & two);
 
 	static const size_t DECK_SIZE = 52;
 	static const size_t MAX_PLAYERS = DECK_SIZE/Hand::STUD_HAND_SIZE;
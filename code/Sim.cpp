@@ -0,0 +1,597 @@
+/*
+Sim.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Entry point for the offline simulator, built as its own executable.  Plays 
+a large number of hands on many independent headless tables, with random 
+decisions, across all cores, and reports the totals and the rate.
+
+Each table plays its hands in batches.  A batch is one task on a 
+WorkStealingPool; when it ends, it queues the table's next batch on the 
+same worker, so a table stays on one core while it can, and idle workers 
+steal batches from busy ones.  Every worker adds its results into its own 
+SimTotals, and those are merged once all tables are done.
+
+Table t shuffles hand k from CounterRng stream t, position k, under the 
+seed, and makes its decisions from its own generator, so the same seed 
+gives the same totals however many threads play and whichever ones steal.  
+--deal t k prints the deck that hand k of table t is dealt from, without 
+playing anything.
+
+--shard i/n plays only the i-th of n equal ranges of tables (counting from
+0), so a run can be split over processes or hosts that share nothing but
+the command line; --tables is then required, so every shard agrees on the
+tables.  --out saves the results (see SimResults), and SimMerge adds shard
+files together into the results of the whole run.
+
+--checkpoint file saves a SimCheckpoint every --every seconds (60 by
+default).  To save one, tables stop at the end of their current batch
+instead of queueing the next, so once the pool is idle every table is
+between hands.  If the file already exists, the run carries on from it
+instead of starting over; it must have been started with the same
+options, except for --threads, --batch, --pin and --every.  A resumed
+run ends with the same results as one that was never stopped.
+
+--history file appends every hand to a hand-history file (see
+HandHistory.h), which Replay can check and HistoryStore can index.  All
+tables share one HistoryWriter; table t's hands are under table id t, and
+hand k is hand number k.  A resumed run appends to the same file, in a
+session of its own, starting from the checkpoint, so hands played after
+the last checkpoint are in the file twice.
+
+--scenario file deals every table's hands from a scenario file (see 
+Scenario.h and MakeScenario) instead of shuffling.  Each table reads the 
+file from its first deal, and fails if it runs out of deals.  A resumed 
+run skips the deals of the hands already played.
+
+Usage: Sim [--variant name] [--tables n] [--seats n] [--hands n] 
+           [--batch n] [--threads n] [--pin] [--seed n] [--deal t k]
+           [--shard i/n] [--out file] [--checkpoint file] [--every s]
+           [--history file] [--scenario file]
+The variant is FiveCardDraw, SevenCardStud, TexasHoldEm or all (the 
+default), which deals the variants out to tables in turn.  With --seats 0 
+(the default), tables have anywhere from 2 seats to the variant's maximum, 
+so that some tables' rounds take much longer than others'.  Otherwise 
+--seats may not be more than the maximum of any variant played.  --hands 
+is the total over all tables.
+*/
+
+#include "stdafx.h"
+#include "Rules.h"
+#include "Strategy.h"
+#include "Simulation.h"
+#include "WorkStealingPool.h"
+#include "SimResults.h"
+#include "SimCheckpoint.h"
+#include "Profiler.h"
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+
+/*
+What one worker has seen.  Padded so that workers' totals do not share a 
+cache line.
+*/
+struct SimTotals
+{
+	SimTotals() : hands(0), showdowns(0), earlyWins(0) {}
+
+	void merge(const SimTotals & other)
+	{
+		hands += other.hands;
+		showdowns += other.showdowns;
+		earlyWins += other.earlyWins;
+	}
+
+	unsigned long long hands;
+	unsigned long long showdowns;
+	unsigned long long earlyWins;
+	char padding[64];
+};
+
+/*
+A headless table of any variant.
+*/
+class SimTable
+{
+public:
+	virtual ~SimTable() {}
+	virtual void play(unsigned long hands, SimTotals & totals) = 0;
+	virtual const TableState & state() const = 0;
+	virtual void saveState(vector<unsigned char> & out) const = 0;
+	virtual void restoreState(const vector<unsigned char> & saved) = 0;
+	virtual void recordHistory(HistoryWriter * writer) = 0;
+	virtual void useScenario(const char fileName[]) = 0;
+};
+
+template <class Rules>
+class SimTableOf : public SimTable
+{
+public:
+	SimTableOf(size_t numSeats, unsigned long long seed, unsigned tableNum)
+		: sim(numSeats, RandomStrategy(seed * 1000003ULL + tableNum)), tableNum(tableNum)
+	{
+		sim.seedShuffles(seed, tableNum);
+	}
+
+	void play(unsigned long hands, SimTotals & totals)
+	{
+		for (unsigned long i = 0; i < hands; i++)
+		{
+			if (sim.playRound() == Simulation<Rules, RandomStrategy>::EARLY_WINNER)
+				totals.earlyWins++;
+			else
+				totals.showdowns++;
+		}
+		totals.hands += hands;
+	}
+
+	const TableState & state() const
+	{
+		return sim.state();
+	}
+
+	void saveState(vector<unsigned char> & out) const
+	{
+		sim.saveState(out);
+	}
+
+	void restoreState(const vector<unsigned char> & saved)
+	{
+		sim.restoreState(saved.empty() ? 0 : &saved[0], saved.size());
+	}
+
+	void recordHistory(HistoryWriter * writer)
+	{
+		sim.recordHistory(writer, tableNum);
+	}
+
+	/*
+	Deals the rest of this table's rounds from a scenario file, which the 
+	table reads on its own.  Skips the deals of rounds already played.
+
+	Throws fstream::failure if the file cannot be read.
+	Throws invalid_argument if the scenario is for another variant.
+	*/
+	void useScenario(const char fileName[])
+	{
+		scenario.reset(new ScenarioReader(fileName));
+		unsigned char indices[Scenario::MAX_DEAL_CARDS];
+		size_t numCards;
+		for (unsigned long i = 0; i < sim.getRoundsPlayed(); i++)
+		{
+			if (!scenario->nextDeal(indices, numCards))
+				break; // The next round will fail
+		}
+		sim.useScenario(scenario.get());
+	}
+
+	static const size_t MAX_SEATS = Simulation<Rules, RandomStrategy>::MAX_SEATS;
+
+private:
+	Simulation<Rules, RandomStrategy> sim;
+	unsigned tableNum;
+	unique_ptr<ScenarioReader> scenario; // 0 to shuffle
+};
+
+/*
+Plays one batch of a table's hands, then queues the next, unless it is
+time to pause for a checkpoint.
+*/
+struct TableJob
+{
+	void operator() ()
+	{
+		unsigned long hands = (unsigned long)min(*left, (unsigned long long)batch);
+		table->play(hands, (*totals)[WorkStealingPool::currentWorker()]);
+		*left -= hands;
+		if (*left > 0 && chrono::steady_clock::now() < *pauseAt)
+			pool->submit(*this);
+	}
+
+	WorkStealingPool * pool;
+	SimTable * table;
+	vector<SimTotals> * totals; // One per worker
+	unsigned long long * left; // Only this job changes it
+	unsigned long batch;
+	const chrono::steady_clock::time_point * pauseAt; // Only changed while the pool is idle
+};
+
+/*
+Makes table number tableNum.  variantTurn counts only the tables of this 
+variant, to spread out their numbers of seats.
+*/
+template <class Rules>
+SimTable * makeTable(size_t numSeats, size_t variantTurn, unsigned long long seed, size_t tableNum)
+{
+	size_t maxSeats = SimTableOf<Rules>::MAX_SEATS;
+	if (numSeats == 0)
+		numSeats = 2 + variantTurn % (maxSeats - 1); // 2 to maxSeats
+	return new SimTableOf<Rules>(numSeats, seed, (unsigned)tableNum);
+}
+
+/*
+Prints the order of the deck that hand number hand of table number 
+tableNum is dealt from, top card first.
+*/
+void printDeal(unsigned long long seed, unsigned tableNum, unsigned long long hand)
+{
+	TableState table;
+	table.reset(2, 0);
+	table.dealFor(seed, tableNum, hand);
+
+	cout << "Table " << tableNum << ", hand " << hand << ", seed " << seed << ":";
+	for (int i = 0; i < Card::NUM_CARDS; i++)
+		cout << (i % 13 == 0 ? "\n" : " ") << Card::fromIndex(table.deck[i]).toCStr();
+	cout << endl;
+}
+
+/*
+Saves where every table is, and the totals so far.  Only call
+while the pool is idle.  A failure is reported but does not stop the run.
+*/
+void saveCheckpoint(const string & fileName, unsigned shard, const SimResults & run, const SimTotals & total,
+	const vector<unique_ptr<SimTable> > & tables, const vector<unsigned long long> & handsLeft, size_t firstTable)
+{
+	SimCheckpoint checkpoint;
+	checkpoint.shard = shard;
+	checkpoint.results = run;
+	checkpoint.results.hands = total.hands;
+	checkpoint.results.showdowns = total.showdowns;
+	checkpoint.results.earlyWins = total.earlyWins;
+	for (size_t i = 0; i < tables.size(); i++)
+	{
+		SimCheckpoint::Table saved;
+		saved.tableNum = (unsigned)(firstTable + i);
+		saved.handsLeft = handsLeft[i];
+		tables[i]->saveState(saved.state);
+		checkpoint.tables.push_back(saved);
+	}
+
+	try
+	{
+		checkpoint.save(fileName);
+	}
+	catch (fstream::failure & e)
+	{
+		cerr << "Could not save a checkpoint: " << e.what() << endl;
+	}
+}
+
+/*
+Carries on from a checkpoint, if there is one: restores its tables and
+totals.  Returns false if the checkpoint cannot be used for this run.
+*/
+bool resume(const string & fileName, unsigned shard, const SimResults & run, SimTotals & total,
+	vector<unique_ptr<SimTable> > & tables, vector<unsigned long long> & handsLeft, size_t firstTable)
+{
+	SimCheckpoint checkpoint;
+	try
+	{
+		if (!checkpoint.load(fileName))
+			return true;
+	}
+	catch (fstream::failure & e)
+	{
+		cout << e.what() << endl;
+		return false;
+	}
+
+	const SimResults & saved = checkpoint.results;
+	if (checkpoint.shard != shard || saved.variant != run.variant || saved.seed != run.seed ||
+		saved.totalHands != run.totalHands || saved.numTables != run.numTables || 
+		saved.numSeats != run.numSeats || saved.shardsDone.size() != run.shardsDone.size())
+	{
+		cout << fileName << " is a checkpoint of a different run." << endl;
+		return false;
+	}
+
+	if (checkpoint.tables.size() != tables.size())
+	{
+		cout << fileName << " has the wrong number of tables." << endl;
+		return false;
+	}
+
+	vector<unsigned long long> left(handsLeft.size(), 0);
+	try
+	{
+		for (size_t i = 0; i < checkpoint.tables.size(); i++)
+		{
+			const SimCheckpoint::Table & table = checkpoint.tables[i];
+			if (table.tableNum < firstTable || table.tableNum - firstTable >= tables.size())
+				throw invalid_argument("Table " + to_string((unsigned long long)table.tableNum) + " is not in this shard");
+			tables[table.tableNum - firstTable]->restoreState(table.state);
+			left[table.tableNum - firstTable] = table.handsLeft;
+		}
+	}
+	catch (invalid_argument & e)
+	{
+		cout << fileName << ": " << e.what() << endl;
+		return false;
+	}
+
+	handsLeft = left;
+	total.hands = saved.hands;
+	total.showdowns = saved.showdowns;
+	total.earlyWins = saved.earlyWins;
+	cout << "Resuming from " << fileName << " after " << total.hands << " hands." << endl;
+	return true;
+}
+
+int main(int argc, char * argv[])
+{
+	string variant = "all";
+	size_t numTables = 0;
+	size_t numSeats = 0;
+	unsigned long long totalHands = 1000000;
+	unsigned long batch = 1000;
+	unsigned numThreads = 0;
+	bool pinThreads = false;
+	unsigned long long seed = 1;
+	bool showDeal = false;
+	unsigned dealTable = 0;
+	unsigned long long dealHand = 0;
+	unsigned shard = 0;
+	unsigned numShards = 1;
+	const char * outFile = 0;
+	const char * checkpointFile = 0;
+	double checkpointSeconds = 60;
+	const char * historyFile = 0;
+	const char * scenarioFile = 0;
+	bool usage = false;
+	for (int i = 1; i < argc; i++)
+	{
+		string arg(argv[i]);
+		bool hasValue = (i + 1 < argc);
+		if (arg == "--variant" && hasValue)
+			variant = argv[++i];
+		else if (arg == "--tables" && hasValue)
+			numTables = strtoul(argv[++i], 0, 10);
+		else if (arg == "--seats" && hasValue)
+			numSeats = strtoul(argv[++i], 0, 10);
+		else if (arg == "--hands" && hasValue)
+			totalHands = strtoull(argv[++i], 0, 10);
+		else if (arg == "--batch" && hasValue)
+			batch = strtoul(argv[++i], 0, 10);
+		else if (arg == "--threads" && hasValue)
+			numThreads = strtoul(argv[++i], 0, 10);
+		else if (arg == "--pin")
+			pinThreads = true;
+		else if (arg == "--seed" && hasValue)
+			seed = strtoull(argv[++i], 0, 10);
+		else if (arg == "--deal" && i + 2 < argc)
+		{
+			showDeal = true;
+			dealTable = strtoul(argv[++i], 0, 10);
+			dealHand = strtoull(argv[++i], 0, 10);
+		}
+		else if (arg == "--shard" && hasValue)
+		{
+			char * slash;
+			shard = strtoul(argv[++i], &slash, 10);
+			if (*slash != '/')
+				usage = true;
+			else
+				numShards = strtoul(slash + 1, 0, 10);
+		}
+		else if (arg == "--out" && hasValue)
+			outFile = argv[++i];
+		else if (arg == "--checkpoint" && hasValue)
+			checkpointFile = argv[++i];
+		else if (arg == "--every" && hasValue)
+			checkpointSeconds = strtod(argv[++i], 0);
+		else if (arg == "--history" && hasValue)
+			historyFile = argv[++i];
+		else if (arg == "--scenario" && hasValue)
+			scenarioFile = argv[++i];
+		else
+			usage = true;
+	}
+	if (variant != "all" && variant != "FiveCardDraw" && variant != "SevenCardStud" && variant != "TexasHoldEm")
+		usage = true;
+	if (numShards == 0 || shard >= numShards || (numShards > 1 && numTables == 0) || checkpointSeconds <= 0)
+		usage = true;
+	if (usage || batch == 0 || numSeats == 1)
+	{
+		cout << "Usage: " << argv[0] << " [--variant name] [--tables n] [--seats n] [--hands n]" << endl;
+		cout << "       [--batch n] [--threads n] [--pin] [--seed n] [--deal t k]" << endl;
+		cout << "       [--shard i/n] [--out file] [--checkpoint file] [--every s]" << endl;
+		cout << "       [--history file] [--scenario file]" << endl;
+		cout << "Variants are FiveCardDraw, SevenCardStud, TexasHoldEm and all." << endl;
+		return 1;
+	}
+
+	size_t maxSeats = SimTableOf<TexasHoldEmRules>::MAX_SEATS;
+	if (variant == "all" || variant == "FiveCardDraw")
+		maxSeats = min(maxSeats, SimTableOf<FiveCardDrawRules>::MAX_SEATS);
+	if (variant == "all" || variant == "SevenCardStud")
+		maxSeats = min(maxSeats, SimTableOf<SevenCardStudRules>::MAX_SEATS);
+	if (numSeats > maxSeats)
+	{
+		cout << "--seats must be at most " << maxSeats << " for --variant " << variant << "." << endl;
+		return 1;
+	}
+
+	if (showDeal)
+	{
+		printDeal(seed, dealTable, dealHand);
+		return 0;
+	}
+
+	WorkStealingPool pool(numThreads, pinThreads);
+	if (numTables == 0)
+		numTables = pool.getNumThreads() * 8; // Enough to even out tables of different lengths
+	if (numTables > totalHands)
+		numTables = (size_t)max(totalHands, 1ULL);
+
+	size_t firstTable = (size_t)((unsigned long long)numTables * shard / numShards);
+	size_t endTable = (size_t)((unsigned long long)numTables * (shard + 1) / numShards);
+	vector<unique_ptr<SimTable> > tables;
+	for (size_t t = firstTable; t < endTable; t++)
+	{
+		string tableVariant = variant;
+		if (variant == "all")
+		{
+			const char * const variants[] = {"FiveCardDraw", "SevenCardStud", "TexasHoldEm"};
+			tableVariant = variants[t % 3];
+		}
+
+		if (tableVariant == "FiveCardDraw")
+			tables.push_back(unique_ptr<SimTable>(makeTable<FiveCardDrawRules>(numSeats, t / 3, seed, t)));
+		else if (tableVariant == "SevenCardStud")
+			tables.push_back(unique_ptr<SimTable>(makeTable<SevenCardStudRules>(numSeats, t / 3, seed, t)));
+		else
+			tables.push_back(unique_ptr<SimTable>(makeTable<TexasHoldEmRules>(numSeats, t / 3, seed, t)));
+	}
+
+	unsigned long long shardHands = 0;
+	vector<unsigned long long> handsLeft;
+	for (size_t t = firstTable; t < endTable; t++)
+	{
+		handsLeft.push_back(totalHands / numTables + (t < totalHands % numTables ? 1 : 0));
+		shardHands += handsLeft.back();
+	}
+
+	SimResults run;
+	run.setRun(variant, seed, totalHands, (unsigned)numTables, (unsigned)numSeats, numShards);
+	SimTotals resumed;
+	if (checkpointFile && !resume(checkpointFile, shard, run, resumed, tables, handsLeft, firstTable))
+		return 1;
+
+	if (scenarioFile)
+	{
+		try
+		{
+			for (size_t i = 0; i < tables.size(); i++)
+				tables[i]->useScenario(scenarioFile);
+		}
+		catch (fstream::failure & e)
+		{
+			cout << e.what() << endl;
+			return 1;
+		}
+		catch (invalid_argument & e)
+		{
+			cout << scenarioFile << ": " << e.what() << endl;
+			return 1;
+		}
+	}
+
+	unique_ptr<HistoryWriter> history;
+	if (historyFile)
+	{
+		try
+		{
+			history.reset(new HistoryWriter(historyFile));
+		}
+		catch (fstream::failure & e)
+		{
+			cout << e.what() << endl;
+			return 1;
+		}
+		for (size_t i = 0; i < tables.size(); i++)
+			tables[i]->recordHistory(history.get());
+	}
+
+	cout << "Playing " << shardHands << " hands on " << tables.size() << " tables with " 
+		<< pool.getNumThreads() << " thread(s)" << (pinThreads ? ", pinned" : "");
+	if (numShards > 1)
+		cout << " (shard " << shard << " of " << numShards << ": tables " << firstTable << " to " << endTable - 1 << ")";
+	cout << "..." << endl;
+
+	vector<SimTotals> totals(pool.getNumThreads());
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	chrono::steady_clock::time_point pauseAt = chrono::steady_clock::time_point::max();
+	SimTotals total = resumed;
+	while (true)
+	{
+		if (checkpointFile)
+			pauseAt = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(checkpointSeconds));
+
+		bool unfinished = false;
+		for (size_t i = 0; i < tables.size(); i++)
+		{
+			if (handsLeft[i] == 0)
+				continue;
+			TableJob job;
+			job.pool = &pool;
+			job.table = tables[i].get();
+			job.totals = &totals;
+			job.left = &handsLeft[i];
+			job.batch = batch;
+			job.pauseAt = &pauseAt;
+			pool.submit(job);
+			unfinished = true;
+		}
+		if (!unfinished)
+			break;
+
+		try
+		{
+			pool.wait();
+		}
+		catch (exception & e)
+		{
+			cout << "A table failed: " << e.what() << endl;
+			return 1;
+		}
+
+		total = resumed;
+		for (size_t w = 0; w < totals.size(); w++)
+			total.merge(totals[w]);
+		if (checkpointFile)
+			saveCheckpoint(checkpointFile, shard, run, total, tables, handsLeft, firstTable);
+	}
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	if (history)
+	{
+		try
+		{
+			history->flush();
+		}
+		catch (fstream::failure & e)
+		{
+			cout << e.what() << endl;
+			return 1;
+		}
+	}
+
+	SimResults results = run;
+	results.shardsDone[shard] = 1;
+	results.hands = total.hands;
+	results.showdowns = total.showdowns;
+	results.earlyWins = total.earlyWins;
+	for (size_t t = 0; t < tables.size(); t++)
+		results.addTable(tables[t]->state());
+
+	results.print(cout);
+	cout << "Stolen:     " << pool.getTasksStolen() << " batches" << endl;
+	cout << "Time:       " << seconds << " s (" << (unsigned long long)((total.hands - resumed.hands) / seconds) << " hands/s)" << endl;
+	PROFILE_REPORT(cout); // Nothing unless built with TEXTPOKER_PROFILE
+
+	if (outFile)
+	{
+		try
+		{
+			results.save(outFile);
+		}
+		catch (fstream::failure & e)
+		{
+			cout << e.what() << endl;
+			return 1;
+		}
+	}
+
+	return (total.hands == shardHands ? 0 : 1);
+}
@@ -0,0 +1,158 @@
+/*
+SimCheckpoint.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Defines how SimCheckpoints are written and read.
+*/
+
+#include "stdafx.h"
+#include "SimCheckpoint.h"
+
+#include <fstream>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+const char SimCheckpoint::MAGIC[4] = {'T', 'P', 'C', 'K'};
+
+namespace
+{
+	void putLittleEndian(vector<unsigned char> & out, unsigned long long value, size_t numBytes)
+	{
+		for (size_t i = 0; i < numBytes; i++)
+			out.push_back((unsigned char)(value >> (8 * i)));
+	}
+
+	unsigned long long getLittleEndian(const unsigned char * bytes, size_t numBytes)
+	{
+		unsigned long long value = 0;
+		for (size_t i = numBytes; i > 0; i--)
+			value = (value << 8) | bytes[i - 1];
+		return value;
+	}
+
+	// FNV-1a
+	unsigned long checksum(const unsigned char * bytes, size_t length)
+	{
+		unsigned long hash = 2166136261UL;
+		for (size_t i = 0; i < length; i++)
+			hash = ((hash ^ bytes[i]) * 16777619UL) & 0xFFFFFFFFUL;
+		return hash;
+	}
+}
+
+SimCheckpoint::SimCheckpoint() : shard(0) {}
+
+/*
+Replaces the checkpoint in the specified file with this one, atomically:
+the file is either left as it was or holds all of this checkpoint.
+
+Throws fstream::failure if the checkpoint cannot be written.
+*/
+void SimCheckpoint::save(const string & fileName) const
+{
+	vector<unsigned char> out(MAGIC, MAGIC + sizeof(MAGIC));
+	putLittleEndian(out, VERSION, 2);
+	putLittleEndian(out, shard, 4);
+	results.encode(out);
+	putLittleEndian(out, tables.size(), 4);
+	for (size_t t = 0; t < tables.size(); t++)
+	{
+		putLittleEndian(out, tables[t].tableNum, 4);
+		putLittleEndian(out, tables[t].handsLeft, 8);
+		putLittleEndian(out, tables[t].state.size(), 4);
+		out.insert(out.end(), tables[t].state.begin(), tables[t].state.end());
+	}
+	putLittleEndian(out, checksum(&out[0], out.size()), 4);
+
+	string tempFile = fileName + ".tmp";
+	FILE * file = fopen(tempFile.c_str(), "wb");
+	if (!file)
+		throw fstream::failure("Could not create " + tempFile);
+	bool written = fwrite(&out[0], 1, out.size(), file) == out.size() && fflush(file) == 0;
+#ifdef _WIN32
+	written = written && _commit(_fileno(file)) == 0;
+#else
+	written = written && fsync(fileno(file)) == 0;
+#endif
+	written = (fclose(file) == 0) && written;
+	if (!written)
+	{
+		remove(tempFile.c_str());
+		throw fstream::failure("Could not write " + tempFile);
+	}
+
+#ifdef _WIN32
+	remove(fileName.c_str()); // rename() will not replace a file on Windows
+#endif
+	if (rename(tempFile.c_str(), fileName.c_str()) != 0)
+		throw fstream::failure("Could not replace " + fileName);
+}
+
+/*
+Replaces this checkpoint with the one in the specified file.  Returns
+false, changing nothing, if there is no such file.
+
+Throws fstream::failure if the file is not a checkpoint or is damaged.
+*/
+bool SimCheckpoint::load(const string & fileName)
+{
+	ifstream file(fileName.c_str(), ios::in | ios::binary);
+	if (!file)
+		return false;
+	vector<unsigned char> data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+	const size_t HEADER_SIZE = sizeof(MAGIC) + 2 + 4;
+	if (data.size() < HEADER_SIZE + 4 || memcmp(&data[0], MAGIC, sizeof(MAGIC)) != 0)
+		throw fstream::failure(fileName + " is not a checkpoint");
+	if (getLittleEndian(&data[4], 2) != VERSION)
+		throw fstream::failure(fileName + " is from an unsupported version");
+	size_t end = data.size() - 4;
+	if (getLittleEndian(&data[end], 4) != checksum(&data[0], end))
+		throw fstream::failure(fileName + " is damaged");
+
+	SimCheckpoint loaded;
+	loaded.shard = (unsigned)getLittleEndian(&data[6], 4);
+	size_t pos = HEADER_SIZE;
+	try
+	{
+		pos += loaded.results.decode(&data[pos], end - pos);
+	}
+	catch (fstream::failure & e)
+	{
+		throw fstream::failure(fileName + ": " + e.what());
+	}
+
+	if (end - pos < 4)
+		throw fstream::failure(fileName + " is cut short");
+	size_t numTables = (size_t)getLittleEndian(&data[pos], 4);
+	pos += 4;
+	loaded.tables.resize(numTables);
+	for (size_t t = 0; t < numTables; t++)
+	{
+		if (end - pos < 16)
+			throw fstream::failure(fileName + " is cut short");
+		Table & table = loaded.tables[t];
+		table.tableNum = (unsigned)getLittleEndian(&data[pos], 4);
+		table.handsLeft = getLittleEndian(&data[pos + 4], 8);
+		size_t length = (size_t)getLittleEndian(&data[pos + 12], 4);
+		pos += 16;
+		if (end - pos < length)
+			throw fstream::failure(fileName + " is cut short");
+		table.state.assign(data.begin() + pos, data.begin() + pos + length);
+		pos += length;
+	}
+	if (pos != end)
+		throw fstream::failure(fileName + " has extra data");
+
+	*this = loaded;
+	return true;
+}
@@ -0,0 +1,49 @@
+/*
+SimCheckpoint.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Declares SimCheckpoint, everything a Sim run needs to carry on where it
+left off: the run and its totals so far (a SimResults), and every
+table's saved Simulation state and number of hands left.
+save() writes a temporary file, flushes it to disk, and renames it over
+the old checkpoint, so a crash at any moment leaves either the old
+checkpoint or the new one, never half of one.
+
+File: "TPCK", u16 format version, u32 shard number, the SimResults (see
+SimResults.h), u32 number of tables, then for each table: u32 table
+number, u64 hands left, u32 state length, then the state.  Last, a u32
+FNV-1a checksum of everything before it.  All numbers are little-endian.
+*/
+
+#ifndef SIM_CHECKPOINT_H
+#define SIM_CHECKPOINT_H
+
+#include "SimResults.h"
+
+#include <string>
+#include <vector>
+
+struct SimCheckpoint
+{
+	struct Table
+	{
+		unsigned tableNum;
+		unsigned long long handsLeft;
+		std::vector<unsigned char> state; // From Simulation::saveState()
+	};
+
+	SimCheckpoint();
+
+	void save(const std::string & fileName) const;
+	bool load(const std::string & fileName);
+
+	unsigned shard; // Which of results.shardsDone this run is
+	SimResults results; // The run, and its totals so far
+	std::vector<Table> tables;
+
+	static const char MAGIC[4];
+	static const unsigned VERSION = 1;
+};
+
+#endif
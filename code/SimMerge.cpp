@@ -0,0 +1,74 @@
+/*
+SimMerge.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Entry point for the simulation merge tool, built as its own executable.
+Adds together results files saved by Sim --out (see SimResults) and prints
+the combined report.  Files may be single shards or earlier merges, in any
+order, so a large run can be merged a few shards at a time.
+
+Usage: SimMerge [--out file] resultsFile...
+--out saves the combined results, to be merged again later.
+Exits with 1 if the files are from different runs, overlap, or cannot be
+read, and with 3 if the merge succeeded but some shards are still missing.
+*/
+
+#include "stdafx.h"
+#include "SimResults.h"
+
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+#include <string.h>
+
+using namespace std;
+
+int main(int argc, char * argv[])
+{
+	const char * outFile = 0;
+	bool usage = false;
+	int argNum = 1;
+	for (; argNum < argc && argv[argNum][0] == '-'; argNum++)
+	{
+		if (strcmp(argv[argNum], "--out") == 0 && argNum + 1 < argc)
+			outFile = argv[++argNum];
+		else
+			usage = true;
+	}
+	if (usage || argNum == argc)
+	{
+		cout << "Usage: " << argv[0] << " [--out file] resultsFile..." << endl;
+		return 2;
+	}
+
+	SimResults merged;
+	try
+	{
+		for (; argNum < argc; argNum++)
+		{
+			SimResults shard;
+			shard.load(argv[argNum]);
+			try
+			{
+				merged.merge(shard);
+			}
+			catch (invalid_argument & e)
+			{
+				cout << argv[argNum] << ": " << e.what() << endl;
+				return 1;
+			}
+		}
+
+		if (outFile)
+			merged.save(outFile);
+	}
+	catch (fstream::failure & e)
+	{
+		cout << e.what() << endl;
+		return 1;
+	}
+
+	merged.print(cout);
+	return (merged.isComplete() ? 0 : 3);
+}
@@ -0,0 +1,334 @@
+/*
+SimResults.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Defines SimResults: merging, its file format, and its report.
+*/
+
+#include "stdafx.h"
+#include "SimResults.h"
+
+#include <fstream>
+#include <ostream>
+#include <iomanip>
+#include <stdexcept>
+#include <string.h>
+
+using namespace std;
+
+const char SimResults::MAGIC[4] = {'T', 'P', 'S', 'R'};
+
+namespace
+{
+	void putU64(vector<unsigned char> & out, unsigned long long value)
+	{
+		for (int i = 0; i < 8; i++)
+			out.push_back((unsigned char)(value >> (8 * i)));
+	}
+
+	void putCounts(vector<unsigned char> & out, const unsigned long long counts[], size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			putU64(out, counts[i]);
+	}
+
+	/*
+	Reads from encoded results.  Throws fstream::failure if they are too short.
+	*/
+	class ResultsIn
+	{
+	public:
+		ResultsIn(const unsigned char * data, size_t length) : data(data), length(length), pos(0) {}
+
+		const unsigned char * take(size_t n)
+		{
+			if (length - pos < n)
+				throw fstream::failure("Results are cut short");
+			const unsigned char * start = data + pos;
+			pos += n;
+			return start;
+		}
+
+		unsigned long long getU64()
+		{
+			const unsigned char * bytes = take(8);
+			unsigned long long value = 0;
+			for (int i = 7; i >= 0; i--)
+				value = (value << 8) | bytes[i];
+			return value;
+		}
+
+		void getCounts(unsigned long long counts[], size_t n)
+		{
+			for (size_t i = 0; i < n; i++)
+				counts[i] = getU64();
+		}
+
+		size_t used() const { return pos; }
+
+	private:
+		const unsigned char * data;
+		size_t length;
+		size_t pos;
+	};
+}
+
+/*
+Empty results, for no run yet.  Merging anything into them copies it.
+*/
+SimResults::SimResults()
+	: seed(0), totalHands(0), numTables(0), numSeats(0), hands(0), showdowns(0), earlyWins(0)
+{
+	memset(showdownRanks, 0, sizeof(showdownRanks));
+	memset(wins, 0, sizeof(wins));
+	memset(ties, 0, sizeof(ties));
+	memset(losses, 0, sizeof(losses));
+	memset(rebuys, 0, sizeof(rebuys));
+	memset(chipsPaid, 0, sizeof(chipsPaid));
+	memset(chipsWon, 0, sizeof(chipsWon));
+}
+
+/*
+Describes the run these results are part of.  No shards are done yet.
+*/
+void SimResults::setRun(const string & variant, unsigned long long seed, unsigned long long totalHands,
+	unsigned numTables, unsigned numSeats, unsigned numShards)
+{
+	this->variant = variant;
+	this->seed = seed;
+	this->totalHands = totalHands;
+	this->numTables = numTables;
+	this->numSeats = numSeats;
+	shardsDone.assign(numShards, 0);
+}
+
+/*
+Adds a finished table's per-seat results and showdown hands.  The hand
+counts come from the tables' players, not from here.
+*/
+void SimResults::addTable(const TableState & table)
+{
+	for (size_t i = 0; i < table.numSeats; i++)
+	{
+		wins[i] += table.wins[i];
+		ties[i] += table.ties[i];
+		losses[i] += table.losses[i];
+		rebuys[i] += table.rebuys[i];
+		chipsPaid[i] += table.chipsPaid[i];
+		chipsWon[i] += table.chipsWon[i];
+	}
+	for (size_t r = 0; r < STR_RANKS_COUNT; r++)
+		showdownRanks[r] += table.showdownRanks[r];
+}
+
+/*
+Adds other's counts to these and marks its shards done.
+
+Throws invalid_argument if other is from a different run, or if both
+include the same shard, which would count its hands twice.
+*/
+void SimResults::merge(const SimResults & other)
+{
+	if (other.shardsDone.empty())
+		return;
+	if (shardsDone.empty())
+	{
+		*this = other;
+		return;
+	}
+
+	if (variant != other.variant || seed != other.seed || totalHands != other.totalHands ||
+		numTables != other.numTables || numSeats != other.numSeats || shardsDone.size() != other.shardsDone.size())
+		throw invalid_argument("Results are from different runs");
+	for (size_t i = 0; i < shardsDone.size(); i++)
+	{
+		if (shardsDone[i] && other.shardsDone[i])
+			throw invalid_argument("Shard " + to_string((unsigned long long)i) + " is in both results");
+	}
+
+	for (size_t i = 0; i < shardsDone.size(); i++)
+		shardsDone[i] |= other.shardsDone[i];
+	hands += other.hands;
+	showdowns += other.showdowns;
+	earlyWins += other.earlyWins;
+	for (size_t r = 0; r < STR_RANKS_COUNT; r++)
+		showdownRanks[r] += other.showdownRanks[r];
+	for (size_t i = 0; i < MAX_SEATS; i++)
+	{
+		wins[i] += other.wins[i];
+		ties[i] += other.ties[i];
+		losses[i] += other.losses[i];
+		rebuys[i] += other.rebuys[i];
+		chipsPaid[i] += other.chipsPaid[i];
+		chipsWon[i] += other.chipsWon[i];
+	}
+}
+
+/*
+Returns true if every shard of the run is included.
+*/
+bool SimResults::isComplete() const
+{
+	if (shardsDone.empty())
+		return false;
+	for (size_t i = 0; i < shardsDone.size(); i++)
+	{
+		if (!shardsDone[i])
+			return false;
+	}
+	return true;
+}
+
+/*
+Appends these results, in the file format, to out.
+*/
+void SimResults::encode(vector<unsigned char> & out) const
+{
+	out.insert(out.end(), MAGIC, MAGIC + sizeof(MAGIC));
+	out.push_back((unsigned char)variant.length());
+	out.insert(out.end(), variant.begin(), variant.end());
+	putU64(out, seed);
+	putU64(out, totalHands);
+	putU64(out, numTables);
+	putU64(out, numSeats);
+	putU64(out, shardsDone.size());
+	out.insert(out.end(), shardsDone.begin(), shardsDone.end());
+
+	putU64(out, hands);
+	putU64(out, showdowns);
+	putU64(out, earlyWins);
+	putCounts(out, showdownRanks, STR_RANKS_COUNT);
+	putCounts(out, wins, MAX_SEATS);
+	putCounts(out, ties, MAX_SEATS);
+	putCounts(out, losses, MAX_SEATS);
+	putCounts(out, rebuys, MAX_SEATS);
+	putCounts(out, chipsPaid, MAX_SEATS);
+	putCounts(out, chipsWon, MAX_SEATS);
+}
+
+/*
+Replaces these results with those encoded at the start of data.  Returns
+the number of bytes they took.
+
+Throws fstream::failure if data does not start with complete results.
+*/
+size_t SimResults::decode(const unsigned char * data, size_t length)
+{
+	ResultsIn in(data, length);
+	if (memcmp(in.take(sizeof(MAGIC)), MAGIC, sizeof(MAGIC)) != 0)
+		throw fstream::failure("Not simulation results");
+
+	SimResults decoded;
+	size_t nameLength = *in.take(1);
+	decoded.variant.assign((const char *)in.take(nameLength), nameLength);
+	decoded.seed = in.getU64();
+	decoded.totalHands = in.getU64();
+	decoded.numTables = (unsigned)in.getU64();
+	decoded.numSeats = (unsigned)in.getU64();
+	size_t numShards = (size_t)in.getU64();
+	const unsigned char * done = in.take(numShards);
+	decoded.shardsDone.assign(done, done + numShards);
+
+	decoded.hands = in.getU64();
+	decoded.showdowns = in.getU64();
+	decoded.earlyWins = in.getU64();
+	in.getCounts(decoded.showdownRanks, STR_RANKS_COUNT);
+	in.getCounts(decoded.wins, MAX_SEATS);
+	in.getCounts(decoded.ties, MAX_SEATS);
+	in.getCounts(decoded.losses, MAX_SEATS);
+	in.getCounts(decoded.rebuys, MAX_SEATS);
+	in.getCounts(decoded.chipsPaid, MAX_SEATS);
+	in.getCounts(decoded.chipsWon, MAX_SEATS);
+
+	*this = decoded;
+	return in.used();
+}
+
+/*
+Writes these results to a file, replacing it.
+
+Throws fstream::failure if the file cannot be written.
+*/
+void SimResults::save(const string & fileName) const
+{
+	vector<unsigned char> out;
+	encode(out);
+
+	ofstream file(fileName.c_str(), ios::out | ios::binary | ios::trunc);
+	if (!file)
+		throw fstream::failure("Could not create " + fileName);
+	file.write((const char *)&out[0], out.size());
+	file.close();
+	if (!file)
+		throw fstream::failure("Could not write to " + fileName);
+}
+
+/*
+Replaces these results with those saved in a file.
+
+Throws fstream::failure if the file cannot be read or is not a results file.
+*/
+void SimResults::load(const string & fileName)
+{
+	ifstream file(fileName.c_str(), ios::in | ios::binary);
+	if (!file)
+		throw fstream::failure("Could not open " + fileName);
+	vector<unsigned char> data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+	try
+	{
+		if (data.empty() || decode(&data[0], data.size()) != data.size())
+			throw fstream::failure("Not a results file");
+	}
+	catch (fstream::failure & e)
+	{
+		throw fstream::failure(fileName + ": " + e.what());
+	}
+}
+
+/*
+Prints the totals, the hands shown down by rank, and a line for each seat
+that played.  Chips are net of what the seat paid in.
+*/
+void SimResults::print(ostream & out) const
+{
+	size_t numDone = 0;
+	for (size_t i = 0; i < shardsDone.size(); i++)
+		numDone += shardsDone[i];
+
+	unsigned long long totalRebuys = 0;
+	for (size_t i = 0; i < MAX_SEATS; i++)
+		totalRebuys += rebuys[i];
+
+	out << "Run:        " << variant << ", " << numTables << " tables, "
+		<< (numSeats ? to_string((unsigned long long)numSeats) : string("varied")) << " seats, seed " << seed << '\n';
+	out << "Shards:     " << numDone << " of " << shardsDone.size() << (isComplete() ? "" : " (incomplete)") << '\n';
+	out << "Hands:      " << hands << " of " << totalHands << '\n';
+	out << "Showdowns:  " << showdowns << '\n';
+	out << "Early wins: " << earlyWins << '\n';
+	out << "Rebuys:     " << totalRebuys << '\n';
+
+	unsigned long long shown = 0;
+	for (size_t r = 0; r < STR_RANKS_COUNT; r++)
+		shown += showdownRanks[r];
+	const char * const rankNames[] = STR_RANKS;
+	out << "Hands shown down:\n";
+	for (size_t r = 0; r < STR_RANKS_COUNT; r++)
+	{
+		out << "  " << left << setw(16) << rankNames[r] << right << setw(12) << showdownRanks[r];
+		if (shown)
+			out << "  " << fixed << setprecision(3) << setw(7) << (100.0 * showdownRanks[r] / shown) << '%';
+		out << '\n';
+	}
+
+	out << "Seat        Wins        Ties      Losses     Paid in    Won back         Net\n";
+	for (size_t i = 0; i < MAX_SEATS; i++)
+	{
+		if (wins[i] + losses[i] == 0)
+			continue;
+		out << setw(4) << i << setw(12) << wins[i] << setw(12) << ties[i] << setw(12) << losses[i]
+			<< setw(12) << chipsPaid[i] << setw(12) << chipsWon[i]
+			<< setw(12) << ((long long)chipsWon[i] - (long long)chipsPaid[i]) << '\n';
+	}
+}
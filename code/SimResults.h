@@ -0,0 +1,72 @@
+/*
+SimResults.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Declares SimResults, the totals of a simulation run or of any set of its
+shards.  A run of Sim can be split into shards, each playing its own
+range of tables in its own process (or on its own host), and each shard
+saves a SimResults file.  merge() only adds counts together, so shard
+files can be combined in any order and in any grouping, and the result
+is the same as one process playing every table.
+
+File: a 4-byte magic number ("TPSR"), then all fields in the order they are
+declared below, little-endian.  Strings are a u8 length followed by the
+characters; the shards done are a u32 count followed by one byte per shard.
+Counts are u64.
+*/
+
+#ifndef SIM_RESULTS_H
+#define SIM_RESULTS_H
+
+#include "Hand.h"
+#include "TableState.h"
+
+#include <string>
+#include <vector>
+#include <iosfwd>
+
+struct SimResults
+{
+	SimResults();
+
+	void setRun(const std::string & variant, unsigned long long seed, unsigned long long totalHands,
+		unsigned numTables, unsigned numSeats, unsigned numShards);
+	void addTable(const TableState & table);
+	void merge(const SimResults & other);
+	bool isComplete() const;
+
+	void encode(std::vector<unsigned char> & out) const;
+	size_t decode(const unsigned char * data, size_t length);
+	void save(const std::string & fileName) const;
+	void load(const std::string & fileName);
+	void print(std::ostream & out) const;
+
+	static const size_t MAX_SEATS = TableState::MAX_SEATS;
+
+	// What was simulated: every shard of one run has the same values
+	std::string variant;
+	unsigned long long seed;
+	unsigned long long totalHands;
+	unsigned numTables;
+	unsigned numSeats; // 0 if it varies by table
+	std::vector<unsigned char> shardsDone; // One per shard, 1 if its results are included
+
+	// Totals
+	unsigned long long hands;
+	unsigned long long showdowns;
+	unsigned long long earlyWins;
+	unsigned long long showdownRanks[STR_RANKS_COUNT]; // By pokerRank
+
+	// By seat number, over all tables
+	unsigned long long wins[MAX_SEATS];
+	unsigned long long ties[MAX_SEATS];
+	unsigned long long losses[MAX_SEATS];
+	unsigned long long rebuys[MAX_SEATS];
+	unsigned long long chipsPaid[MAX_SEATS];
+	unsigned long long chipsWon[MAX_SEATS];
+
+	static const char MAGIC[4];
+};
+
+#endif
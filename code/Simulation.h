@@ -0,0 +1,598 @@
+/*
+Simulation.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Declares and defines the Simulation class template, a headless table that
+plays rounds of one variant with no prompts and no output.  The variant is
+a Rules policy (see Rules.h) and the players' decisions come from a
+Strategy (see Strategy.h); both are template parameters, so the round loop
+has no virtual calls.  All table state lives in one TableState.  Betting,
+ante, and pot division follow the same rules as Game.
+*/
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "Game.h"
+#include "GameException.h"
+#include "TableState.h"
+#include "TableAction.h"
+#include "Hand.h"
+#include "RoundArena.h"
+#include "Scenario.h"
+#include "HandHistory.h"
+#include "Profiler.h"
+#include "ndebug.h"
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <string.h>
+#include <assert.h>
+
+template <class Rules, class Strategy>
+class Simulation
+{
+public:
+	Simulation(size_t numSeats, const Strategy & strategy = Strategy());
+
+	int playRound();
+	void useScenario(ScenarioReader * reader);
+	void recordHistory(HistoryWriter * writer, unsigned tableId = 0);
+	void seedShuffles(uint64_t seed, unsigned stream);
+
+	// Information
+	size_t getNumSeats() const;
+	SeatView seat(size_t n) const;
+	const TableState & state() const;
+	unsigned long getRoundsPlayed() const;
+
+	// Checkpoints
+	void saveState(std::vector<unsigned char> & out) const;
+	void restoreState(const unsigned char * data, size_t length);
+	static const size_t STATE_SIZE = 8 + sizeof(Strategy) + sizeof(TableState);
+
+	// Used by Rules to deal each street
+	template <class SeatFxn>
+	void goAround(SeatFxn doWhat);
+	void dealTo(size_t seatNum);
+	void dealCommunity();
+	void drawCards(size_t seatNum);
+
+	static const size_t MAX_SEATS = (Rules::MAX_PLAYERS < TableState::MAX_SEATS ? Rules::MAX_PLAYERS : TableState::MAX_SEATS);
+	static const int EARLY_WINNER = 2;
+
+private:
+	void allJoinRound();
+	void collectAnte();
+	void collectBets(size_t street);
+	SeatChips chooseBet(size_t seatNum, SeatChips chipsLeft);
+
+	void earlyWin();
+	void showdown();
+	void dividePot(const size_t winners[], size_t numWinners);
+	void cleanup();
+	void takeScenarioDeal();
+	void beginHistory();
+	void finishHistory();
+
+	TableState table;
+	unsigned long roundsPlayed;
+	Strategy strategy;
+	RoundArena arena; // Showdown temporaries; reset by cleanup()
+	ScenarioReader * scenario; // Not owned; 0 to shuffle
+	HistoryWriter * history; // Not owned; 0 to not record
+	HandRecord record; // The round in progress, if history is on
+	uint64_t seed; // Round n is shuffled by CounterRng stream (seed, stream), position n
+	unsigned stream;
+};
+
+/*
+Creates a table with numSeats players, each with the default number of chips,
+and a standard deck.
+
+Throws invalid_argument if numSeats is less than 2 or more than MAX_SEATS.
+*/
+template <class Rules, class Strategy>
+Simulation<Rules, Strategy>::Simulation(size_t numSeats, const Strategy & strategy)
+	: roundsPlayed(0), strategy(strategy), scenario(0), history(0), seed(0), stream(0)
+{
+	if (numSeats < 2 || numSeats > MAX_SEATS)
+		throw std::invalid_argument("Unsupported number of seats for this variant");
+
+	table.reset(numSeats, Player::DEFAULT_CHIPS);
+}
+
+/*
+Deals every following round from reader instead of shuffling, or goes
+back to shuffling if reader is 0.  The Simulation does not take ownership.
+
+Throws invalid_argument if the scenario is for another variant.
+*/
+template <class Rules, class Strategy>
+void Simulation<Rules, Strategy>::useScenario(ScenarioReader * reader)
+{
+	if (reader && reader->getVariant() != SCENARIO_ANY && reader->getVariant() != Rules::SCENARIO)
+		throw std::invalid_argument("Scenario is for a different variant");
+
+	scenario = reader;
+}
+
+/*
+Appends every following round to writer, or stops recording if writer is 
+0.  Seats are named "Seat 0", "Seat 1", and so on.  The Simulation does not 
+take ownership; several tables may share one writer.
+*/
+template <class Rules, class Strategy>
+void Simulation<Rules, Strategy>::recordHistory(HistoryWriter * writer, unsigned tableId)
+{
+	history = writer;
+	record.variant = (unsigned char)Rules::SCENARIO;
+	record.tableId = tableId;
+	record.seats.resize(table.numSeats);
+	for (size_t i = 0; i < table.numSeats; i++)
+		record.seats[i].name = "Seat " + std::to_string((unsigned long long)i);
+}
+
+/*
+Makes every following round's shuffle depend only on seed, stream, and 
+the round's number.  Tables that are given different streams never deal 
+the same sequence, and TableState::dealFor() can deal any round again 
+without replaying the ones before it.  The default is seed 0, stream 0.
+*/
+template <class Rules, class Strategy>
+void Simulation<Rules, Strategy>::seedShuffles(uint64_t seed, unsigned stream)
+{
+	this->seed = seed;
+	this->stream = stream;
+}
+
+/*
+Plays one complete round: shuffle (or take the next scenario deal), ante, 
+then deal and bet each street, then showdown.  Seats that end the round with 0 chips buy back in for the
+default amount.  Advances the dealer position.
+
+Returns 0 if the round went to showdown.
+Returns EARLY_WINNER if everybody but one player folded.
+Throws GameException if the scenario has run out of deals or is corrupt.
+*/
+template <class Rules, class Strategy>
+int Simulation<Rules, Strategy>::playRound()
+{
+	if (scenario)
+		takeScenarioDeal();
+	else
+		table.dealFor(seed, stream, roundsPlayed);
+	allJoinRound();
+	if (history)
+		beginHistory();
+	collectAnte();
+
+	int result = 0;
+	for (size_t street = 0; street < Rules::STREETS; street++)
+	{
+		PROFILE_PHASE_INDEXED("sim street", street);
+		Rules::deal(*this, street);
+		collectBets(street);
+		if (table.playersInRound == 1)
+		{
+			result = EARLY_WINNER;
+			break;
+		}
+	}
+
+	if (result == EARLY_WINNER)
+		earlyWin();
+	else
+		showdown();
+
+	if (history)
+		finishHistory();
+	cleanup();
+	roundsPlayed++;
+	return result;
+}
+
+template <class Rules, class Strategy>
+size_t Simulation<Rules, Strategy>::getNumSeats() const
+{
+	return table.numSeats;
+}
+
+template <class Rules, class Strategy>
+SeatView Simulation<Rules, Strategy>::seat(size_t n) const
+{
+	assert(n < table.numSeats);
+	return SeatView(table, n);
+}
+
+template <class Rules, class Strategy>
+const TableState & Simulation<Rules, Strategy>::state() const
+{
+	return table;
+}
+
+template <class Rules, class Strategy>
+unsigned long Simulation<Rules, Strategy>::getRoundsPlayed() const
+{
+	return roundsPlayed;
+}
+
+/*
+Appends everything that changes as rounds are played to out: the number
+of rounds, the Strategy, and the TableState, which includes the shuffle
+generator, the dealer position, the pot, and every seat's chips and
+results.  Always STATE_SIZE bytes.  The table and the Strategy are copied
+as they are in memory, so the state can only be restored by the same build
+on the same kind of machine.
+*/
+template <class Rules, class Strategy>
+void Simulation<Rules, Strategy>::saveState(std::vector<unsigned char> & out) const
+{
+	static_assert(std::is_trivially_copyable<Strategy>::value, "Strategy must be trivially copyable to be saved");
+	static_assert(std::is_trivially_copyable<TableState>::value, "TableState must be trivially copyable to be saved");
+
+	for (int i = 0; i < 8; i++)
+		out.push_back((unsigned char)((unsigned long long)roundsPlayed >> (8 * i)));
+	const unsigned char * strategyBytes = reinterpret_cast<const unsigned char *>(&strategy);
+	out.insert(out.end(), strategyBytes, strategyBytes + sizeof(Strategy));
+	const unsigned char * tableBytes = reinterpret_cast<const unsigned char *>(&table);
+	out.insert(out.end(), tableBytes, tableBytes + sizeof(TableState));
+}
+
+/*
+Puts the Simulation back the way saveState() found it.  Its shuffle seed
+and stream are not part of the state; they must be set up the same way
+as they were when the state was saved.
+
+Throws invalid_argument if the state is the wrong size or for a table
+with another number of seats.
+*/
+template <class Rules, class Strategy>
+void Simulation<Rules, Strategy>::restoreState(const unsigned char * data, size_t length)
+{
+	if (length != STATE_SIZE)
+		throw std::invalid_argument("Saved table state is the wrong size");
+
+	TableState restored;
+	memcpy(&restored, data + 8 + sizeof(Strategy), sizeof(TableState));
+	if (restored.numSeats != table.numSeats)
+		throw std::invalid_argument("Saved table state has a different number of seats");
+
+	unsigned long long rounds = 0;
+	for (int i = 7; i >= 0; i--)
+		rounds = (rounds << 8) | data[i];
+	roundsPlayed = (unsigned long)rounds;
+	memcpy(&strategy, data + 8, sizeof(Strategy));
+	table = restored;
+}
+
+/*
+Starting with the seat after the dealer position, calls doWhat with the
+number of every seat that is still in the round.
+*/
+template <class Rules, class Strategy>
+template <class SeatFxn>
+void Simulation<Rules, Strategy>::goAround(SeatFxn doWhat)
+{
+	size_t seatNum = table.dealerPos;
+	do
+	{
+		seatNum = table.nextSeat(seatNum);
+		if (table.inRound(seatNum))
+			doWhat(seatNum);
+	} while (seatNum != table.dealerPos);
+}
+
+/*
+Deals the next card to a seat.  Throws GameException if there are no cards left.
+*/
+template <class Rules, class Strategy>
+void Simulation<Rules, Strategy>::dealTo(size_t seatNum)
+{
+	table.dealTo(seatNum);
+}
+
+/*
+Deals the next card to the community cards.  Throws GameException if the deck has run out.
+*/
+template <class Rules, class Strategy>
+void Simulation<Rules, Strategy>::dealCommunity()
+{
+	table.dealCommunity();
+}
+
+/*
+Asks the Strategy which cards a seat discards, moves them to the discards,
+and deals the seat back up to a full hand.  Bit i of the Strategy's answer
+is the card at position i of the sorted hand.
+*/
+template <class Rules, class Strategy>
+void Simulation<Rules, Strategy>::drawCards(size_t seatNum)
+{
+	unsigned toDiscard = strategy.discards(*this, seatNum);
+	CardMask hand = table.holeCards[seatNum];
+
+	int pos = 0;
+	int numDiscarded = 0;
+	for (int index = 0; hand != 0; index++, hand >>= 1)
+	{
+		if (hand & 1)
+		{
+			if (toDiscard & (1u << pos))
+			{
+				table.discard(seatNum, index);
+				numDiscarded++;
+			}
+			pos++;
+		}
+	}
+
+	for (int i = 0; i < numDiscarded; i++)
+		table.dealTo(seatNum);
+}
+
+template <class Rules, class Strategy>
+void Simulation<Rules, Strategy>::allJoinRound()
+{
+	table.playersInRound = table.numSeats;
+	for (size_t i = 0; i < table.numSeats; i++)
+		table.flags[i] = TableState::IN_ROUND;
+	table.streetBet = 0;
+	table.lastToAct = table.dealerPos;
+}
+
+/*
+Deducts one chip from each seat, adding them to the pot.
+*/
+template <class Rules, class Strategy>
+void Simulation<Rules, Strategy>::collectAnte()
+{
+	for (size_t i = 0; i < table.numSeats; i++)
+	{
+		TableAction::ante(i).apply(table);
+		if (history)
+			record.addAction(0, i, ACTION_ANTE, 1, table.pot);
+	}
+}
+
+/*
+Performs a round of betting, exactly like Game::collectBets(), but asks the
+Strategy instead of prompting.  Every decision is applied as a TableAction,
+the same ones a search would try.
+*/
+template <class Rules, class Strategy>
+void Simulation<Rules, Strategy>::collectBets(size_t street)
+{
+	for (int seatNum = table.firstToAct(); seatNum >= 0; seatNum = table.nextToAct(seatNum))
+	{
+		SeatChips chipsBefore = table.chips[seatNum];
+		TableAction action = TableAction::check(seatNum);
+		HandAction recorded = ACTION_CHECK;
+		if (table.streetBet > 0)
+		{
+			SeatChips callAmt = table.streetBet - table.amtPaid[seatNum];
+			char choice = strategy.callRaiseFold(*this, seatNum, callAmt);
+			if (choice == RAISE && table.chips[seatNum] <= callAmt) // Not enough to raise: the prompt only offers all in
+				choice = CALL;
+
+			switch (choice)
+			{
+			case CALL:
+				action = TableAction::call(seatNum);
+				recorded = ACTION_CALL;
+				break;
+
+			case RAISE:
+				action = TableAction::raise(seatNum, chooseBet(seatNum, table.chips[seatNum] - callAmt));
+				recorded = ACTION_RAISE;
+				break;
+
+			case FOLD:
+				action = TableAction::fold(seatNum);
+				recorded = ACTION_FOLD;
+				break;
+			}
+		}
+		else if (strategy.checkOrBet(*this, seatNum) == BET)
+		{
+			action = TableAction::bet(seatNum, chooseBet(seatNum, table.chips[seatNum]));
+			recorded = ACTION_BET;
+		}
+		action.apply(table);
+
+		if (history)
+			record.addAction(street, seatNum, recorded, chipsBefore - table.chips[seatNum], table.pot);
+	}
+
+	TableAction::endStreet().apply(table);
+}
+
+/*
+Asks the Strategy how much to bet, as Game::handleBet() asks the player:
+at least MIN_BET and no more than MAX_BET or the chips the seat has left 
+to bet with.
+*/
+template <class Rules, class Strategy>
+SeatChips Simulation<Rules, Strategy>::chooseBet(size_t seatNum, SeatChips chipsLeft)
+{
+	assert(chipsLeft > 0);
+
+	ChipAmt max = (chipsLeft < Game::MAX_BET ? chipsLeft : Game::MAX_BET);
+	SeatChips bet = (SeatChips)strategy.betAmount(*this, seatNum, max);
+	assert(bet >= Game::MIN_BET && bet <= max);
+	return bet;
+}
+
+/*
+Gives the pot to the only seat that has not folded.  Everybody else loses.
+*/
+template <class Rules, class Strategy>
+void Simulation<Rules, Strategy>::earlyWin()
+{
+	assert(table.playersInRound == 1);
+	for (size_t i = 0; i < table.numSeats; i++)
+	{
+		if (table.inRound(i))
+		{
+			table.wins[i]++;
+			table.chips[i] += (SeatChips)table.pot;
+			table.chipsWon[i] += table.pot;
+			if (history)
+				record.addWinner(i, table.pot);
+		}
+		else
+			table.losses[i]++;
+	}
+	table.pot = 0;
+}
+
+/*
+Ranks every seat still in the round with Rules::showdownHand() and splits
+the pot among those tied for the best hand.  Every Hand built here comes
+from the arena.
+*/
+template <class Rules, class Strategy>
+void Simulation<Rules, Strategy>::showdown()
+{
+	PROFILE_PHASE("sim showdown");
+	RoundArena::Scope scope(arena);
+	Hand best[MAX_SEATS];
+	size_t contenders[MAX_SEATS];
+	size_t numContenders = 0;
+
+	for (size_t i = 0; i < table.numSeats; i++)
+	{
+		if (table.inRound(i))
+		{
+			Rules::showdownHand(table, i, best[i]);
+			table.showdownRanks[best[i].getRank()]++;
+			contenders[numContenders++] = i;
+		}
+		else
+			table.losses[i]++;
+	}
+
+	std::sort(contenders, contenders + numContenders,
+		[&best](size_t one, size_t two) { return Hand::poker_rank(best[one], best[two]); });
+
+	size_t numWinners = 1;
+	while (numWinners < numContenders && best[contenders[0]].sameRankAs(best[contenders[numWinners]]))
+		numWinners++;
+
+	for (size_t i = 0; i < numWinners; i++)
+	{
+		table.wins[contenders[i]]++;
+		if (numWinners > 1)
+			table.ties[contenders[i]]++;
+	}
+	for (size_t i = numWinners; i < numContenders; i++)
+		table.losses[contenders[i]]++;
+
+	dividePot(contenders, numWinners);
+}
+
+/*
+Same as Game::dividePot(): the first seats in the list get the remainder.
+*/
+template <class Rules, class Strategy>
+void Simulation<Rules, Strategy>::dividePot(const size_t winners[], size_t numWinners)
+{
+	SeatChips share1 = (SeatChips)(table.pot / numWinners);
+	SeatChips share2 = (SeatChips)(table.pot % numWinners);
+
+	for (size_t i = 0; i < numWinners; i++)
+	{
+		SeatChips share = share1 + (i < share2 ? 1 : 0);
+		table.chips[winners[i]] += share;
+		table.chipsWon[winners[i]] += share;
+		if (history)
+			record.addWinner(winners[i], share);
+	}
+
+	table.pot = 0;
+}
+
+/*
+Takes back every card, releases the round's temporaries, rebuys seats that
+have 0 chips, and increments the dealer position.
+*/
+template <class Rules, class Strategy>
+void Simulation<Rules, Strategy>::cleanup()
+{
+	arena.reset();
+
+	for (size_t i = 0; i < table.numSeats; i++)
+	{
+		table.holeCards[i] = 0;
+		if (table.chips[i] == 0)
+		{
+			table.chips[i] = Player::DEFAULT_CHIPS;
+			table.rebuys[i]++;
+		}
+	}
+
+	table.community = 0;
+	table.discards = 0;
+	table.standardDeck();
+
+	table.dealerPos = (unsigned char)table.nextSeat(table.dealerPos);
+}
+
+/*
+Stacks the deck with the scenario's next deal.  Cards the deal does not 
+list follow it in standard order.
+
+Throws GameException if the scenario has run out of deals or is corrupt.
+*/
+template <class Rules, class Strategy>
+void Simulation<Rules, Strategy>::takeScenarioDeal()
+{
+	unsigned char indices[Scenario::MAX_DEAL_CARDS];
+	size_t numCards;
+	try
+	{
+		if (!scenario->nextDeal(indices, numCards))
+			throw GameException("The scenario has no more deals");
+	}
+	catch (std::fstream::failure & e)
+	{
+		throw GameException(e.what());
+	}
+
+	table.loadDeck(indices, numCards);
+}
+
+/*
+Starts the round's history record with every seat's chips after the deal.
+*/
+template <class Rules, class Strategy>
+void Simulation<Rules, Strategy>::beginHistory()
+{
+	record.begin(table.numSeats);
+	record.dealerPos = table.dealerPos;
+	record.handNumber = roundsPlayed;
+	for (size_t i = 0; i < table.numSeats; i++)
+		record.seats[i].startChips = table.chips[i];
+}
+
+/*
+Fills in the end of the round's record and hands it to the writer.  Call
+before cleanup() takes the cards back.
+*/
+template <class Rules, class Strategy>
+void Simulation<Rules, Strategy>::finishHistory()
+{
+	for (size_t i = 0; i < table.numSeats; i++)
+	{
+		record.seats[i].finalChips = table.chips[i];
+		record.seats[i].cards = table.holeCards[i];
+	}
+	record.board = table.community;
+	history->submit(record);
+}
+
+#endif
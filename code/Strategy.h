@@ -0,0 +1,99 @@
+/*
+Strategy.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Decision policies for the headless Simulation.  A Strategy answers the
+same questions the console prompts ask a human: check or bet, call, raise
+or fold, how much to bet, and which cards to discard.  Strategies are
+template parameters, not base classes, so every decision inlines into
+the betting loop.
+*/
+
+#ifndef STRATEGY_H
+#define STRATEGY_H
+
+#include "Game.h"
+
+/*
+Checks and calls everything.  Never bets, raises, folds or discards.
+*/
+struct PassiveStrategy
+{
+	template <class Sim>
+	char checkOrBet(const Sim & /* sim */, size_t /* seatNum */) { return CHECK; }
+
+	template <class Sim>
+	char callRaiseFold(const Sim & /* sim */, size_t /* seatNum */, ChipAmt /* callAmt */) { return CALL; }
+
+	template <class Sim>
+	ChipAmt betAmount(const Sim & /* sim */, size_t /* seatNum */, ChipAmt /* max */) { return Game::MIN_BET; }
+
+	template <class Sim>
+	unsigned discards(const Sim & /* sim */, size_t /* seatNum */) { return 0; }
+};
+
+/*
+Makes every decision at random with fixed odds, using its own xorshift
+generator so that a given seed always plays the same way.
+*/
+class RandomStrategy
+{
+public:
+	RandomStrategy(unsigned long long seed = 1) : state(seed ? seed : 1) {}
+
+	/*
+	Bets a quarter of the time.
+	*/
+	template <class Sim>
+	char checkOrBet(const Sim & /* sim */, size_t /* seatNum */)
+	{
+		return (next() % 4 == 0) ? BET : CHECK;
+	}
+
+	/*
+	Folds one time in ten and raises about one time in seven.
+	*/
+	template <class Sim>
+	char callRaiseFold(const Sim & /* sim */, size_t /* seatNum */, ChipAmt /* callAmt */)
+	{
+		unsigned long long roll = next() % 100;
+		if (roll < 10)
+			return FOLD;
+		if (roll < 25)
+			return RAISE;
+		return CALL;
+	}
+
+	/*
+	Returns an amount between MIN_BET and max, inclusive.
+	*/
+	template <class Sim>
+	ChipAmt betAmount(const Sim & /* sim */, size_t /* seatNum */, ChipAmt max)
+	{
+		return Game::MIN_BET + (ChipAmt)(next() % (max - Game::MIN_BET + 1));
+	}
+
+	/*
+	Discards each of the first three cards with even odds.  Bit i of the
+	return value means "discard the card at position i".
+	*/
+	template <class Sim>
+	unsigned discards(const Sim & /* sim */, size_t /* seatNum */)
+	{
+		return (unsigned)(next() & 0x7);
+	}
+
+private:
+	unsigned long long next()
+	{
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		return state;
+	}
+
+	unsigned long long state;
+};
+
+#endif
@@ -0,0 +1,264 @@
+/*
+TableAction.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Defines TableAction's constructors, apply() and undo().
+*/
+
+#include "stdafx.h"
+#include "TableAction.h"
+#include "GameException.h"
+#include "ndebug.h"
+
+#include <string.h>
+#include <assert.h>
+
+namespace
+{
+	TableAction make(TableAction::Type type, size_t seatNum)
+	{
+		TableAction action;
+		memset(&action, 0, sizeof(action));
+		action.type = (unsigned char)type;
+		action.seat = (unsigned char)seatNum;
+		return action;
+	}
+
+	/*
+	Moves up to toPay chips from a seat to the pot, as Game::handleCall()
+	does.  A seat without enough chips goes all in, and its amtPaid stays
+	as it was.
+	*/
+	void payToPot(TableState & table, size_t seatNum, SeatChips toPay, SeatChips & paid)
+	{
+		if (table.chips[seatNum] < toPay)
+			paid = table.chips[seatNum];
+		else
+		{
+			paid = toPay;
+			table.amtPaid[seatNum] += toPay;
+		}
+
+		table.chips[seatNum] -= paid;
+		table.pot += paid;
+		table.chipsPaid[seatNum] += paid;
+		if (table.chips[seatNum] == 0)
+			table.flags[seatNum] |= TableState::ALL_IN;
+	}
+
+	size_t seatBefore(const TableState & table, size_t seatNum)
+	{
+		return (seatNum == 0 ? table.numSeats - 1 : seatNum - 1);
+	}
+}
+
+TableAction TableAction::ante(size_t seatNum)
+{
+	return make(ANTE, seatNum);
+}
+
+TableAction TableAction::dealTo(size_t seatNum)
+{
+	return make(DEAL_TO, seatNum);
+}
+
+TableAction TableAction::dealCommunity()
+{
+	return make(DEAL_COMMUNITY, 0);
+}
+
+/*
+Moves the card with the specified index (see Card::toIndex()) from the
+seat's hole cards to the discards.
+*/
+TableAction TableAction::discard(size_t seatNum, int index)
+{
+	TableAction action = make(DISCARD, seatNum);
+	action.card = (unsigned char)index;
+	return action;
+}
+
+TableAction TableAction::check(size_t seatNum)
+{
+	return make(CHECK, seatNum);
+}
+
+TableAction TableAction::bet(size_t seatNum, SeatChips amount)
+{
+	TableAction action = make(BET, seatNum);
+	action.amount = amount;
+	return action;
+}
+
+TableAction TableAction::call(size_t seatNum)
+{
+	return make(CALL, seatNum);
+}
+
+/*
+Calls, then bets amount more.
+*/
+TableAction TableAction::raise(size_t seatNum, SeatChips amount)
+{
+	TableAction action = make(RAISE, seatNum);
+	action.amount = amount;
+	return action;
+}
+
+TableAction TableAction::fold(size_t seatNum)
+{
+	return make(FOLD, seatNum);
+}
+
+TableAction TableAction::endStreet()
+{
+	return make(END_STREET, 0);
+}
+
+/*
+Puts every betting action the seat may take into out, which needs room for
+maxBet - minBet + 3 actions, and returns how many there are.  Before
+anybody bets, a seat may check or bet; after, it may call, fold, or raise
+if it has chips left once it calls.  Bets are limited to the seat's chips.
+*/
+size_t TableAction::choices(const TableState & table, size_t seatNum, SeatChips minBet, SeatChips maxBet, TableAction out[])
+{
+	assert(table.canAct(seatNum));
+	size_t numChoices = 0;
+	SeatChips chips = table.chips[seatNum];
+	if (table.streetBet == 0)
+	{
+		out[numChoices++] = check(seatNum);
+		for (SeatChips amount = minBet; amount <= maxBet && amount <= chips; amount++)
+			out[numChoices++] = bet(seatNum, amount);
+		return numChoices;
+	}
+
+	SeatChips callAmt = table.streetBet - table.amtPaid[seatNum];
+	out[numChoices++] = call(seatNum);
+	out[numChoices++] = fold(seatNum);
+	for (SeatChips amount = minBet; amount <= maxBet && callAmt + amount <= chips; amount++)
+		out[numChoices++] = raise(seatNum, amount);
+	return numChoices;
+}
+
+/*
+Makes this action's change to the table, and remembers what it was.
+
+Throws GameException if a card is dealt from an empty deck; unlike
+TableState::dealTo(), actions never reshuffle the discards.
+*/
+void TableAction::apply(TableState & table)
+{
+	flagsBefore = table.flags[seat];
+	lastToActBefore = table.lastToAct;
+	amtPaidBefore = table.amtPaid[seat];
+	streetBetBefore = table.streetBet;
+
+	switch (type)
+	{
+	case ANTE:
+		assert(table.chips[seat] > 0);
+		payToPot(table, seat, 1, paid);
+		table.amtPaid[seat] = amtPaidBefore; // The ante does not count toward a bet
+		break;
+
+	case DEAL_TO:
+	case DEAL_COMMUNITY:
+		if (table.deckPos == Card::NUM_CARDS)
+			throw GameException("Ran out of cards in the deck");
+		card = table.deck[table.deckPos++];
+		if (type == DEAL_TO)
+			table.holeCards[seat] |= (CardMask)1 << card;
+		else
+			table.community |= (CardMask)1 << card;
+		break;
+
+	case DISCARD:
+		assert(table.holeCards[seat] & ((CardMask)1 << card));
+		table.holeCards[seat] &= ~((CardMask)1 << card);
+		table.discards |= (CardMask)1 << card;
+		break;
+
+	case CHECK:
+		break;
+
+	case BET:
+		assert(table.canAct(seat) && amount > 0 && amount <= table.chips[seat]);
+		payToPot(table, seat, amount, paid);
+		table.streetBet = amount;
+		table.lastToAct = (unsigned char)seatBefore(table, seat);
+		break;
+
+	case CALL:
+		payToPot(table, seat, table.streetBet - table.amtPaid[seat], paid);
+		break;
+
+	case RAISE:
+		assert(table.chips[seat] > table.streetBet - table.amtPaid[seat]);
+		payToPot(table, seat, table.streetBet - table.amtPaid[seat] + amount, paid);
+		table.streetBet += amount;
+		table.lastToAct = (unsigned char)seatBefore(table, seat);
+		break;
+
+	case FOLD:
+		table.fold(seat);
+		break;
+
+	case END_STREET:
+		memcpy(streetPaid, table.amtPaid, sizeof(streetPaid));
+		memset(table.amtPaid, 0, sizeof(table.amtPaid));
+		table.streetBet = 0;
+		table.lastToAct = table.dealerPos;
+		break;
+	}
+}
+
+/*
+Takes back the change apply() made.  Every action applied after this one
+must have been undone already.
+*/
+void TableAction::undo(TableState & table) const
+{
+	switch (type)
+	{
+	case DEAL_TO:
+	case DEAL_COMMUNITY:
+		table.deckPos--;
+		if (type == DEAL_TO)
+			table.holeCards[seat] &= ~((CardMask)1 << card);
+		else
+			table.community &= ~((CardMask)1 << card);
+		return;
+
+	case DISCARD:
+		table.discards &= ~((CardMask)1 << card);
+		table.holeCards[seat] |= (CardMask)1 << card;
+		return;
+
+	case CHECK:
+		return;
+
+	case FOLD:
+		table.flags[seat] = flagsBefore;
+		table.playersInRound++;
+		return;
+
+	case END_STREET:
+		memcpy(table.amtPaid, streetPaid, sizeof(streetPaid));
+		table.streetBet = streetBetBefore;
+		table.lastToAct = lastToActBefore;
+		return;
+
+	default: // Chips moved to the pot
+		table.chips[seat] += paid;
+		table.pot -= paid;
+		table.chipsPaid[seat] -= paid;
+		table.amtPaid[seat] = amtPaidBefore;
+		table.flags[seat] = flagsBefore;
+		table.streetBet = streetBetBefore;
+		table.lastToAct = lastToActBefore;
+		return;
+	}
+}
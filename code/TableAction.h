@@ -0,0 +1,74 @@
+/*
+TableAction.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Declares TableAction, one step of a round on a TableState: an ante, a
+card dealt or discarded, a betting decision, or the end of a street.
+apply() makes the step in place and remembers what it changed; undo()
+puts the table back exactly as it was.  Both take constant time, so a
+depth-first search can walk a game tree on one TableState, applying
+actions on the way down and undoing them on the way back up, without
+copying the table at every node.
+
+Betting follows Game::collectBets(), handleCall() and handleBet(), which
+the Simulation now plays through these actions.  A street starts with
+the seat after the dealer; TableState::firstToAct() and nextToAct() say
+whose turn it is, and return -1 when the street is over, at which point
+END_STREET clears the street's bets.
+
+Undo actions in the reverse of the order they were applied.
+*/
+
+#ifndef TABLE_ACTION_H
+#define TABLE_ACTION_H
+
+#include "TableState.h"
+
+struct TableAction
+{
+	enum Type
+	{
+		ANTE,
+		DEAL_TO,
+		DEAL_COMMUNITY,
+		DISCARD,
+		CHECK,
+		BET,
+		CALL,
+		RAISE, // A call, then a bet of amount on top of it
+		FOLD,
+		END_STREET
+	};
+
+	static TableAction ante(size_t seatNum);
+	static TableAction dealTo(size_t seatNum);
+	static TableAction dealCommunity();
+	static TableAction discard(size_t seatNum, int index);
+	static TableAction check(size_t seatNum);
+	static TableAction bet(size_t seatNum, SeatChips amount);
+	static TableAction call(size_t seatNum);
+	static TableAction raise(size_t seatNum, SeatChips amount);
+	static TableAction fold(size_t seatNum);
+	static TableAction endStreet();
+
+	static size_t choices(const TableState & table, size_t seatNum, SeatChips minBet, SeatChips maxBet, TableAction out[]);
+
+	void apply(TableState & table);
+	void undo(TableState & table) const;
+
+	unsigned char type; // A Type
+	unsigned char seat;
+	unsigned char card; // Card index; DEAL_TO and DEAL_COMMUNITY fill it in
+	SeatChips amount; // BET and RAISE
+
+	// Filled in by apply(), for undo()
+	unsigned char flagsBefore;
+	unsigned char lastToActBefore;
+	SeatChips paid; // Chips moved from the seat to the pot
+	SeatChips amtPaidBefore;
+	SeatChips streetBetBefore;
+	SeatChips streetPaid[TableState::MAX_SEATS]; // END_STREET only: every seat's amtPaid
+};
+
+#endif
@@ -0,0 +1,695 @@
+/*
+TableServer.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Defines TableServer: the epoll loop, the client protocol, and the tables' 
+coroutines.
+*/
+
+#include "stdafx.h"
+#include "TableServer.h"
+#include "GameException.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <assert.h>
+
+using namespace std;
+
+static const char GREETING[] = "Welcome to text poker!  Type a game (FiveCardDraw, SevenCardStud or "
+	"TexasHoldEm) and a table name, such as: TexasHoldEm lobby\n";
+
+TableServer::TableInput::TableInput()
+	: closed(false), wanting(NOTHING)
+{
+}
+
+void TableServer::TableInput::push(const std::string & keys)
+{
+	queue.push(keys);
+}
+
+/*
+Lets the Game run out of input once it has read what is left.
+*/
+void TableServer::TableInput::close()
+{
+	closed = true;
+}
+
+bool TableServer::TableInput::isClosed() const
+{
+	return closed;
+}
+
+TableServer::TableInput::Wanting TableServer::TableInput::getWanting() const
+{
+	return wanting;
+}
+
+const std::string & TableServer::TableInput::getExpected() const
+{
+	return expected;
+}
+
+/*
+Suspends the table's coroutine until a key has been typed.  Returns END 
+once closed.
+*/
+int TableServer::TableInput::getKey()
+{
+	assert(Coroutine::current());
+	wanting = KEY;
+	while (!closed && !queue.hasKey())
+		Coroutine::suspend();
+	wanting = NOTHING;
+	return queue.getKey();
+}
+
+/*
+Suspends the table's coroutine until a whole line has been typed.  Returns 
+false once closed.
+*/
+bool TableServer::TableInput::getLine(std::string & line)
+{
+	assert(Coroutine::current());
+	wanting = LINE;
+	while (!closed && !queue.hasLine())
+		Coroutine::suspend();
+	wanting = NOTHING;
+	return queue.getLine(line);
+}
+
+/*
+Records whose decision the next key or line is.
+*/
+void TableServer::TableInput::expect(const std::string & seat)
+{
+	expected = seat;
+}
+
+/*
+Listens on the specified socket, replacing any socket file already there.  
+SIGINT and SIGTERM are blocked; run() handles them.  If historyFile is not 
+null, every table's rounds are appended to that hand-history file.
+
+Throws runtime_error if the socket cannot be made or the history file 
+cannot be opened.
+*/
+TableServer::TableServer(const char socketPath[], Verbosity verbosity, const char historyFile[])
+	: socketPath(socketPath), verbosity(verbosity), history(0), listenFd(-1), epollFd(-1), signalFd(-1)
+{
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (this->socketPath.length() >= sizeof(address.sun_path))
+		throw runtime_error("Socket path is too long: " + this->socketPath);
+	strcpy(address.sun_path, socketPath);
+
+	sigset_t stopSignals;
+	sigemptyset(&stopSignals);
+	sigaddset(&stopSignals, SIGINT);
+	sigaddset(&stopSignals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &stopSignals, 0);
+
+	listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	epollFd = epoll_create1(EPOLL_CLOEXEC);
+	signalFd = signalfd(-1, &stopSignals, SFD_NONBLOCK | SFD_CLOEXEC);
+	if (listenFd < 0 || epollFd < 0 || signalFd < 0)
+	{
+		closeAll();
+		throw runtime_error(string("Could not start the server: ") + strerror(errno));
+	}
+
+	unlink(socketPath);
+	if (bind(listenFd, (sockaddr *)&address, sizeof(address)) != 0 || listen(listenFd, SOMAXCONN) != 0)
+	{
+		string reason = strerror(errno);
+		closeAll();
+		throw runtime_error("Could not listen on " + this->socketPath + ": " + reason);
+	}
+
+	int fds[] = {listenFd, signalFd};
+	for (size_t i = 0; i < 2; i++)
+	{
+		epoll_event event;
+		event.events = EPOLLIN;
+		event.data.fd = fds[i];
+		epoll_ctl(epollFd, EPOLL_CTL_ADD, fds[i], &event);
+	}
+
+	if (historyFile)
+	{
+		try
+		{
+			history = new HistoryWriter(historyFile);
+		}
+		catch (fstream::failure & e)
+		{
+			closeAll();
+			throw runtime_error(string("Could not record history: ") + e.what());
+		}
+	}
+}
+
+TableServer::~TableServer()
+{
+	closeAll();
+	delete history; // After every Game that wrote to it; writes whatever is still buffered
+}
+
+/*
+Closes every table, letting its Game run out of input and end, and 
+disconnects everybody.
+*/
+void TableServer::closeAll()
+{
+	for (unordered_map<string, Table *>::iterator iter = tables.begin(); iter != tables.end(); iter++)
+	{
+		iter->second->input.close();
+		wake(iter->second);
+	}
+	runTables();
+	while (!tables.empty())
+		closeTable(tables.begin()->second);
+
+	for (unordered_map<int, Connection *>::iterator iter = connections.begin(); iter != connections.end(); iter++)
+	{
+		close(iter->first);
+		delete iter->second;
+	}
+	connections.clear();
+
+	int fds[] = {listenFd, epollFd, signalFd};
+	for (size_t i = 0; i < 3; i++)
+	{
+		if (fds[i] >= 0)
+			close(fds[i]);
+	}
+	if (listenFd >= 0)
+		unlink(socketPath.c_str());
+	listenFd = epollFd = signalFd = -1;
+}
+
+/*
+Serves clients until SIGINT or SIGTERM.  After each batch of socket events, 
+resumes every table that got input.
+*/
+void TableServer::run()
+{
+	const int MAX_EVENTS = 64;
+	epoll_event ready[MAX_EVENTS];
+	bool stopping = false;
+
+	while (!stopping)
+	{
+		int count = epoll_wait(epollFd, ready, MAX_EVENTS, -1);
+		if (count < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			throw runtime_error(string("epoll_wait failed: ") + strerror(errno));
+		}
+
+		for (int i = 0; i < count; i++)
+		{
+			int fd = ready[i].data.fd;
+			if (fd == listenFd)
+				accept();
+			else if (fd == signalFd)
+				stopping = true;
+			else
+			{
+				unordered_map<int, Connection *>::iterator found = connections.find(fd);
+				if (found == connections.end())
+					continue; // Disconnected earlier in this batch
+
+				Connection * c = found->second;
+				if (ready[i].events & EPOLLOUT)
+					writeTo(c);
+				if (connections.count(fd) && (ready[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)))
+					readFrom(c);
+			}
+		}
+
+		runTables();
+	}
+}
+
+size_t TableServer::getNumTables() const
+{
+	return tables.size();
+}
+
+void TableServer::accept()
+{
+	while (true)
+	{
+		int fd = accept4(listenFd, 0, 0, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd < 0)
+			return; // EAGAIN, or a client that gave up
+
+		Connection * c = new Connection;
+		c->fd = fd;
+		c->table = 0;
+		c->closing = false;
+		connections[fd] = c;
+
+		epoll_event event;
+		event.events = EPOLLIN;
+		event.data.fd = fd;
+		epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+
+		send(c, GREETING);
+	}
+}
+
+/*
+Reads everything the client has sent.  Before the client is at a table, 
+looks for the line that names one; after, offers it all to the table.
+*/
+void TableServer::readFrom(Connection * c)
+{
+	char chunk[4096];
+	while (true)
+	{
+		ssize_t got = recv(c->fd, chunk, sizeof(chunk), 0);
+		if (got == 0 || (got < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+		{
+			disconnect(c);
+			return;
+		}
+		if (got < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		if (c->closing)
+			continue;
+
+		c->in.append(chunk, got);
+		size_t newline;
+		while (!c->table && (newline = c->in.find('\n')) != string::npos)
+		{
+			string command = c->in.substr(0, newline);
+			c->in.erase(0, newline + 1);
+			if (!joinTable(c, command))
+				return;
+		}
+		if (c->in.length() > (c->table ? MAX_PENDING : 1024))
+		{
+			disconnect(c); // Not talking our protocol, or typing far faster than anybody plays
+			return;
+		}
+	}
+
+	if (c->table)
+		feed(c->table);
+}
+
+/*
+Sends as much as the socket takes.  Returns false if that disconnected the 
+client, which deletes it.
+*/
+bool TableServer::writeTo(Connection * c)
+{
+	while (c->out.length() > 0)
+	{
+		ssize_t sent = ::send(c->fd, c->out.data(), c->out.length(), MSG_NOSIGNAL);
+		if (sent < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+			{
+				disconnect(c);
+				return false;
+			}
+			watch(c);
+			return true;
+		}
+		c->out.erase(0, sent);
+	}
+
+	if (c->closing)
+	{
+		disconnect(c);
+		return false;
+	}
+	watch(c);
+	return true;
+}
+
+/*
+Sends data, or as much as the socket takes now and the rest once it is 
+writable.  Disconnects a client that is too far behind.  Returns false if 
+the client was disconnected, which deletes it.
+*/
+bool TableServer::send(Connection * c, const std::string & data)
+{
+	if (c->out.length() + data.length() > MAX_PENDING)
+	{
+		disconnect(c);
+		return false;
+	}
+
+	bool idle = c->out.empty();
+	c->out += data;
+	if (idle)
+		return writeTo(c);
+	return true;
+}
+
+/*
+Asks epoll to say when the client is writable, but only while something 
+is waiting to be sent.
+*/
+void TableServer::watch(Connection * c)
+{
+	epoll_event event;
+	event.events = (uint32_t)EPOLLIN | (c->out.empty() ? (uint32_t)0 : (uint32_t)EPOLLOUT);
+	event.data.fd = c->fd;
+	epoll_ctl(epollFd, EPOLL_CTL_MOD, c->fd, &event);
+}
+
+/*
+Forgets a client.  A table whose last client leaves runs out of input, 
+which ends its Game.  May be called from inside a table's coroutine.
+*/
+void TableServer::disconnect(Connection * c)
+{
+	Table * table = c->table;
+	if (table)
+	{
+		if (table->joining == c)
+			table->joining = 0;
+		for (size_t i = 0; i < table->clients.size(); i++)
+		{
+			if (table->clients[i] == c)
+			{
+				table->clients.erase(table->clients.begin() + i);
+				break;
+			}
+		}
+		if (table->clients.empty())
+		{
+			table->input.close();
+			wake(table);
+		}
+	}
+
+	epoll_ctl(epollFd, EPOLL_CTL_DEL, c->fd, 0);
+	close(c->fd);
+	connections.erase(c->fd);
+	delete c;
+}
+
+/*
+Handles a client's first line, "<game> <table>".  A client that joins an 
+open table is sent the last frame, so that it sees what the table is 
+waiting on.  Returns false if the client was disconnected, which deletes it.
+*/
+bool TableServer::joinTable(Connection * c, const std::string & command)
+{
+	istringstream words(command);
+	string gameName, tableName, extra;
+	if (!(words >> gameName >> tableName) || (words >> extra))
+		return send(c, "Type a game and a table name, such as: TexasHoldEm lobby\n");
+
+	Table * table;
+	unordered_map<string, Table *>::iterator found = tables.find(tableName);
+	if (found != tables.end())
+	{
+		table = found->second;
+		if (table->gameName != gameName)
+			return send(c, "Table " + tableName + " is playing " + table->gameName + ".\n");
+		if (!send(c, "Joined table " + tableName + ".\n" + table->lastFrame.viewFor(c->seat)))
+			return false;
+	}
+	else
+	{
+		try
+		{
+			table = openTable(tableName, gameName);
+		}
+		catch (GameException & e)
+		{
+			return send(c, string(e.what()) + ".  Games are FiveCardDraw, SevenCardStud and TexasHoldEm.\n");
+		}
+		c->table = table; // Before anything else is sent, so that the table closes if c is disconnected
+		table->clients.push_back(c);
+		return send(c, "Opened table " + tableName + ".\n");
+	}
+
+	c->table = table;
+	table->clients.push_back(c);
+	return true;
+}
+
+/*
+Makes a table, with a coroutine that plays its Game.  The Game starts, up 
+to its first prompt, the next time the tables run.
+
+Throws GameException if there is no such game.
+*/
+TableServer::Table * TableServer::openTable(const std::string & name, const std::string & gameName)
+{
+	Table * table = new Table;
+	table->name = name;
+	table->gameName = gameName;
+	table->coroutine = 0;
+	table->runnable = false;
+	table->joining = 0;
+	try
+	{
+		table->game = Game::create(gameName, 0, 0, verbosity, &table->input, history);
+	}
+	catch (GameException &)
+	{
+		delete table;
+		throw;
+	}
+
+	table->game->setOutput([this, table](const Renderer::Frame & frame) { show(table, frame); });
+	table->coroutine = new Coroutine([table]()
+	{
+		table->game->play();
+		delete table->game; // Presents its last frame
+		table->game = 0;
+	});
+
+	tables[name] = table;
+	wake(table);
+	return table;
+}
+
+/*
+Sends a message to every client at a table.
+*/
+void TableServer::broadcast(Table * table, const std::string & message)
+{
+	vector<Connection *> clients(table->clients); // send() may disconnect, and so remove, each one
+	for (size_t i = 0; i < clients.size(); i++)
+		send(clients[i], message);
+}
+
+/*
+Sends a frame to every client at a table, as its seat may see it, and 
+keeps it for whoever joins next.
+*/
+void TableServer::show(Table * table, const Renderer::Frame & frame)
+{
+	table->lastFrame = frame;
+	vector<Connection *> clients(table->clients); // send() may disconnect, and so remove, each one
+	for (size_t i = 0; i < clients.size(); i++)
+		send(clients[i], frame.viewFor(clients[i]->seat));
+}
+
+/*
+If the table's Game is waiting on a key or a line, gives it one from the 
+first client that has typed one and may answer with it.  Throws away, 
+with a notice, everything a client has typed if it may not.
+*/
+void TableServer::feed(Table * table)
+{
+	TableInput::Wanting wanting = table->input.getWanting();
+	if (wanting == TableInput::NOTHING || table->runnable || !table->game)
+		return;
+
+	vector<Connection *> clients(table->clients); // send() may disconnect, and so remove, each one
+	for (size_t i = 0; i < clients.size(); i++)
+	{
+		Connection * c = clients[i];
+		size_t end = (wanting == TableInput::KEY ? c->in.find_first_not_of("\r\n") : c->in.find('\n'));
+		if (end == string::npos)
+			continue;
+
+		string keys = c->in.substr(0, end + 1); // Line endings before a key are skipped anyway
+		string line;
+		if (wanting == TableInput::LINE)
+			line = keys.substr(0, keys.find_last_not_of("\r\n") + 1);
+
+		string notice = refusal(table, c, line);
+		if (!notice.empty())
+		{
+			c->in.clear();
+			send(c, notice);
+			continue;
+		}
+
+		c->in.erase(0, keys.length());
+		if (table->input.getExpected().empty() && !line.empty() && c->seat.empty())
+		{
+			table->joining = c; // Might be a new Player's name
+			table->joiningName = line;
+		}
+		table->input.push(keys);
+		wake(table);
+		return;
+	}
+}
+
+/*
+Why client c may not give the table's Game the key or line it typed, or 
+nothing if it may.  A seat's decisions are its client's, unless that 
+client has left.  When anybody may answer, a seated Player's name is its 
+client's to type, and a new one only a client without a seat's.
+*/
+std::string TableServer::refusal(Table * table, Connection * c, const std::string & line)
+{
+	const string & expected = table->input.getExpected();
+	if (!expected.empty())
+	{
+		if (c->seat == expected)
+			return string();
+		for (size_t i = 0; i < table->clients.size(); i++)
+		{
+			if (table->clients[i]->seat == expected)
+				return "It is " + expected + "'s turn.\n";
+		}
+		return string();
+	}
+
+	if (line.empty())
+		return string();
+	Player * p = table->game->find_player(line);
+	if (p)
+		return (c->seat == p->name ? string() : "Only " + p->name + " may do that.\n");
+	if (!c->seat.empty())
+		return "You are already playing as " + c->seat + ".\n";
+	return string();
+}
+
+/*
+Seats the client that typed the name the Game was last given, if the 
+Game added that Player, and unseats clients whose Players have left.
+*/
+void TableServer::updateSeats(Table * table)
+{
+	if (table->joining)
+	{
+		Player * p = table->game->find_player(table->joiningName);
+		if (p)
+			table->joining->seat = p->name;
+		table->joining = 0;
+	}
+
+	for (size_t i = 0; i < table->clients.size(); i++)
+	{
+		Connection * c = table->clients[i];
+		if (!c->seat.empty() && !table->game->find_player(c->seat))
+			c->seat.clear();
+	}
+}
+
+/*
+Marks a table to be resumed before the loop next waits.
+*/
+void TableServer::wake(Table * table)
+{
+	if (!table->runnable)
+	{
+		table->runnable = true;
+		runnable.push_back(table);
+	}
+}
+
+/*
+Resumes each table that was woken, until it suspends for more input or its 
+Game ends, then feeds it what its clients have typed since.  Closes the 
+tables whose Games ended.
+*/
+void TableServer::runTables()
+{
+	while (!runnable.empty())
+	{
+		vector<Table *> ready;
+		ready.swap(runnable);
+		for (size_t i = 0; i < ready.size(); i++)
+		{
+			Table * table = ready[i];
+			table->runnable = false;
+
+			bool playing;
+			try
+			{
+				playing = table->coroutine->resume();
+			}
+			catch (std::exception & e)
+			{
+				broadcast(table, string("Oh dear - ") + e.what() + '\n');
+				playing = false;
+			}
+
+			if (!playing)
+				closeTable(table);
+			else
+			{
+				updateSeats(table);
+				feed(table);
+			}
+		}
+	}
+}
+
+/*
+Tells a table's clients that it is closed, and forgets it.  Its coroutine 
+must have finished.
+*/
+void TableServer::closeTable(Table * table)
+{
+	delete table->game; // Still there if play() threw something other than a GameException
+	table->game = 0;
+
+	vector<Connection *> clients;
+	clients.swap(table->clients);
+	for (size_t i = 0; i < clients.size(); i++)
+	{
+		clients[i]->table = 0;
+		clients[i]->closing = true;
+		send(clients[i], "Table " + table->name + " closed.\n");
+	}
+
+	for (size_t i = 0; i < runnable.size(); i++) // Woken again as it ended
+	{
+		if (runnable[i] == table)
+		{
+			runnable.erase(runnable.begin() + i);
+			break;
+		}
+	}
+
+	tables.erase(table->name);
+	delete table->coroutine;
+	delete table;
+}
@@ -0,0 +1,140 @@
+/*
+TableServer.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Declares TableServer, which hosts any number of Game tables in one process 
+for clients on the same machine.  Clients connect to a Unix-domain socket.  
+The protocol is the console itself: a client's first line names a game and 
+a table, such as "TexasHoldEm lobby", which opens that table or joins it if 
+it is open, and which is answered with the table's current prompt.  After 
+that, everything the client sends is typed at that table.
+
+Each client plays as at most one Player: the name it adds to the game is 
+its seat.  Only a seat's client may make that Player's decisions or take 
+that Player out of the game, and a client that has a seat cannot add 
+another; anybody may answer for a seat whose client has left.  Everything 
+the table prints is sent to all of its clients, each of which sees its own 
+Player's cards and nobody else's face-down ones.
+
+Everything runs on one thread: an epoll loop that does all socket I/O, 
+without blocking, and every table's Game.  Each Game plays in a Coroutine 
+of its own; where it would wait for a decision at the console, it 
+suspends instead, and the loop resumes it once its clients have typed 
+something.  A table waiting on a slow or silent client costs only its 
+coroutine's stack and holds up nothing else.  A client that falls more 
+than MAX_PENDING bytes behind is disconnected.  A table closes when its 
+Game ends or when its last client leaves.  With a history file, every 
+table's rounds go to one HistoryWriter, each table under its own table id.
+
+Linux only: uses epoll and signalfd.  Runs until SIGINT or SIGTERM.
+*/
+
+#ifndef TABLE_SERVER_H
+#define TABLE_SERVER_H
+
+#include "Game.h"
+#include "InputSource.h"
+#include "Coroutine.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+class TableServer
+{
+public:
+	TableServer(const char socketPath[], Verbosity verbosity = NORMAL, const char historyFile[] = 0);
+	~TableServer();
+
+	void run();
+	size_t getNumTables() const;
+
+	static const size_t MAX_PENDING = 1024 * 1024; // Unsent bytes per client
+
+private:
+	// Undefined, so that no copies can be made.
+	TableServer(const TableServer & other);
+	TableServer & operator= (const TableServer & other);
+
+	// What clients have typed at a table.  Its Game suspends until there is enough.
+	class TableInput : public InputSource
+	{
+	public:
+		enum Wanting { NOTHING, KEY, LINE };
+
+		TableInput();
+
+		void push(const std::string & keys);
+		void close();
+		bool isClosed() const;
+		Wanting getWanting() const;
+		const std::string & getExpected() const;
+
+		int getKey();
+		bool getLine(std::string & line);
+		void expect(const std::string & seat);
+
+	private:
+		QueueInput queue;
+		bool closed; // No more will be pushed
+		Wanting wanting; // What the Game is suspended for
+		std::string expected; // Whose decision it is, or empty if anybody's
+	};
+
+	struct Connection;
+
+	struct Table
+	{
+		std::string name;
+		std::string gameName;
+		Game * game;
+		TableInput input;
+		Coroutine * coroutine; // Plays the Game
+		std::vector<Connection *> clients;
+		bool runnable; // Has input, or has run out, since it suspended
+		Renderer::Frame lastFrame; // Ends with the prompt the Game is waiting on
+		Connection * joining; // Typed the name the Game was last given, if it was new
+		std::string joiningName;
+	};
+
+	struct Connection
+	{
+		int fd;
+		std::string in; // Typed, but not yet given to the table
+		std::string out; // Not yet sent
+		Table * table;
+		std::string seat; // Name of the Player it plays as, or empty
+		bool closing; // Disconnect once out is sent
+	};
+
+	void closeAll();
+	void accept();
+	void readFrom(Connection * c);
+	bool writeTo(Connection * c);
+	bool send(Connection * c, const std::string & data);
+	void disconnect(Connection * c);
+	bool joinTable(Connection * c, const std::string & command);
+	Table * openTable(const std::string & name, const std::string & gameName);
+	void broadcast(Table * table, const std::string & message);
+	void show(Table * table, const Renderer::Frame & frame);
+	void feed(Table * table);
+	std::string refusal(Table * table, Connection * c, const std::string & line);
+	void updateSeats(Table * table);
+	void wake(Table * table);
+	void runTables();
+	void closeTable(Table * table);
+	void watch(Connection * c);
+
+	std::string socketPath;
+	Verbosity verbosity;
+	HistoryWriter * history; // Shared by every table's Game, or 0
+	int listenFd;
+	int epollFd;
+	int signalFd;
+	std::unordered_map<int, Connection *> connections;
+	std::unordered_map<std::string, Table *> tables;
+	std::vector<Table *> runnable; // To be resumed before the loop waits again
+};
+
+#endif
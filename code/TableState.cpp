@@ -0,0 +1,156 @@
+/*
+TableState.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Defines the seat and card operations of TableState.
+*/
+
+#include "stdafx.h"
+#include "TableState.h"
+#include "GameException.h"
+#include "Profiler.h"
+#include "ndebug.h"
+
+#include <string.h>
+#include <algorithm>
+#include <assert.h>
+
+/*
+Empties the table and seats numSeats players with startChips each.  
+The deck is put back in standard order, and rng is started at seed 0, 
+stream 0, position 0.
+*/
+void TableState::reset(size_t numSeats, SeatChips startChips)
+{
+	assert(numSeats <= MAX_SEATS);
+
+	memset(this, 0, sizeof(TableState));
+	this->numSeats = (unsigned char)numSeats;
+	for (size_t i = 0; i < numSeats; i++)
+		chips[i] = startChips;
+
+	standardDeck();
+	rng.start(0, 0, 0);
+}
+
+void TableState::fold(size_t seatNum)
+{
+	assert(inRound(seatNum));
+	flags[seatNum] &= ~IN_ROUND;
+	playersInRound--;
+}
+
+/*
+Puts every card index back in the deck in order, and makes them all undealt.
+*/
+void TableState::standardDeck()
+{
+	for (int i = 0; i < Card::NUM_CARDS; i++)
+		deck[i] = (unsigned char)i;
+	deckPos = 0;
+}
+
+/*
+Puts the specified card indices on top of the deck, in order, followed by 
+every other card in standard order, and makes them all undealt.  indices 
+must not repeat a card.
+*/
+void TableState::loadDeck(const unsigned char indices[], size_t numCards)
+{
+	assert(numCards <= (size_t)Card::NUM_CARDS);
+
+	CardMask loaded = 0;
+	for (size_t i = 0; i < numCards; i++)
+	{
+		deck[i] = indices[i];
+		loaded |= (CardMask)1 << indices[i];
+	}
+
+	size_t pos = numCards;
+	for (int i = 0; i < Card::NUM_CARDS; i++)
+	{
+		if (!(loaded & ((CardMask)1 << i)))
+			deck[pos++] = (unsigned char)i;
+	}
+	deckPos = 0;
+}
+
+/*
+Shuffles the undealt part of the deck with the next numbers from rng.
+*/
+void TableState::shuffle()
+{
+	PROFILE_COUNT("TableState::shuffle");
+	rng.shuffle(deck + deckPos, deck + Card::NUM_CARDS);
+}
+
+/*
+Puts the whole deck in the order that round number position of the 
+specified stream is dealt from, by starting rng there and shuffling a 
+standard deck.  The order depends on nothing else, so a round can be dealt 
+again on its own.
+*/
+void TableState::dealFor(uint64_t seed, uint32_t stream, uint64_t position)
+{
+	standardDeck();
+	rng.start(seed, stream, position);
+	shuffle();
+}
+
+/*
+Deals the next card in the deck to a seat.  If the deck has run out, the 
+discards are shuffled and become the rest of the deck.
+
+Throws GameException if there are no cards left in the deck or the discards.
+*/
+void TableState::dealTo(size_t seatNum)
+{
+	if (deckPos == Card::NUM_CARDS)
+	{
+		if (discards == 0)
+			throw GameException("Ran out of cards in main and discard decks");
+
+		// Dealt slots at the end of the deck are reused for the discards
+		int index = 0;
+		for (CardMask rest = discards; rest != 0; index++, rest >>= 1)
+		{
+			if (rest & 1)
+				deck[--deckPos] = (unsigned char)index;
+		}
+		discards = 0;
+		shuffle();
+	}
+
+	holeCards[seatNum] |= (CardMask)1 << deck[deckPos++];
+}
+
+/*
+Deals the next card in the deck to the community cards.  
+
+Throws GameException if the deck has run out.
+*/
+void TableState::dealCommunity()
+{
+	if (deckPos == Card::NUM_CARDS)
+		throw GameException("Deck ran out of cards.");
+
+	community |= (CardMask)1 << deck[deckPos++];
+}
+
+/*
+Moves the card with the specified index from a seat's hand to the discards.
+*/
+void TableState::discard(size_t seatNum, int index)
+{
+	CardMask card = (CardMask)1 << index;
+	assert(holeCards[seatNum] & card);
+
+	holeCards[seatNum] &= ~card;
+	discards |= card;
+}
+
+int TableState::cardsLeft() const
+{
+	return Card::NUM_CARDS - deckPos;
+}
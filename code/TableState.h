@@ -0,0 +1,159 @@
+/*
+TableState.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Declares TableState, the complete state of one headless table stored as
+contiguous per-seat arrays, and SeatView, a read-only view of one seat.
+The fields touched on every betting action come first, so a betting round
+stays within the first four cache lines of the table.  TableState holds no
+pointers and no heap memory, so copying one copies the whole table.
+*/
+
+#ifndef TABLE_STATE_H
+#define TABLE_STATE_H
+
+#include "Card.h"
+#include "Hand.h"
+#include "CounterRng.h"
+
+typedef unsigned long ChipAmt;
+typedef unsigned int SeatChips; // Per-seat amounts; narrower than ChipAmt to keep seats compact
+
+struct TableState
+{
+	static const size_t MAX_SEATS = 23; // Texas Hold 'Em's maximum, the largest of any variant
+
+	// Bits in flags[]
+	static const unsigned char IN_ROUND = 0x1;
+	static const unsigned char ALL_IN = 0x2;
+
+	void reset(size_t numSeats, SeatChips startChips);
+
+	// Seats
+	size_t nextSeat(size_t seatNum) const;
+	bool inRound(size_t seatNum) const;
+	bool canAct(size_t seatNum) const;
+	void fold(size_t seatNum);
+	int firstToAct() const;
+	int nextToAct(size_t seatNum) const;
+
+	// Cards
+	void standardDeck();
+	void loadDeck(const unsigned char indices[], size_t numCards);
+	void shuffle();
+	void dealFor(uint64_t seed, uint32_t stream, uint64_t position);
+	void dealTo(size_t seatNum);
+	void dealCommunity();
+	void discard(size_t seatNum, int index);
+	int cardsLeft() const;
+
+	// Betting state: read and written on every action
+	SeatChips chips[MAX_SEATS];
+	SeatChips amtPaid[MAX_SEATS];
+	unsigned char flags[MAX_SEATS];
+	unsigned char numSeats;
+	unsigned char dealerPos;
+	unsigned char playersInRound;
+	unsigned char lastToAct; // The street ends after this seat, unless somebody bets
+	SeatChips streetBet; // What each seat must have paid this street; 0 until somebody bets
+	ChipAmt pot;
+
+	// Cards, touched once per deal
+	CardMask holeCards[MAX_SEATS];
+	CardMask community;
+	CardMask discards;
+	unsigned char deck[Card::NUM_CARDS];
+	unsigned char deckPos;
+	CounterRng rng; // Where shuffle() gets its numbers
+
+	// Results, touched once per round
+	unsigned wins[MAX_SEATS];
+	unsigned ties[MAX_SEATS]; // Wins that split the pot
+	unsigned losses[MAX_SEATS];
+	unsigned rebuys[MAX_SEATS];
+	ChipAmt chipsPaid[MAX_SEATS]; // Into pots, including antes
+	ChipAmt chipsWon[MAX_SEATS]; // Out of pots
+	unsigned showdownRanks[STR_RANKS_COUNT]; // Every hand shown down, by pokerRank
+};
+
+inline size_t TableState::nextSeat(size_t seatNum) const
+{
+	seatNum++;
+	if (seatNum >= numSeats)
+		seatNum = 0;
+	return seatNum;
+}
+
+inline bool TableState::inRound(size_t seatNum) const
+{
+	return (flags[seatNum] & IN_ROUND) != 0;
+}
+
+/*
+Returns true if the seat has not folded and still has chips to bet with.
+*/
+inline bool TableState::canAct(size_t seatNum) const
+{
+	return flags[seatNum] == IN_ROUND;
+}
+
+/*
+The first seat that bets this street, starting after the dealer, or -1 if 
+nobody can.  Call before anybody has acted.
+*/
+inline int TableState::firstToAct() const
+{
+	size_t seatNum = dealerPos;
+	do
+	{
+		seatNum = nextSeat(seatNum);
+		if (canAct(seatNum))
+			return (int)seatNum;
+	} while (seatNum != lastToAct);
+	return -1;
+}
+
+/*
+The seat that bets after seatNum has, or -1 if the street is over.
+Skips seats that have folded or are all in.
+*/
+inline int TableState::nextToAct(size_t seatNum) const
+{
+	while (seatNum != lastToAct)
+	{
+		seatNum = nextSeat(seatNum);
+		if (canAct(seatNum))
+			return (int)seatNum;
+	}
+	return -1;
+}
+
+/*
+A read-only view of one seat in a TableState.  Offers the same information
+as a Player, for use by Strategies and reports.
+*/
+class SeatView
+{
+public:
+	SeatView(const TableState & table, size_t seatNum) : table(table), seatNum(seatNum) {}
+
+	ChipAmt chips() const { return table.chips[seatNum]; }
+	ChipAmt amtPaid() const { return table.amtPaid[seatNum]; }
+	bool inRound() const { return (table.flags[seatNum] & TableState::IN_ROUND) != 0; }
+	bool allIn() const { return (table.flags[seatNum] & TableState::ALL_IN) != 0; }
+	CardMask cards() const { return table.holeCards[seatNum]; }
+	Hand hand() const { return Hand(table.holeCards[seatNum]); }
+	unsigned wins() const { return table.wins[seatNum]; }
+	unsigned ties() const { return table.ties[seatNum]; }
+	unsigned losses() const { return table.losses[seatNum]; }
+	unsigned rebuys() const { return table.rebuys[seatNum]; }
+	ChipAmt chipsPaid() const { return table.chipsPaid[seatNum]; }
+	ChipAmt chipsWon() const { return table.chipsWon[seatNum]; }
+
+private:
+	const TableState & table;
+	size_t seatNum;
+};
+
+#endif
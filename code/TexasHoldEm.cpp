@@ -10,10 +10,10 @@ Defines all necessary functions for making a game of Texas Hold Em.
 #include "TexasHoldEm.h"
 #include "SevenCardStud.h"
 #include "GameException.h"
+#include "Profiler.h"
 #include "ndebug.h"
 
 #include <iostream>
-#include <functional>
 #include <algorithm>
 #include <assert.h>
 
@@ -30,22 +30,23 @@ TexasHoldEm::TexasHoldEm() : Game(DECK_SIZE, MAX_PLAYERS), community(Hand())
 
 /*
 Runs the game until all players leave or there is an error.  
-Calls stop_game() automatically.
+Calls finish() automatically.
 */
 void TexasHoldEm::play()
 {
 	addPlayersPrompt();
 
 	try{ while (true) {
-		cout << endl;
+		screen.present(); // Each round is a frame
+		screen.at(NORMAL) << '\n';
 		if (players.size() == 0)
 		{
-			cout << "There are no more players in the game.  Stopping..." << endl;
-			stop_game();
+			screen.at(QUIET) << "There are no more players in the game.  Stopping...\n";
+			finish();
 			break;
 		}
 
-		int winner = before_round();
+		int winner = TexasHoldEm::before_round();
 		if (winner)
 		{
 			earlyWin();
@@ -53,8 +54,8 @@ void TexasHoldEm::play()
 			continue;
 		}
 
-		cout << endl;
-		winner = round();
+		screen.at(NORMAL) << '\n';
+		winner = TexasHoldEm::round();
 		if (winner)
 		{
 			earlyWin();
@@ -62,14 +63,14 @@ void TexasHoldEm::play()
 			continue;
 		}
 
-		cout << endl;
-		after_round();
+		screen.at(NORMAL) << '\n';
+		TexasHoldEm::after_round();
 	}}
 	catch (GameException e)
 	{
-		cout << "Oh dear - " << e.what() << endl;
-		cout << "The game ran into a problem.  Stopping..." << endl;
-		stop_game();
+		screen.at(QUIET) << "Oh dear - " << e.what() << '\n';
+		screen.at(QUIET) << "The game ran into a problem.  Stopping...\n";
+		finish();
 	}
 }
 
@@ -124,7 +125,8 @@ int TexasHoldEm::after_turn(Player & p)
 }
 
 /*
-Shuffles the deck.  Collects ante.  Deals initial hands.  Prints them.  
+Shuffles the deck, or takes the next deal from the scenario.  Collects 
+ante.  Deals initial hands.  Prints them.  
 Does a round of betting.  
 
 Returns 0 on success.  
@@ -134,20 +136,21 @@ Throws GameException if the deck runs out of cards.
 */
 int TexasHoldEm::before_round()
 {
+	PROFILE_PHASE("before_round");
 	if (players.size() == 0)
 		return 0;
 
 	if (players.size() > MAX_PLAYERS)
 		throw GameException("Not enough cards to support this number of players.");
 
-	deck.shuffle();
+	prepareDeck();
 
 	allJoinRound();
 	collectAnte();
-	goAround(std::mem_fun(&Game::before_turn)); // Throws GameException
+	goAround([this](Player & p) { return TexasHoldEm::before_turn(p); }); // Throws GameException
 
 	printTable();
-	cout << endl;
+	screen.at(NORMAL) << '\n';
 
 	collectBets();
 	if (playersInRound == 1)
@@ -165,26 +168,27 @@ Throws GameException if the deck runs out of cards.
 */
 int TexasHoldEm::round()
 {
+	PROFILE_PHASE("round");
 	if (players.size() == 0)
 		return 0;
 
-	turn(*players[0]); // Flop.  Throws GameException
+	TexasHoldEm::turn(*players[0]); // Flop.  Throws GameException
 	printTable();
-	cout << endl;
+	screen.at(NORMAL) << '\n';
 	collectBets();
 	if (playersInRound == 1)
 		return EARLY_WINNER;
 
-	after_turn(*players[0]); // Turn.  Throws GameException
+	TexasHoldEm::after_turn(*players[0]); // Turn.  Throws GameException
 	printTable();
-	cout << endl;
+	screen.at(NORMAL) << '\n';
 	collectBets();
 	if (playersInRound == 1)
 		return EARLY_WINNER;
 
-	after_turn(*players[0]); // River.  Throws GameException
+	TexasHoldEm::after_turn(*players[0]); // River.  Throws GameException
 	printTable();
-	cout << endl;
+	screen.at(NORMAL) << '\n';
 	collectBets();
 	if (playersInRound == 1)
 		return EARLY_WINNER;
@@ -200,10 +204,14 @@ Returns 0 on success.
 */
 int TexasHoldEm::after_round()
 {
+	PROFILE_PHASE("after_round");
 	if (players.size() == 0)
 		return 0;
 
-	vector<pair<Player *, Hand *>> bestHands;
+	vector<Player *> winners;
+	{
+	RoundArena::Scope scope(roundArena); // Showdown hands come from the arena
+	vector<pair<Player *, Hand>, ArenaAllocator<pair<Player *, Hand>>> bestHands;
 	for (unsigned int i = 0; i < players.size(); i++)
 	{
 		if (players[i]->inRound)
@@ -213,7 +221,7 @@ int TexasHoldEm::after_round()
 			temp.add_card(c);
 			c = players[i]->hand[1];
 			temp.add_card(c);
-			bestHands.push_back(pair<Player *, Hand *>(players[i], temp.bestStudHand()));
+			bestHands.push_back(pair<Player *, Hand>(players[i], temp.bestStudHand()));
 		}
 		else
 			players[i]->losses++;
@@ -221,27 +229,24 @@ int TexasHoldEm::after_round()
 
 	sort(bestHands.begin(), bestHands.end(), SevenCardStud::compStudPlayers);
 
-	vector<Player *> winners;
 	winners.push_back(bestHands.front().first);
-	winners.back()->hand.copyRank(*bestHands.front().second);
+	winners.back()->hand.copyRank(bestHands.front().second);
 	for (unsigned int i = 1; i < bestHands.size(); i++)
 	{
-		if (bestHands.front().second->sameRankAs(*bestHands[i].second))
+		if (bestHands.front().second.sameRankAs(bestHands[i].second))
 		{
 			winners.push_back(bestHands[i].first);
-			winners.back()->hand.copyRank(*bestHands.front().second);
+			winners.back()->hand.copyRank(bestHands.front().second);
 		}
 		else
 			break;
 	}
 
-	awardWinners(winners);
-
 	for (unsigned int i = winners.size(); i < bestHands.size(); i++)
 		bestHands[i].first->losses++;
+	}
 
-	for (unsigned int i = 0; i < bestHands.size(); i++)
-		delete bestHands[i].second;
+	awardWinners(winners);
 
 	printStatsAndHands();
 	cleanup();
@@ -251,18 +256,26 @@ int TexasHoldEm::after_round()
 
 void TexasHoldEm::printTable()
 {
-	cout << "Status of the table:" << endl;
+	if (!screen.shows(NORMAL))
+		return;
+
+	ostream & out = screen.at(NORMAL);
+	out << "Status of the table:\n";
 	for (unsigned int i = 0; i < players.size(); i++)
 	{
 		if (players[i]->inRound)
-			cout << players[i]->name << ": " << players[i]->hand.toString_hideFaceDown() << endl;
+		{
+			out << players[i]->name << ": ";
+			printHand(*players[i], false);
+			out << '\n';
+		}
 	}
-	cout << "Community cards: " << community << endl;
+	out << "Community cards: " << community << '\n';
 }
 
 /*
-Moves all cards back to the main deck.  Prompts to add and remove Players.  
-Increments the dealer position.
+Moves all cards back to the main deck and releases the round's temporaries.  
+Prompts to add and remove Players.  Increments the dealer position.
 */
 void TexasHoldEm::cleanup()
 {
@@ -274,6 +287,7 @@ void TexasHoldEm::cleanup()
 	assert(community.size() == 0);
 
 	allHandsToDeck();
+	roundArena.reset();
 	removePlayersPrompt();
 	addPlayersPrompt();
 
@@ -281,3 +295,21 @@ void TexasHoldEm::cleanup()
 	if (dealerPos >= players.size())
 		dealerPos = 0;
 }
+
+/*
+The community cards, for the hand history.
+*/
+CardMask TexasHoldEm::communityCards() const
+{
+	return community.toMask();
+}
+
+void TexasHoldEm::snapshotTableCards(GameSnapshot & out) const
+{
+	out.community = community.toMask();
+}
+
+void TexasHoldEm::restoreTableCards(const GameSnapshot & in)
+{
+	community = Hand(in.community);
+}
@@ -34,6 +34,9 @@ protected:
 
 	void printTable();
 	void cleanup();
+	virtual CardMask communityCards() const;
+	virtual void snapshotTableCards(GameSnapshot & out) const;
+	virtual void restoreTableCards(const GameSnapshot & in);
 };
 
 #endif
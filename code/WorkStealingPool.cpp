@@ -0,0 +1,222 @@
+/*
+WorkStealingPool.cpp
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Defines WorkStealingPool.
+*/
+
+#include "stdafx.h"
+#include "WorkStealingPool.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace std;
+
+static thread_local const WorkStealingPool * currentPool = 0;
+static thread_local int currentId = -1;
+
+/*
+Starts numThreads workers, or one per core if numThreads is 0.  If 
+pinThreads, worker n runs only on CPU n (modulo the number of CPUs), where 
+the system allows it.
+*/
+WorkStealingPool::WorkStealingPool(unsigned numThreads, bool pinThreads)
+	: queued(0), unfinished(0), nextWorker(0), stopping(false)
+{
+	if (numThreads == 0)
+		numThreads = thread::hardware_concurrency();
+	if (numThreads == 0)
+		numThreads = 1;
+
+	for (unsigned i = 0; i < numThreads; i++)
+		workers.push_back(unique_ptr<Worker>(new Worker()));
+	for (unsigned i = 0; i < numThreads; i++)
+	{
+		threads.push_back(thread(&WorkStealingPool::run, this, i));
+		if (pinThreads)
+			pin(i);
+	}
+}
+
+/*
+Finishes every task, then stops the workers.
+*/
+WorkStealingPool::~WorkStealingPool()
+{
+	{
+		lock_guard<mutex> guard(sleepLock);
+		stopping = true;
+	}
+	workReady.notify_all();
+	for (size_t i = 0; i < threads.size(); i++)
+		threads[i].join();
+}
+
+/*
+Queues a task.  From a worker of this pool, it goes on that worker's own 
+deque; from anywhere else, on each worker's in turn.
+*/
+void WorkStealingPool::submit(const Task & task)
+{
+	unsigned id;
+	if (currentPool == this)
+		id = (unsigned)currentId;
+	else
+		id = nextWorker.fetch_add(1, memory_order_relaxed) % workers.size();
+
+	unfinished.fetch_add(1);
+	{
+		lock_guard<mutex> guard(workers[id]->lock);
+		workers[id]->tasks.push_back(task);
+	}
+	queued.fetch_add(1);
+
+	{
+		lock_guard<mutex> guard(sleepLock); // So that a worker going to sleep sees the task
+	}
+	workReady.notify_one();
+}
+
+/*
+Waits until every task submitted so far, and every task those submit, has 
+finished.  Must not be called by a worker.
+
+Rethrows the first exception that a task threw, if any.
+*/
+void WorkStealingPool::wait()
+{
+	unique_lock<mutex> guard(sleepLock);
+	allDone.wait(guard, [this] { return unfinished.load() == 0; });
+
+	if (error)
+	{
+		exception_ptr thrown = error;
+		error = exception_ptr();
+		rethrow_exception(thrown);
+	}
+}
+
+unsigned WorkStealingPool::getNumThreads() const
+{
+	return (unsigned)workers.size();
+}
+
+/*
+How many tasks were run by a worker other than the one they were queued 
+on.  Only meaningful once wait() has returned.
+*/
+unsigned long WorkStealingPool::getTasksStolen() const
+{
+	unsigned long total = 0;
+	for (size_t i = 0; i < workers.size(); i++)
+		total += workers[i]->stolen;
+	return total;
+}
+
+/*
+The number of the worker running the calling code, from 0, or -1 if it is 
+not running on a worker.
+*/
+int WorkStealingPool::currentWorker()
+{
+	return currentId;
+}
+
+void WorkStealingPool::run(unsigned id)
+{
+	currentPool = this;
+	currentId = (int)id;
+
+	while (true)
+	{
+		Task task;
+		if (takeTask(id, task))
+		{
+			try
+			{
+				task();
+			}
+			catch (...)
+			{
+				lock_guard<mutex> guard(sleepLock);
+				if (!error)
+					error = current_exception();
+			}
+
+			if (unfinished.fetch_sub(1) == 1)
+			{
+				lock_guard<mutex> guard(sleepLock);
+				allDone.notify_all();
+			}
+			continue;
+		}
+
+		unique_lock<mutex> guard(sleepLock);
+		workReady.wait(guard, [this] { return stopping || queued.load() > 0; });
+		if (stopping && queued.load() == 0)
+			return;
+	}
+}
+
+/*
+Takes the newest task from the worker's own deque, or else the oldest 
+from the first other worker that has one.  Returns false if every deque 
+is empty.
+*/
+bool WorkStealingPool::takeTask(unsigned id, Task & task)
+{
+	Worker & self = *workers[id];
+	{
+		lock_guard<mutex> guard(self.lock);
+		if (!self.tasks.empty())
+		{
+			task.swap(self.tasks.back());
+			self.tasks.pop_back();
+			queued.fetch_sub(1);
+			return true;
+		}
+	}
+
+	for (size_t i = 1; i < workers.size(); i++)
+	{
+		Worker & victim = *workers[(id + i) % workers.size()];
+		lock_guard<mutex> guard(victim.lock);
+		if (!victim.tasks.empty())
+		{
+			task.swap(victim.tasks.front());
+			victim.tasks.pop_front();
+			queued.fetch_sub(1);
+			self.stolen++;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+Keeps a worker on one CPU.  Does nothing where that is not supported.
+*/
+void WorkStealingPool::pin(unsigned id)
+{
+	unsigned numCpus = thread::hardware_concurrency();
+	if (numCpus == 0)
+		return;
+	unsigned cpu = id % numCpus;
+
+#ifdef _WIN32
+	if (cpu < 64)
+		SetThreadAffinityMask((HANDLE)threads[id].native_handle(), (DWORD_PTR)1 << cpu);
+#elif defined(__linux__)
+	cpu_set_t cpus;
+	CPU_ZERO(&cpus);
+	CPU_SET(cpu, &cpus);
+	pthread_setaffinity_np(threads[id].native_handle(), sizeof(cpus), &cpus);
+#endif
+}
@@ -0,0 +1,77 @@
+/*
+WorkStealingPool.h
+Silas Hsu // hsu.silas@wustl.edu
+Last updated October 18, 2026
+
+Declares WorkStealingPool, a fixed set of worker threads that run 
+submitted tasks.  Every worker has a deque of its own.  A task submitted 
+by a worker goes on that worker's deque, which it works through newest 
+first; a worker whose deque is empty steals the oldest task from another.  
+So a worker stuck on a long task, such as a table with many seats, leaves 
+its queued tasks to whichever workers run dry, and no core sits idle 
+while there is work anywhere.
+
+Workers can be pinned one to a CPU, so that each keeps its own cache.
+*/
+
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <functional>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+
+class WorkStealingPool
+{
+public:
+	typedef std::function<void ()> Task;
+
+	WorkStealingPool(unsigned numThreads = 0, bool pinThreads = false);
+	~WorkStealingPool();
+
+	void submit(const Task & task);
+	void wait();
+
+	unsigned getNumThreads() const;
+	unsigned long getTasksStolen() const;
+	static int currentWorker();
+
+private:
+	// Undefined, so that no copies can be made.
+	WorkStealingPool(const WorkStealingPool & other);
+	WorkStealingPool & operator= (const WorkStealingPool & other);
+
+	struct Worker
+	{
+		Worker() : stolen(0) {}
+
+		std::mutex lock;
+		std::deque<Task> tasks; // The owner takes from the back; thieves from the front
+		unsigned long stolen; // Tasks this worker took from others
+		char padding[64]; // Keeps neighbours' locks off this one's cache line
+	};
+
+	void run(unsigned id);
+	bool takeTask(unsigned id, Task & task);
+	void pin(unsigned id);
+
+	std::vector<std::unique_ptr<Worker> > workers;
+	std::vector<std::thread> threads;
+	std::atomic<size_t> queued; // Tasks waiting in some deque
+	std::atomic<size_t> unfinished; // Tasks submitted and not yet finished
+	std::atomic<unsigned> nextWorker; // Where the next task from outside the pool goes
+	std::exception_ptr error; // The first exception a task threw
+	bool stopping;
+
+	std::mutex sleepLock; // For idle workers and wait(); also guards error and stopping
+	std::condition_variable workReady;
+	std::condition_variable allDone;
+};
+
+#endif